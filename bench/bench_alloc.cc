@@ -0,0 +1,137 @@
+#include "c12_sim.h"
+#include "gimbal_ctrl.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <pthread.h>
+#include <thread>
+
+/**
+ * 回包路径分配计数：替换全局 operator new，只统计 GimbalCtrl 接收线程上的
+ * 分配。预热后以固定帧率提交异步拍照指令并开启 100 Hz 姿态推送，
+ * 稳态下每帧回包的分配次数应为 0。
+ *
+ * 用法：bench_alloc [commands] [rate]
+ */
+
+namespace {
+std::atomic<bool> g_counting{false};
+std::atomic<bool> g_rx_known{false};
+pthread_t g_rx_thread;
+std::atomic<uint64_t> g_rx_allocs{0};
+
+inline void countAlloc() {
+  if (g_counting.load(std::memory_order_relaxed) &&
+      g_rx_known.load(std::memory_order_acquire) &&
+      pthread_equal(pthread_self(), g_rx_thread))
+    g_rx_allocs.fetch_add(1, std::memory_order_relaxed);
+}
+
+// 以固定帧率提交 count 条指令并等待全部完成
+void runPhase(GimbalCtrl &gimbal, uint64_t count, int rate,
+              std::atomic<uint64_t> &done) {
+  uint64_t target = done + count;
+  auto start = std::chrono::steady_clock::now();
+  for (uint64_t sent = 0; sent < count;) {
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    uint64_t due = static_cast<uint64_t>(
+        std::chrono::duration<double>(elapsed).count() * rate);
+    for (; sent < due && sent < count; sent++)
+      gimbal.capturePhotoAsync();
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+  }
+  auto wait_until = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+  while (done < target && std::chrono::steady_clock::now() < wait_until)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+} // namespace
+
+void *operator new(size_t size) {
+  countAlloc();
+  if (void *p = malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  countAlloc();
+  return malloc(size ? size : 1);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &tag) noexcept {
+  return operator new(size, tag);
+}
+
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+int main(int argc, char *argv[]) {
+  uint64_t commands = argc > 1 ? strtoull(argv[1], nullptr, 10) : 20000;
+  int rate = argc > 2 ? atoi(argv[2]) : 5000;
+  loguru::g_stderr_verbosity = loguru::Verbosity_WARNING;
+
+  const uint16_t port = 15500;
+  pid_t sim = c12sim::forkLoopback(port);
+
+  std::atomic<uint64_t> confirmed{0};
+  std::atomic<uint64_t> failed{0};
+  std::atomic<uint64_t> done{0};
+  std::atomic<uint64_t> attitudes{0};
+  GimbalCtrl::LinkStats stats;
+  uint64_t allocs = 0;
+  uint64_t attitude_count = 0;
+
+  {
+    GimbalCtrl gimbal("127.0.0.1", port);
+    gimbal.setCommandCallback([&](const GimbalCtrl::CommandRecord &record) {
+      if (!g_rx_known.load(std::memory_order_relaxed)) {
+        g_rx_thread = pthread_self();
+        g_rx_known.store(true, std::memory_order_release);
+      }
+      if (record.state == GimbalCtrl::CommandState::CONFIRMED)
+        confirmed++;
+      else
+        failed++;
+      done++;
+    });
+    gimbal.setAttitudeCallback(
+        [&](const GimbalCtrl::Attitude &) { attitudes++; });
+    gimbal.enableAttitudeOutput(100);
+
+    // 预热：缓冲池、已完成记录与各容器达到稳态容量
+    runPhase(gimbal, 2000, rate, done);
+    uint64_t warm_confirmed = confirmed;
+    uint64_t warm_attitudes = attitudes;
+
+    gimbal.resetLinkStats();
+    g_counting = true;
+    runPhase(gimbal, commands, rate, done);
+    g_counting = false;
+
+    allocs = g_rx_allocs;
+    attitude_count = attitudes - warm_attitudes;
+    confirmed -= warm_confirmed;
+    stats = gimbal.getLinkStats();
+  }
+
+  c12sim::stopLoopback(sim);
+
+  uint64_t replies = confirmed + attitude_count;
+  printf("commands=%lu confirmed=%lu failed=%lu attitude=%lu\n",
+         static_cast<unsigned long>(commands),
+         static_cast<unsigned long>(confirmed.load()),
+         static_cast<unsigned long>(failed.load()),
+         static_cast<unsigned long>(attitude_count));
+  printf("rx-thread allocations=%lu (%.3f per reply) pool_misses=%lu\n",
+         static_cast<unsigned long>(allocs),
+         replies > 0 ? static_cast<double>(allocs) / replies : 0.0,
+         static_cast<unsigned long>(stats.rx_buffer_misses));
+  return 0;
+}
@@ -0,0 +1,107 @@
+#include "c12_sim.h"
+#include "gimbal_ctrl.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * 连拍耗时：模拟器对 CAP 延迟 latency_ms 应答 (相机出图时间)，对比
+ * - blocking：逐张调用阻塞的 capturePhoto，再等待 interval
+ * - burst：startBurst 按绝对时刻发出，异步跟踪确认
+ * 输出最后一张发出与全部确认的时间，以及各张发出时刻相对
+ * 开始 + index x interval 的偏差。
+ *
+ * 用法：bench_burst [shots] [interval_ms] [latency_ms]
+ */
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+double ms(Clock::duration d) {
+  return std::chrono::duration<double, std::milli>(d).count();
+}
+
+void print(const char *method, int confirmed, int shots, double last_sent,
+           double all_done, const std::vector<double> &deviation) {
+  double mean = 0.0, max = 0.0;
+  for (double d : deviation) {
+    mean += std::fabs(d);
+    max = std::max(max, std::fabs(d));
+  }
+  if (!deviation.empty())
+    mean /= deviation.size();
+  printf("%-9s %5d/%-4d %14.1f %13.1f %14.2f %13.2f\n", method, confirmed,
+         shots, last_sent, all_done, mean, max);
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  int shots = argc > 1 ? atoi(argv[1]) : 10;
+  int interval_ms = argc > 2 ? atoi(argv[2]) : 100;
+  int latency_ms = argc > 3 ? atoi(argv[3]) : 150;
+  loguru::g_stderr_verbosity = loguru::Verbosity_WARNING;
+
+  const uint16_t port = 15800;
+  pid_t sim = c12sim::forkLoopback(port, latency_ms);
+
+  printf("shots=%d interval=%d ms capture latency=%d ms (ideal span %d ms)\n",
+         shots, interval_ms, latency_ms, (shots - 1) * interval_ms);
+  printf("%-9s %10s %14s %13s %14s %13s\n", "method", "confirmed",
+         "last_sent_ms", "all_done_ms", "dev_mean_ms", "dev_max_ms");
+
+  {
+    GimbalCtrl gimbal("127.0.0.1", port);
+    gimbal.setCommandRetry(latency_ms + 200, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    for (int round = 0; round < 3; round++) {
+      // 逐张阻塞
+      {
+        std::vector<double> deviation;
+        int confirmed = 0;
+        Clock::time_point start = Clock::now();
+        Clock::time_point last_sent = start;
+        for (int i = 0; i < shots; i++) {
+          last_sent = Clock::now();
+          deviation.push_back(ms(last_sent - start) - i * interval_ms);
+          if (gimbal.capturePhoto())
+            confirmed++;
+          if (i + 1 < shots)
+            std::this_thread::sleep_for(
+                std::chrono::milliseconds(interval_ms));
+        }
+        print("blocking", confirmed, shots, ms(last_sent - start),
+              ms(Clock::now() - start), deviation);
+      }
+
+      // 定时连拍
+      {
+        GimbalCtrl::BurstParams params;
+        params.count = shots;
+        params.interval_ms = interval_ms;
+        Clock::time_point start = Clock::now();
+        gimbal.startBurst(params);
+        gimbal.waitBurst(shots * interval_ms + latency_ms + 2000);
+        Clock::time_point done = Clock::now();
+        GimbalCtrl::BurstStatus status = gimbal.getBurstStatus();
+        std::vector<double> deviation;
+        Clock::time_point last_sent = start;
+        for (const GimbalCtrl::Shot &shot : gimbal.getBurstShots()) {
+          deviation.push_back(ms(shot.sent_at - shot.planned_at));
+          last_sent = std::max(last_sent, shot.sent_at);
+        }
+        print("burst", static_cast<int>(status.confirmed), shots,
+              ms(last_sent - start), ms(done - start), deviation);
+      }
+    }
+  }
+
+  c12sim::stopLoopback(sim);
+  return 0;
+}
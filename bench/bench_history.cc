@@ -0,0 +1,195 @@
+#include "gimbal_history.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+/**
+ * 姿态历史查询：多个读线程在保留范围内随机查询，写线程或在填满后停止
+ * (只测查询)，或不停追加样本 (样本时间间隔 10 ms，即 100 Hz 遥测的时间轴，
+ * 实际写入速率远高于此以放大覆盖竞争)。对比无锁环形缓冲 AttitudeHistory
+ * 与互斥锁 + deque 的二分查询，并按已知轨迹校验每个结果，统计错误
+ * (撕裂读) 数；misses 为读线程被调度出去期间窗口移过查询时刻。
+ *
+ * 用法：bench_history [budget_kib] [seconds]
+ */
+
+namespace {
+using Clock = AttitudeHistory::Clock;
+
+constexpr auto kSampleStep = std::chrono::milliseconds(10);
+const Clock::time_point kOrigin = Clock::time_point() + std::chrono::hours(1);
+
+// 第 k 个样本：三轴为分段线性的锯齿，插值结果可精确校验
+std::array<float, 3> trajectory(uint64_t k) {
+  return {static_cast<float>(k % 4000) * 0.01f - 20.0f,
+          static_cast<float>(k % 3000) * -0.01f,
+          static_cast<float>(k % 2000) * 0.01f - 10.0f};
+}
+
+bool expected(double k, std::array<float, 3> &angle) {
+  uint64_t base = static_cast<uint64_t>(k);
+  double w = k - base;
+  std::array<float, 3> a = trajectory(base), b = trajectory(base + 1);
+  for (size_t i = 0; i < 3; i++) {
+    if (std::fabs(b[i] - a[i]) > 0.011f)
+      return false; // 锯齿回绕处不校验
+    angle[i] = static_cast<float>(a[i] + (b[i] - a[i]) * w);
+  }
+  return true;
+}
+
+// 对照：互斥锁保护的 deque
+class LockedHistory {
+public:
+  explicit LockedHistory(size_t capacity) : capacity_(capacity) {}
+
+  void push(Clock::time_point stamp, const std::array<float, 3> &angle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    samples_.push_back({stamp, angle});
+    if (samples_.size() > capacity_)
+      samples_.pop_front();
+  }
+
+  bool at(Clock::time_point t, AttitudeHistory::Sample &sample) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::upper_bound(
+        samples_.begin(), samples_.end(), t,
+        [](Clock::time_point t, const AttitudeHistory::Sample &s) {
+          return t < s.stamp;
+        });
+    if (it == samples_.begin() || it == samples_.end())
+      return false;
+    const AttitudeHistory::Sample &hi = *it, &lo = *(it - 1);
+    double w = std::chrono::duration<double>(t - lo.stamp).count() /
+               std::chrono::duration<double>(hi.stamp - lo.stamp).count();
+    sample.stamp = t;
+    for (size_t i = 0; i < 3; i++)
+      sample.angle[i] =
+          static_cast<float>(lo.angle[i] + (hi.angle[i] - lo.angle[i]) * w);
+    return true;
+  }
+
+private:
+  size_t capacity_;
+  std::mutex mutex_;
+  std::deque<AttitudeHistory::Sample> samples_;
+};
+
+struct Result {
+  double lookup_ns = 0.0;
+  uint64_t lookups = 0;
+  uint64_t misses = 0; // 超出保留范围
+  uint64_t errors = 0;
+  uint64_t pushes = 0;
+};
+
+// writing 为 false 时写线程填满缓冲后停止，只测查询本身
+template <typename History>
+Result run(History &history, size_t capacity, int readers, double seconds,
+           bool writing) {
+  std::atomic<bool> stop{false};
+  std::atomic<uint64_t> written{0};
+  Result result;
+
+  std::thread writer([&] {
+    uint64_t k = 0;
+    while (!stop && (writing || k < capacity)) {
+      history.push(kOrigin + kSampleStep * k, trajectory(k));
+      written.store(++k, std::memory_order_release);
+    }
+  });
+  while (written.load() < capacity)
+    std::this_thread::yield();
+
+  std::mutex result_mutex;
+  std::vector<std::thread> threads;
+  for (int r = 0; r < readers; r++) {
+    threads.emplace_back([&, r] {
+      std::mt19937_64 rng(r + 1);
+      std::uniform_real_distribution<double> unit(0.0, 1.0);
+      uint64_t lookups = 0, misses = 0, errors = 0;
+      Clock::time_point start = Clock::now();
+      while (!stop) {
+        // 在最近 capacity 个样本范围内取点，偏向较新的一半
+        uint64_t head = written.load(std::memory_order_acquire);
+        double k = head - 1 - unit(rng) * (capacity - 2) * 0.5;
+        Clock::time_point t =
+            kOrigin + std::chrono::duration_cast<Clock::duration>(
+                          std::chrono::duration<double>(k * 0.01));
+        AttitudeHistory::Sample sample;
+        lookups++;
+        if (!history.at(t, sample)) {
+          misses++;
+          continue;
+        }
+        std::array<float, 3> want;
+        if (!expected(k, want))
+          continue;
+        for (size_t i = 0; i < 3; i++)
+          if (std::fabs(sample.angle[i] - want[i]) > 0.011f) {
+            errors++;
+            break;
+          }
+      }
+      double ns =
+          std::chrono::duration<double, std::nano>(Clock::now() - start)
+              .count();
+      std::lock_guard<std::mutex> lock(result_mutex);
+      result.lookup_ns += ns;
+      result.lookups += lookups;
+      result.misses += misses;
+      result.errors += errors;
+    });
+  }
+
+  std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+  stop = true;
+  for (std::thread &t : threads)
+    t.join();
+  writer.join();
+  result.pushes = written.load();
+  result.lookup_ns /= std::max<uint64_t>(1, result.lookups);
+  return result;
+}
+
+void print(const char *name, int readers, bool writing, const Result &r) {
+  printf("%-10s %7d %7s %12.1f %12lu %10lu %8lu %12lu\n", name, readers,
+         writing ? "yes" : "no",
+         r.lookup_ns, static_cast<unsigned long>(r.lookups),
+         static_cast<unsigned long>(r.misses),
+         static_cast<unsigned long>(r.errors),
+         static_cast<unsigned long>(r.pushes));
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  size_t budget = (argc > 1 ? atoi(argv[1]) : 64) * 1024;
+  double seconds = argc > 2 ? atof(argv[2]) : 1.0;
+
+  size_t capacity = AttitudeHistory(budget).capacity();
+  printf("budget=%zu KiB, capacity=%zu samples (%.1f s at 100 Hz)\n",
+         budget / 1024, capacity, capacity / 100.0);
+  printf("%-10s %7s %7s %12s %12s %10s %8s %12s\n", "history", "readers",
+         "writer", "ns/lookup", "lookups", "misses", "errors", "pushes");
+
+  for (bool writing : {false, true}) {
+    for (int readers : {1, 4}) {
+      AttitudeHistory ring(budget);
+      print("lock-free", readers, writing,
+            run(ring, capacity, readers, seconds, writing));
+      LockedHistory locked(capacity);
+      print("mutex", readers, writing,
+            run(locked, capacity, readers, seconds, writing));
+    }
+  }
+  return 0;
+}
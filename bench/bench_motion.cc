@@ -0,0 +1,228 @@
+#include "c12_sim.h"
+#include "gimbal_ctrl.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * 角度运动到位时间：对比固件内置运动 (setGimbalAngle，速度参数 100) 与
+ * 规划运动 (moveGimbal)。模拟器以 100 Hz 推送姿态，到位时间为姿态此后
+ * 一直处于目标 ±band 内的最早时刻，超调为越过目标的最大角度。
+ *
+ * 规划运动期间同时评估姿态预测：每 5 ms 预测 horizon 之后的姿态，
+ * 与届时收到的姿态比较，对照直接沿用最近一帧姿态的误差。
+ *
+ * 用法：bench_motion [band_deg] [horizon_ms]
+ */
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+struct Sample {
+  Clock::time_point stamp;
+  float yaw;
+  float pitch;
+};
+
+struct Move {
+  const char *name;
+  float from_yaw, from_pitch;
+  float to_yaw, to_pitch;
+};
+
+// 一次预测与同一时刻沿用的最近姿态
+struct Prediction {
+  Clock::time_point at;
+  float yaw_predicted, pitch_predicted;
+  float yaw_held, pitch_held;
+};
+
+struct Result {
+  double settle_s = -1.0; // 未到位为负
+  double overshoot = 0.0;
+};
+
+std::mutex g_mutex;
+std::vector<Sample> g_samples;
+std::vector<Prediction> g_predictions;
+
+// 收到的姿态在 t 时刻的线性插值
+bool interpolate(Clock::time_point t, float &yaw, float &pitch) {
+  for (size_t i = 1; i < g_samples.size(); i++) {
+    const Sample &a = g_samples[i - 1];
+    const Sample &b = g_samples[i];
+    if (a.stamp <= t && t <= b.stamp && b.stamp > a.stamp) {
+      double w = std::chrono::duration<double>(t - a.stamp).count() /
+                 std::chrono::duration<double>(b.stamp - a.stamp).count();
+      yaw = static_cast<float>(a.yaw + (b.yaw - a.yaw) * w);
+      pitch = static_cast<float>(a.pitch + (b.pitch - a.pitch) * w);
+      return true;
+    }
+  }
+  return false;
+}
+
+Result evaluate(const Move &move, Clock::time_point start, double band) {
+  std::lock_guard<std::mutex> lock(g_mutex);
+  Result result;
+  double dir_yaw = move.to_yaw >= move.from_yaw ? 1.0 : -1.0;
+  double dir_pitch = move.to_pitch >= move.from_pitch ? 1.0 : -1.0;
+  double last_outside = 0.0;
+  bool settled = false;
+  for (const Sample &s : g_samples) {
+    if (s.stamp < start)
+      continue;
+    double t = std::chrono::duration<double>(s.stamp - start).count();
+    double err_yaw = s.yaw - move.to_yaw;
+    double err_pitch = s.pitch - move.to_pitch;
+    if (move.to_yaw != move.from_yaw)
+      result.overshoot = std::max(result.overshoot, err_yaw * dir_yaw);
+    if (move.to_pitch != move.from_pitch)
+      result.overshoot = std::max(result.overshoot, err_pitch * dir_pitch);
+    settled = std::fabs(err_yaw) <= band && std::fabs(err_pitch) <= band;
+    if (!settled)
+      last_outside = t;
+  }
+  if (settled)
+    result.settle_s = last_outside;
+  return result;
+}
+
+// 用固件内置运动回到起点并等待静止
+bool settleAt(GimbalCtrl &gimbal, float yaw, float pitch) {
+  gimbal.setGimbalAngle(yaw, pitch, 0.0f, 100.0f);
+  auto deadline = Clock::now() + std::chrono::seconds(6);
+  auto still_since = Clock::now();
+  while (Clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    GimbalCtrl::Attitude a = gimbal.getAttitude();
+    if (std::fabs(a.yaw - yaw) > 0.02f || std::fabs(a.pitch - pitch) > 0.02f)
+      still_since = Clock::now();
+    else if (Clock::now() - still_since > std::chrono::milliseconds(300))
+      return true;
+  }
+  return false;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  double band = argc > 1 ? atof(argv[1]) : 0.2;
+  int horizon_ms = argc > 2 ? atoi(argv[2]) : 40;
+  double sq_predicted = 0.0, sq_held = 0.0;
+  size_t predictions = 0;
+  loguru::g_stderr_verbosity = loguru::Verbosity_WARNING;
+
+  const uint16_t port = 15600;
+  pid_t sim = c12sim::forkLoopback(port);
+
+  const Move moves[] = {
+      {"yaw 1", 0, 0, 1, 0},          {"yaw 5", 0, 0, 5, 0},
+      {"yaw 20", 0, 0, 20, 0},        {"yaw 90", -45, 0, 45, 0},
+      {"yaw 160", -80, 0, 80, 0},     {"pitch -60", 0, 30, 0, -30},
+      {"yaw 30 pitch -20", 0, 0, 30, -20},
+  };
+
+  printf("band=%.2f deg, window=4 s\n", band);
+  printf("%-18s %-9s %9s %9s %11s %8s\n", "move", "method", "planned_s",
+         "settle_s", "overshoot", "frames");
+
+  {
+    GimbalCtrl gimbal("127.0.0.1", port);
+    gimbal.setAttitudeCallback([](const GimbalCtrl::Attitude &a) {
+      std::lock_guard<std::mutex> lock(g_mutex);
+      g_samples.push_back({a.stamp, a.yaw, a.pitch});
+    });
+    // 模拟器的姿态在推送时刻采样，没有遥测时延
+    AttitudeEstimator::Params estimator;
+    estimator.telemetry_latency_ms = 0;
+    gimbal.setEstimatorParams(estimator);
+    gimbal.enableAttitudeOutput(100);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    for (const Move &move : moves) {
+      for (int method = 0; method < 2; method++) {
+        if (!settleAt(gimbal, move.from_yaw, move.from_pitch)) {
+          printf("%-18s failed to reach start\n", move.name);
+          continue;
+        }
+        {
+          std::lock_guard<std::mutex> lock(g_mutex);
+          g_samples.clear();
+        }
+
+        Clock::time_point start = Clock::now();
+        double planned = 0.0;
+        uint64_t frames = 0;
+        if (method == 0) {
+          gimbal.setGimbalAngle(move.to_yaw, move.to_pitch, 0.0f, 100.0f);
+          std::this_thread::sleep_for(std::chrono::seconds(4));
+          frames = 3;
+        } else {
+          std::atomic<bool> sampling{true};
+          std::vector<Prediction> local;
+          std::thread sampler([&] {
+            while (sampling) {
+              Clock::time_point at =
+                  Clock::now() + std::chrono::milliseconds(horizon_ms);
+              GimbalCtrl::Attitude predicted = gimbal.predictAttitude(at);
+              GimbalCtrl::Attitude held = gimbal.getAttitude();
+              local.push_back({at, predicted.yaw, predicted.pitch, held.yaw,
+                               held.pitch});
+              std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+          });
+          gimbal.moveGimbal(move.to_yaw, move.to_pitch);
+          gimbal.waitMotion(4000);
+          sampling = false;
+          sampler.join();
+          std::this_thread::sleep_until(start + std::chrono::seconds(4));
+          GimbalCtrl::MotionStatus status = gimbal.getMotionStatus();
+          planned = status.planned_s;
+          frames = status.rate_commands + 2;
+          std::lock_guard<std::mutex> lock(g_mutex);
+          g_predictions.swap(local);
+        }
+
+        Result result = evaluate(move, start, band);
+        if (method == 1) {
+          std::lock_guard<std::mutex> lock(g_mutex);
+          for (const Prediction &p : g_predictions) {
+            float yaw, pitch;
+            if (!interpolate(p.at, yaw, pitch))
+              continue;
+            sq_predicted += (p.yaw_predicted - yaw) * (p.yaw_predicted - yaw) +
+                            (p.pitch_predicted - pitch) *
+                                (p.pitch_predicted - pitch);
+            sq_held += (p.yaw_held - yaw) * (p.yaw_held - yaw) +
+                       (p.pitch_held - pitch) * (p.pitch_held - pitch);
+            predictions++;
+          }
+        }
+        char settle[16];
+        if (result.settle_s < 0)
+          snprintf(settle, sizeof(settle), "-");
+        else
+          snprintf(settle, sizeof(settle), "%.3f", result.settle_s);
+        printf("%-18s %-9s %9.3f %9s %11.3f %8lu\n", move.name,
+               method == 0 ? "firmware" : "planned", planned, settle,
+               result.overshoot, static_cast<unsigned long>(frames));
+      }
+    }
+  }
+
+  if (predictions > 0)
+    printf("attitude %d ms ahead during planned moves (%zu samples): "
+           "rms error held=%.3f predicted=%.3f deg\n",
+           horizon_ms, predictions, std::sqrt(sq_held / predictions),
+           std::sqrt(sq_predicted / predictions));
+
+  c12sim::stopLoopback(sim);
+  return 0;
+}
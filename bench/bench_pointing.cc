@@ -0,0 +1,141 @@
+#include "gimbal_pointing.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+/**
+ * 批量指向解算吞吐：对比逐目标双精度解算 (每个目标都做 LLA->ECEF 与
+ * 标准库 atan2，相当于原先应用层的做法) 与 solvePointing。目标随机分布
+ * 在载机周围 radius 范围内，输出每帧耗时、每目标耗时与两者的最大角度差。
+ *
+ * 用法：bench_pointing [radius_m] [frames]
+ */
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr double kSemiMajor = 6378137.0;
+constexpr double kFlattening = 1.0 / 298.257223563;
+constexpr double kEccSq = kFlattening * (2.0 - kFlattening);
+constexpr double kDegToRad = 3.14159265358979323846 / 180.0;
+
+struct Target {
+  double lat, lon, alt;
+};
+
+void llaToEcef(double lat_deg, double lon_deg, double alt_m, double ecef[3]) {
+  double lat = lat_deg * kDegToRad, lon = lon_deg * kDegToRad;
+  double n = kSemiMajor / std::sqrt(1.0 - kEccSq * std::sin(lat) * std::sin(lat));
+  ecef[0] = (n + alt_m) * std::cos(lat) * std::cos(lon);
+  ecef[1] = (n + alt_m) * std::cos(lat) * std::sin(lon);
+  ecef[2] = (n * (1.0 - kEccSq) + alt_m) * std::sin(lat);
+}
+
+// 逐目标双精度参考解算
+void solveReference(const VehiclePose &pose, const Target &target, float &yaw,
+                    float &pitch) {
+  double v[3], t[3];
+  llaToEcef(pose.lat_deg, pose.lon_deg, pose.alt_m, v);
+  llaToEcef(target.lat, target.lon, target.alt, t);
+  double d[3] = {t[0] - v[0], t[1] - v[1], t[2] - v[2]};
+
+  double lat = pose.lat_deg * kDegToRad, lon = pose.lon_deg * kDegToRad;
+  double n = -std::sin(lat) * std::cos(lon) * d[0] -
+             std::sin(lat) * std::sin(lon) * d[1] + std::cos(lat) * d[2];
+  double e = -std::sin(lon) * d[0] + std::cos(lon) * d[1];
+  double down = -std::cos(lat) * std::cos(lon) * d[0] -
+                std::cos(lat) * std::sin(lon) * d[1] - std::sin(lat) * d[2];
+
+  double sy = std::sin(pose.yaw_deg * kDegToRad);
+  double cy = std::cos(pose.yaw_deg * kDegToRad);
+  double st = std::sin(pose.pitch_deg * kDegToRad);
+  double ct = std::cos(pose.pitch_deg * kDegToRad);
+  double sr = std::sin(pose.roll_deg * kDegToRad);
+  double cr = std::cos(pose.roll_deg * kDegToRad);
+  double bx = ct * cy * n + ct * sy * e - st * down;
+  double by = (sr * st * cy - cr * sy) * n + (sr * st * sy + cr * cy) * e +
+              sr * ct * down;
+  double bz = (cr * st * cy + sr * sy) * n + (cr * st * sy - sr * cy) * e +
+              cr * ct * down;
+
+  double y = std::atan2(by, bx) / kDegToRad;
+  double p = std::atan2(-bz, std::sqrt(bx * bx + by * by)) / kDegToRad;
+  yaw = static_cast<float>(std::max(-90.0, std::min(90.0, y)));
+  pitch = static_cast<float>(std::max(-90.0, std::min(90.0, p)));
+}
+
+double elapsedUs(Clock::time_point start) {
+  return std::chrono::duration<double, std::micro>(Clock::now() - start)
+      .count();
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  double radius = argc > 1 ? atof(argv[1]) : 20000.0;
+  int frames = argc > 2 ? atoi(argv[2]) : 50;
+
+  std::mt19937 rng(12);
+  std::uniform_real_distribution<double> unit(-1.0, 1.0);
+  std::uniform_real_distribution<float> attitude(-15.0f, 15.0f);
+  VehiclePose base;
+  base.lat_deg = 39.96;
+  base.lon_deg = 116.31;
+  base.alt_m = 1500.0;
+
+  printf("radius=%.0f m, frames=%d\n", radius, frames);
+  printf("%8s %12s %12s %10s %10s %12s %8s\n", "targets", "ref_us/frame",
+         "simd_us/frame", "ref_ns/tgt", "simd_ns/tgt", "max_err_deg",
+         "clamped");
+
+  for (size_t count : {100u, 1000u, 10000u, 100000u}) {
+    std::vector<Target> list(count);
+    PointingTargets targets;
+    targets.reserve(count);
+    for (Target &t : list) {
+      t.lat = base.lat_deg + unit(rng) * radius / 111000.0;
+      t.lon = base.lon_deg + unit(rng) * radius / 85000.0;
+      t.alt = 50.0 + 100.0 * unit(rng);
+      targets.add(t.lat, t.lon, t.alt);
+    }
+
+    // 每帧载机位姿不同，模拟运动中的重复解算
+    std::vector<VehiclePose> poses(frames, base);
+    for (VehiclePose &pose : poses) {
+      pose.yaw_deg = attitude(rng) * 12.0f;
+      pose.pitch_deg = attitude(rng);
+      pose.roll_deg = attitude(rng);
+    }
+
+    std::vector<float> ref_yaw(count), ref_pitch(count);
+    double ref_us = 0.0, simd_us = 0.0, max_err = 0.0;
+    size_t clamped = 0;
+    PointingSolution solution;
+    for (const VehiclePose &pose : poses) {
+      Clock::time_point start = Clock::now();
+      for (size_t i = 0; i < count; i++)
+        solveReference(pose, list[i], ref_yaw[i], ref_pitch[i]);
+      ref_us += elapsedUs(start);
+
+      start = Clock::now();
+      clamped = solvePointing(pose, targets, solution);
+      simd_us += elapsedUs(start);
+
+      for (size_t i = 0; i < count; i++)
+        max_err = std::max(
+            max_err,
+            static_cast<double>(std::max(std::fabs(solution.yaw[i] - ref_yaw[i]),
+                                         std::fabs(solution.pitch[i] -
+                                                   ref_pitch[i]))));
+    }
+
+    printf("%8zu %12.1f %12.1f %10.2f %10.2f %12.6f %8zu\n", count,
+           ref_us / frames, simd_us / frames, ref_us * 1000.0 / frames / count,
+           simd_us * 1000.0 / frames / count, max_err, clamped);
+  }
+  return 0;
+}
@@ -0,0 +1,207 @@
+#include "c12_sim.h"
+#include "gimbal_ctrl.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * 扫描执行精度：对比应用层脚本 (setGimbalAngle + sleep + capturePhoto，
+ * 按估计的运动时间等待) 与扫描引擎 (startScan)。拍照时刻取指令记录的
+ * 发送时间，位置误差取记录中发送时刻的云台姿态与航点的角距离；
+ * 时刻误差为实际发送相对计划时刻的偏差 (脚本的计划为累加的等待时间)。
+ *
+ * 用法：bench_scan [dwell_ms]
+ */
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+std::mutex g_mutex;
+std::vector<GimbalCtrl::CommandRecord> g_captures;
+
+struct Result {
+  size_t captures = 0;
+  double duration_s = 0.0;
+  double late_mean_ms = 0.0;
+  double late_max_ms = 0.0;
+  double error_mean = 0.0;
+  double error_max = 0.0;
+};
+
+// captures 与 points/planned 按顺序对应
+Result evaluate(const std::vector<ScanPoint> &points,
+                const std::vector<double> &planned, Clock::time_point start,
+                double duration_s) {
+  std::lock_guard<std::mutex> lock(g_mutex);
+  Result result;
+  result.duration_s = duration_s;
+  for (size_t i = 0; i < g_captures.size() && i < points.size(); i++) {
+    const GimbalCtrl::CommandRecord &r = g_captures[i];
+    double at = std::chrono::duration<double>(r.sent_at - start).count();
+    double late = std::fabs(at - planned[i]) * 1000.0;
+    double error = std::hypot(r.attitude.yaw - points[i].yaw,
+                              r.attitude.pitch - points[i].pitch);
+    result.late_mean_ms += late;
+    result.late_max_ms = std::max(result.late_max_ms, late);
+    result.error_mean += error;
+    result.error_max = std::max(result.error_max, error);
+    result.captures++;
+  }
+  if (result.captures > 0) {
+    result.late_mean_ms /= result.captures;
+    result.error_mean /= result.captures;
+  }
+  return result;
+}
+
+void print(const char *name, const char *method, const Result &r) {
+  printf("%-8s %-8s %8zu %10.3f %12.2f %11.2f %12.3f %11.3f\n", name, method,
+         r.captures, r.duration_s, r.late_mean_ms, r.late_max_ms,
+         r.error_mean, r.error_max);
+}
+
+bool settleAt(GimbalCtrl &gimbal, float yaw, float pitch) {
+  gimbal.setGimbalAngle(yaw, pitch, 0.0f, 100.0f);
+  auto deadline = Clock::now() + std::chrono::seconds(6);
+  auto still_since = Clock::now();
+  while (Clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    GimbalCtrl::Attitude a = gimbal.getAttitude();
+    if (std::fabs(a.yaw - yaw) > 0.02f || std::fabs(a.pitch - pitch) > 0.02f)
+      still_since = Clock::now();
+    else if (Clock::now() - still_since > std::chrono::milliseconds(300))
+      return true;
+  }
+  return false;
+}
+
+void clearCaptures() {
+  std::lock_guard<std::mutex> lock(g_mutex);
+  g_captures.clear();
+}
+
+// 应用层脚本：固件角度指令，按行程 / 标称速度估计运动时间后等待
+Result runScript(GimbalCtrl &gimbal, const ScanPattern &pattern,
+                 float nominal_rate) {
+  const std::vector<ScanPoint> &points = pattern.points();
+  std::vector<double> planned;
+  GimbalCtrl::Attitude a = gimbal.getAttitude();
+  float yaw = a.yaw, pitch = a.pitch;
+  double t = 0.0;
+  Clock::time_point start = Clock::now();
+  for (const ScanPoint &p : points) {
+    double move = std::max(std::fabs(p.yaw - yaw), std::fabs(p.pitch - pitch)) /
+                  nominal_rate;
+    planned.push_back(t + move + p.capture_ms / 1000.0);
+    t += move + p.dwell_ms / 1000.0;
+    yaw = p.yaw;
+    pitch = p.pitch;
+
+    gimbal.setGimbalAngle(p.yaw, p.pitch, 0.0f, 100.0f);
+    std::this_thread::sleep_for(
+        std::chrono::duration<double>(move + p.capture_ms / 1000.0));
+    gimbal.capturePhoto();
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(p.dwell_ms - p.capture_ms));
+  }
+  double duration = std::chrono::duration<double>(Clock::now() - start).count();
+  return evaluate(points, planned, start, duration);
+}
+
+Result runEngine(GimbalCtrl &gimbal, const ScanPattern &pattern,
+                 GimbalCtrl::ScanStatus &status) {
+  GimbalCtrl::Attitude a = gimbal.getAttitude();
+  GimbalCtrl::MotionParams params;
+  ScanSchedule schedule = ScanSchedule::plan(
+      pattern, a.yaw, a.pitch, params.max_rate, params.max_accel,
+      params.max_jerk);
+  std::vector<double> planned;
+  for (const ScanLeg &leg : schedule.legs())
+    planned.push_back(leg.capture_s);
+
+  gimbal.startScan(pattern);
+  gimbal.waitScan(static_cast<int>(schedule.duration() * 1000) + 3000);
+  // 等待最后一次拍照确认
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  status = gimbal.getScanStatus();
+  double duration = std::chrono::duration<double>(status.finished_at -
+                                                  status.started_at)
+                        .count();
+  return evaluate(pattern.points(), planned, status.started_at, duration);
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  int dwell_ms = argc > 1 ? atoi(argv[1]) : 400;
+  loguru::g_stderr_verbosity = loguru::Verbosity_WARNING;
+
+  const uint16_t port = 15700;
+  pid_t sim = c12sim::forkLoopback(port);
+
+  struct Case {
+    const char *name;
+    ScanPattern pattern;
+  };
+  std::vector<ScanPoint> route = {{10, -10, dwell_ms, dwell_ms / 2},
+                                  {-35, -20, dwell_ms, dwell_ms / 2},
+                                  {0, -45, dwell_ms, dwell_ms / 2},
+                                  {40, 0, dwell_ms, dwell_ms / 2}};
+  const Case cases[] = {
+      {"raster", ScanPattern::raster(-30, 30, -10, -40, 15, 15, dwell_ms)},
+      {"sector", ScanPattern::sector(-60, 60, -20, 20, dwell_ms, 2)},
+      {"spiral", ScanPattern::spiral(0, -20, 15, 5, dwell_ms)},
+      {"route", ScanPattern::waypoints(route)},
+  };
+
+  printf("dwell=%d ms, capture at mid-dwell\n", dwell_ms);
+  printf("%-8s %-8s %8s %10s %12s %11s %12s %11s\n", "pattern", "method",
+         "captures", "duration_s", "t_err_mean_ms", "t_err_max_ms",
+         "pos_err_mean", "pos_err_max");
+
+  {
+    GimbalCtrl gimbal("127.0.0.1", port);
+    gimbal.setCommandCallback([](const GimbalCtrl::CommandRecord &r) {
+      if (r.identifier != "CAP")
+        return;
+      std::lock_guard<std::mutex> lock(g_mutex);
+      g_captures.push_back(r);
+    });
+    AttitudeEstimator::Params estimator;
+    estimator.telemetry_latency_ms = 0;
+    gimbal.setEstimatorParams(estimator);
+    gimbal.enableAttitudeOutput(100);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    for (const Case &c : cases) {
+      const ScanPoint &first = c.pattern.points().front();
+      // 固件角度环在速度参数 100 下的平均速度约 30 deg/s
+      settleAt(gimbal, first.yaw, first.pitch);
+      clearCaptures();
+      print(c.name, "script", runScript(gimbal, c.pattern, 30.0f));
+
+      settleAt(gimbal, first.yaw, first.pitch);
+      clearCaptures();
+      GimbalCtrl::ScanStatus status;
+      print(c.name, "engine", runEngine(gimbal, c.pattern, status));
+      printf("%-8s %-8s trigger late mean %.0f us max %.0f us, "
+             "estimated error mean %.3f max %.3f deg, confirmed %lu/%lu\n",
+             "", "", status.trigger_late_sum_us /
+                         std::max<uint64_t>(1, status.captures_triggered),
+             status.trigger_late_max_us,
+             status.position_error_sum /
+                 std::max<uint64_t>(1, status.captures_triggered),
+             status.position_error_max,
+             static_cast<unsigned long>(status.captures_confirmed),
+             static_cast<unsigned long>(status.captures_planned));
+    }
+  }
+
+  c12sim::stopLoopback(sim);
+  return 0;
+}
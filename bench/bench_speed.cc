@@ -0,0 +1,136 @@
+#include "c12_sim.h"
+#include "gimbal_ctrl.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+/**
+ * 速率模式精度：模拟器积分 GSY 速率，对比
+ * - truncate：设定值截断到 0.5 deg/s 单位 (原 setGimbalSpeed 的行为)
+ * - dither：setGimbalSpeed 的 sigma-delta 调制
+ * 以姿态遥测相对 "起点 + 设定速率 x t" 的偏差衡量漂移；前 1 s 的速度
+ * 响应滞后作为常量偏移扣除。dither 行同时给出调制器内部的位置误差上界
+ * 与实际下发的帧数 (应用每 50 ms 更新一次设定值)。最后一段只设定一次
+ * 速率后不再更新，检查 feed_timeout_ms 后的自动停止与保活统计。
+ *
+ * 用法：bench_speed [seconds]
+ */
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+bool settleAt(GimbalCtrl &gimbal, float yaw) {
+  gimbal.setGimbalAngle(yaw, 0.0f, 0.0f, 100.0f);
+  auto deadline = Clock::now() + std::chrono::seconds(6);
+  auto still_since = Clock::now();
+  while (Clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    GimbalCtrl::Attitude a = gimbal.getAttitude();
+    if (std::fabs(a.yaw - yaw) > 0.02f)
+      still_since = Clock::now();
+    else if (Clock::now() - still_since > std::chrono::milliseconds(300))
+      return true;
+  }
+  return false;
+}
+
+struct Drift {
+  double final_deg = 0.0;
+  double max_deg = 0.0;
+};
+
+// 以 command 运行 seconds 秒，偏差按设定速率 rate 计算
+Drift run(GimbalCtrl &gimbal, float rate, float command, double seconds) {
+  const float start_yaw = -80.0f;
+  settleAt(gimbal, start_yaw);
+  GimbalCtrl::Attitude start = gimbal.getAttitude();
+  Clock::time_point t0 = Clock::now();
+  gimbal.setGimbalSpeed(command, 0.0f);
+
+  Drift drift;
+  bool offset_known = false;
+  double offset = 0.0;
+  while (Clock::now() - t0 < std::chrono::duration<double>(seconds)) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    gimbal.setGimbalSpeed(command, 0.0f);
+    GimbalCtrl::Attitude a = gimbal.getAttitude();
+    double t = std::chrono::duration<double>(a.stamp - t0).count();
+    if (t < 1.0)
+      continue;
+    double error = a.yaw - (start.yaw + rate * t);
+    if (!offset_known) {
+      offset = error;
+      offset_known = true;
+    }
+    drift.final_deg = error - offset;
+    drift.max_deg = std::max(drift.max_deg, std::fabs(drift.final_deg));
+  }
+  gimbal.setGimbalSpeed(0.0f, 0.0f);
+  return drift;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  double seconds = argc > 1 ? atof(argv[1]) : 4.0;
+  loguru::g_stderr_verbosity = loguru::Verbosity_WARNING;
+
+  const uint16_t port = 16000;
+  pid_t sim = c12sim::forkLoopback(port);
+
+  {
+    GimbalCtrl gimbal("127.0.0.1", port);
+    gimbal.enableAttitudeOutput(100);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    GimbalCtrl::MotionParams params;
+
+    printf("%.1f s per run, %d ms loop period, telemetry 0.01 deg\n", seconds,
+           params.period_ms);
+    printf("%-8s %-9s %10s %13s %11s %13s %7s\n", "rate", "method",
+           "command", "drift_deg", "max_deg", "loop_err_max", "frames");
+    for (float rate : {0.3f, 1.26f, 7.7f, 15.3f}) {
+      float truncated = std::trunc(rate / 0.5f) * 0.5f;
+      Drift t = run(gimbal, rate, truncated, seconds);
+      printf("%-8.2f %-9s %10.2f %13.4f %11.4f\n", rate, "truncate",
+             truncated, t.final_deg, t.max_deg);
+
+      Drift d = run(gimbal, rate, rate, seconds);
+      // 停止后 active 为 false，统计保留到下一次进入速率模式
+      GimbalCtrl::SpeedStatus status = gimbal.getSpeedStatus();
+      printf("%-8.2f %-9s %10.2f %13.4f %11.4f %13.5f %7lu\n", rate,
+             "dither", rate, d.final_deg, d.max_deg, status.error_max,
+             static_cast<unsigned long>(status.rate_commands));
+    }
+
+    // 应用停止更新
+    GimbalCtrl::MotionGuard guard;
+    settleAt(gimbal, -80.0f);
+    gimbal.resetLinkStats();
+    Clock::time_point t0 = Clock::now();
+    gimbal.setGimbalSpeed(5.0f, 0.0f);
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(guard.feed_timeout_ms + 500));
+    GimbalCtrl::Attitude before = gimbal.getAttitude();
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    GimbalCtrl::Attitude after = gimbal.getAttitude();
+    GimbalCtrl::LinkStats stats = gimbal.getLinkStats();
+    GimbalCtrl::SpeedStatus status = gimbal.getSpeedStatus();
+    printf("\nsingle call, no feed: active=%d at %.2f s, "
+           "rate over the next 0.5 s %.3f deg/s\n",
+           status.active,
+           std::chrono::duration<double>(before.stamp - t0).count(),
+           (after.yaw - before.yaw) /
+               std::chrono::duration<double>(after.stamp - before.stamp)
+                   .count());
+    printf("auto_stops=%lu rate_refreshes=%lu expired_dropped=%lu\n",
+           static_cast<unsigned long>(stats.auto_stops),
+           static_cast<unsigned long>(stats.rate_refreshes),
+           static_cast<unsigned long>(stats.expired_dropped));
+  }
+
+  c12sim::stopLoopback(sim);
+  return 0;
+}
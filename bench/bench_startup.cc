@@ -0,0 +1,107 @@
+#include "c12_sim.h"
+#include "gimbal_ctrl.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <spawn.h>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * 库布局基准：启动耗时 (动态加载与重定位) 与单条指令开销。
+ * 分别以 GIMBAL_SINGLE_LIBRARY=OFF/ON、GIMBAL_LIBRARY_TYPE=SHARED/STATIC
+ * 构建后运行，对比各布局的输出。
+ *
+ * 用法：bench_startup [spawns] [commands]
+ */
+
+extern char **environ;
+
+namespace {
+double cpuSeconds() {
+  timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// 子进程模式：noop 只完成加载，first 额外完成构造与一次往返
+int runChild(const char *mode, uint16_t port) {
+  if (strcmp(mode, "noop") == 0)
+    return 0;
+
+  loguru::g_stderr_verbosity = loguru::Verbosity_WARNING;
+  GimbalCtrl gimbal("127.0.0.1", port);
+  GimbalCtrl::CommandRecord record;
+  return gimbal.waitCommand(gimbal.capturePhotoAsync(), record) ? 0 : 1;
+}
+
+// 反复拉起自身，返回平均耗时 (us)
+double spawnMean(const char *mode, uint16_t port, int spawns) {
+  std::string port_arg = std::to_string(port);
+  char *argv[] = {const_cast<char *>("bench_startup"),
+                  const_cast<char *>("--child"), const_cast<char *>(mode),
+                  const_cast<char *>(port_arg.c_str()), nullptr};
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < spawns; i++) {
+    pid_t pid;
+    if (posix_spawn(&pid, "/proc/self/exe", nullptr, nullptr, argv,
+                    environ) != 0) {
+      perror("posix_spawn");
+      return 0;
+    }
+    waitpid(pid, nullptr, 0);
+  }
+  return std::chrono::duration<double, std::micro>(
+             std::chrono::steady_clock::now() - start)
+             .count() /
+         spawns;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc == 4 && strcmp(argv[1], "--child") == 0)
+    return runChild(argv[2], static_cast<uint16_t>(atoi(argv[3])));
+
+  int spawns = argc > 1 ? atoi(argv[1]) : 100;
+  int commands = argc > 2 ? atoi(argv[2]) : 5000;
+  const uint16_t port = 15100;
+
+  pid_t sim = c12sim::forkLoopback(port);
+
+  double noop_us = spawnMean("noop", port, spawns);
+  double first_us = spawnMean("first", port, spawns);
+
+  // 进程内顺序往返，统计单条指令的 CPU 与墙钟开销
+  loguru::g_stderr_verbosity = loguru::Verbosity_WARNING;
+  double cpu_us = 0;
+  double wall_us = 0;
+  int confirmed = 0;
+  {
+    GimbalCtrl gimbal("127.0.0.1", port);
+    GimbalCtrl::CommandRecord record;
+    double cpu_start = cpuSeconds();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < commands; i++) {
+      if (gimbal.waitCommand(gimbal.capturePhotoAsync(), record))
+        confirmed++;
+    }
+    wall_us = std::chrono::duration<double, std::micro>(
+                  std::chrono::steady_clock::now() - start)
+                  .count() /
+              commands;
+    cpu_us = (cpuSeconds() - cpu_start) * 1e6 / commands;
+  }
+
+  c12sim::stopLoopback(sim);
+
+  printf("layout          spawn_us  first_cmd_us  cmd_wall_us  cmd_cpu_us  "
+         "confirmed\n");
+  printf("%-14s %9.1f %13.1f %12.2f %11.2f %6d/%d\n", GIMBAL_LAYOUT, noop_us,
+         first_us, wall_us, cpu_us, confirmed, commands);
+  return 0;
+}
@@ -0,0 +1,202 @@
+#include "gimbal_telemetry.h"
+#include "gimbal_telemetry_writer.h"
+#include "loguru/loguru.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+/**
+ * 遥测记录开销与事后查询：按一次飞行的数据率 (100 Hz 姿态、GSY/GSP 各
+ * 50 Hz 速率流、10 Hz 往返时延) 生成 minutes 分钟的数据，对比
+ * - columnar：TelemetryWriter 写入预分配的映射文件
+ * - loguru：现有日志的文本文件输出 (LOG_F)
+ * - csv：带缓冲的 fprintf 文本
+ * 的每行写入耗时与文件大小；再随机查询 10 s 时间窗的姿态，对比读端只映射
+ * 相交块与逐行解析整个 CSV 的耗时。
+ *
+ * 用法：bench_telemetry [minutes] [dir]
+ */
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+struct Row {
+  int64_t t_ns;
+  int channel; // 1 姿态, 2 指令, 3 时延
+  const char *id;
+  float a, b, c;
+};
+
+// 按飞行数据率生成时间有序的行，10 ms 一步
+std::vector<Row> flight(int minutes, int64_t origin_ns) {
+  std::vector<Row> rows;
+  std::mt19937 rng(1);
+  std::normal_distribution<float> rtt(900.0f, 150.0f);
+  for (int64_t step = 0; step < minutes * 6000ll; step++) {
+    int64_t t = origin_ns + step * 10000000ll;
+    float phase = step * 0.001f;
+    rows.push_back({t, 1, "GAC", 30.0f * std::sin(phase),
+                    -20.0f + 10.0f * std::cos(phase), 0.1f});
+    if (step % 2 == 0) {
+      rows.push_back({t + 100000, 2, "GSY", 15.0f * std::cos(phase), 0, 0});
+      rows.push_back({t + 200000, 2, "GSP", -5.0f * std::sin(phase), 0, 0});
+    }
+    if (step % 10 == 0)
+      rows.push_back({t + 300000, 3, "GAY", rtt(rng), 0, 0});
+  }
+  return rows;
+}
+
+double nsPerRow(Clock::time_point start, size_t rows) {
+  return std::chrono::duration<double, std::nano>(Clock::now() - start)
+             .count() /
+         rows;
+}
+
+off_t fileSize(const std::string &path) {
+  struct stat st;
+  return stat(path.c_str(), &st) == 0 ? st.st_size : 0;
+}
+
+void writeColumnar(const std::string &prefix, const std::vector<Row> &rows) {
+  TelemetryWriter::Params params;
+  params.max_files = 0;
+  TelemetryWriter writer;
+  writer.open(prefix, params);
+  Clock::time_point start = Clock::now();
+  for (const Row &r : rows) {
+    if (r.channel == 1)
+      writer.attitude(r.t_ns, r.a, r.b, r.c);
+    else if (r.channel == 2)
+      writer.command(r.t_ns, r.id, r.a, static_cast<int32_t>(r.a * 2));
+    else
+      writer.rtt(r.t_ns, r.id, r.a, false);
+  }
+  double ns = nsPerRow(start, rows.size());
+  writer.close();
+  TelemetryWriter::Stats stats = writer.stats();
+  off_t bytes = 0;
+  for (uint32_t i = 0; i < stats.files; i++)
+    bytes += fileSize(telemetryFilePath(prefix, i));
+  printf("%-10s %12.1f %12.2f %8u\n", "columnar", ns, bytes / 1048576.0,
+         stats.files);
+}
+
+void writeLoguru(const std::string &path, const std::vector<Row> &rows) {
+  loguru::add_file(path.c_str(), loguru::Truncate, loguru::Verbosity_INFO);
+  Clock::time_point start = Clock::now();
+  for (const Row &r : rows) {
+    if (r.channel == 1)
+      LOG_F(INFO, "ATT %" PRId64 " %.2f %.2f %.2f", r.t_ns, r.a, r.b, r.c);
+    else if (r.channel == 2)
+      LOG_F(INFO, "CMD %" PRId64 " %s %.1f", r.t_ns, r.id, r.a);
+    else
+      LOG_F(INFO, "RTT %" PRId64 " %s %.1f", r.t_ns, r.id, r.a);
+  }
+  double ns = nsPerRow(start, rows.size());
+  loguru::remove_callback(path.c_str());
+  printf("%-10s %12.1f %12.2f %8d\n", "loguru", ns,
+         fileSize(path) / 1048576.0, 1);
+}
+
+void writeCsv(const std::string &path, const std::vector<Row> &rows) {
+  FILE *file = fopen(path.c_str(), "w");
+  Clock::time_point start = Clock::now();
+  for (const Row &r : rows)
+    fprintf(file, "%d,%" PRId64 ",%s,%.2f,%.2f,%.2f\n", r.channel, r.t_ns,
+            r.id, r.a, r.b, r.c);
+  fclose(file);
+  double ns = nsPerRow(start, rows.size());
+  printf("%-10s %12.1f %12.2f %8d\n", "csv", ns, fileSize(path) / 1048576.0,
+         1);
+}
+
+size_t queryCsv(const std::string &path, int64_t from, int64_t to) {
+  FILE *file = fopen(path.c_str(), "r");
+  int channel;
+  int64_t t;
+  char id[4];
+  float a, b, c;
+  size_t hits = 0;
+  while (fscanf(file, "%d,%" SCNd64 ",%3s,%f,%f,%f", &channel, &t, id, &a,
+                &b, &c) == 6)
+    if (channel == 1 && t >= from && t <= to)
+      hits++;
+  fclose(file);
+  return hits;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  int minutes = argc > 1 ? atoi(argv[1]) : 60;
+  std::string dir = argc > 2 ? argv[2] : "/tmp";
+  loguru::g_stderr_verbosity = loguru::Verbosity_WARNING;
+
+  int64_t origin = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       Clock::now().time_since_epoch())
+                       .count();
+  std::vector<Row> rows = flight(minutes, origin);
+  printf("flight=%d min, %zu rows\n", minutes, rows.size());
+  printf("%-10s %12s %12s %8s\n", "writer", "ns/row", "size_MiB", "files");
+
+  std::string prefix = dir + "/bench_telemetry";
+  std::string csv = dir + "/bench_telemetry.csv";
+  std::string log = dir + "/bench_telemetry.log";
+  writeColumnar(prefix, rows);
+  writeLoguru(log, rows);
+  writeCsv(csv, rows);
+
+  // 随机 10 s 窗口的姿态查询
+  const int queries = 5;
+  const int64_t window = 10000000000ll;
+  std::mt19937_64 rng(7);
+  std::uniform_int_distribution<int64_t> offset(0, minutes * 60000000000ll -
+                                                       window);
+  std::vector<int64_t> starts;
+  for (int i = 0; i < queries; i++)
+    starts.push_back(origin + offset(rng));
+
+  printf("\n%d queries of a 10 s attitude window\n", queries);
+  printf("%-10s %12s %10s %14s\n", "reader", "ms/query", "rows",
+         "mapped_KiB/q");
+
+  TelemetryReader reader;
+  reader.open(prefix);
+  Clock::time_point start = Clock::now();
+  size_t hits = 0;
+  for (int64_t from : starts) {
+    std::vector<TelemetryAttitudeRow> result;
+    hits += reader.attitude(from, from + window, result);
+  }
+  double ms = std::chrono::duration<double, std::milli>(Clock::now() - start)
+                  .count() /
+              queries;
+  printf("%-10s %12.3f %10zu %14.1f\n", "columnar", ms, hits / queries,
+         reader.mappedBytes() / 1024.0 / queries);
+
+  start = Clock::now();
+  hits = 0;
+  for (int64_t from : starts)
+    hits += queryCsv(csv, from, from + window);
+  ms = std::chrono::duration<double, std::milli>(Clock::now() - start)
+           .count() /
+       queries;
+  printf("%-10s %12.3f %10zu %14.1f\n", "csv scan", ms, hits / queries,
+         fileSize(csv) / 1024.0);
+
+  reader.close();
+  for (uint32_t i = 0;; i++)
+    if (remove(telemetryFilePath(prefix, i).c_str()) != 0)
+      break;
+  remove(csv.c_str());
+  remove(log.c_str());
+  return 0;
+}
@@ -0,0 +1,140 @@
+#include "c12_sim.h"
+#include "gimbal_ctrl.h"
+#include "gimbal_serial_transport.h"
+#ifdef GIMBAL_HAVE_IO_URING
+#include "gimbal_uring_transport.h"
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * 传输层基准：fork 出回环模拟器，以固定帧率提交异步拍照指令，
+ * 统计每条指令消耗的进程 CPU 时间 (不含模拟器) 与往返时延。
+ * serial 后端经 pty 对连接模拟器。
+ *
+ * 用法：bench_transport [seconds]
+ */
+
+namespace {
+double cpuSeconds() {
+  timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+std::unique_ptr<GimbalTransport> makeTransport(const std::string &name,
+                                               const std::string &device) {
+  if (name == "serial")
+    return std::make_unique<SerialTransport>(device);
+#ifdef GIMBAL_HAVE_IO_URING
+  if (name == "io_uring")
+    return std::make_unique<IoUringTransport>();
+#endif
+  return std::make_unique<UdpTransport>();
+}
+
+// serial 后端时 device 输出 pty 从端路径
+pid_t forkSimulator(const std::string &backend, uint16_t port,
+                    std::string &device) {
+  int master = -1;
+  if (backend == "serial") {
+    master = C12Simulator::openPty(device);
+    if (master < 0) {
+      perror("openpty");
+      exit(1);
+    }
+  }
+
+  return c12sim::forkLoopback(port, 0, master);
+}
+
+void runCase(const std::string &backend, int rate, double seconds,
+             uint16_t port) {
+  std::string device;
+  pid_t sim = forkSimulator(backend, port, device);
+
+  std::atomic<uint64_t> confirmed{0};
+  std::atomic<uint64_t> failed{0};
+  uint64_t sent = 0;
+  double cpu_used = 0;
+  double send_used = 0;
+  GimbalCtrl::LinkStats stats;
+
+  {
+    GimbalCtrl gimbal(makeTransport(backend, device), "127.0.0.1", port);
+    auto callback = [&](const GimbalCtrl::CommandRecord &record) {
+      if (record.state == GimbalCtrl::CommandState::CONFIRMED)
+        confirmed++;
+      else
+        failed++;
+    };
+
+    const uint64_t total = static_cast<uint64_t>(rate * seconds);
+    double cpu_start = cpuSeconds();
+    auto start = std::chrono::steady_clock::now();
+
+    // 按绝对时刻补发，避免累计漂移
+    while (sent < total) {
+      auto elapsed = std::chrono::steady_clock::now() - start;
+      uint64_t due = static_cast<uint64_t>(
+          std::chrono::duration<double>(elapsed).count() * rate);
+      if (due > total)
+        due = total;
+      for (; sent < due; sent++)
+        gimbal.capturePhotoAsync(callback);
+      if (sent < total)
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    send_used = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+
+    auto wait_until = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (confirmed + failed < sent &&
+           std::chrono::steady_clock::now() < wait_until)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    cpu_used = cpuSeconds() - cpu_start;
+    stats = gimbal.getLinkStats();
+  }
+
+  c12sim::stopLoopback(sim);
+
+  double mean_rtt =
+      stats.rtt_samples > 0 ? stats.rtt_sum_us / stats.rtt_samples : 0.0;
+  printf("%-9s %7d %9.0f %9lu %7lu %10.2f %10.1f %10.1f\n", backend.c_str(),
+         rate, sent / send_used, static_cast<unsigned long>(confirmed.load()),
+         static_cast<unsigned long>(failed.load()),
+         sent > 0 ? cpu_used * 1e6 / sent : 0.0, mean_rtt, stats.rtt_max_us);
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  double seconds = argc > 1 ? atof(argv[1]) : 1.0;
+  loguru::g_stderr_verbosity = loguru::Verbosity_WARNING;
+
+  std::vector<std::string> backends = {"udp", "serial"};
+#ifdef GIMBAL_HAVE_IO_URING
+  backends.push_back("io_uring");
+#endif
+  const int rates[] = {1000, 5000, 20000, 50000};
+
+  printf("%-9s %7s %9s %9s %7s %10s %10s %10s\n", "backend", "rate",
+         "achieved", "confirmed", "failed", "cpu_us/cmd", "rtt_mean",
+         "rtt_max");
+  uint16_t port = 15000;
+  for (const auto &backend : backends) {
+    for (int rate : rates)
+      runCase(backend, rate, seconds, port++);
+  }
+  return 0;
+}
@@ -0,0 +1,319 @@
+#include "c12_sim.h"
+
+#include "gimbal_serial_transport.h"
+#include "practical_socket/PracticalSocket.h"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+std::atomic<bool> g_loopback_running{true};
+
+void stopLoopbackSignal(int) { g_loopback_running = false; }
+
+// 串口写出整帧，pty 缓冲满时等待
+void writeAll(int fd, const std::string &data) {
+  size_t written = 0;
+  while (written < data.size()) {
+    ssize_t n = write(fd, data.data() + written, data.size() - written);
+    if (n > 0) {
+      written += static_cast<size_t>(n);
+      continue;
+    }
+    if (n < 0 && errno != EAGAIN && errno != EINTR)
+      return; // 对端已关闭
+    pollfd pfd{fd, POLLOUT, 0};
+    if (::poll(&pfd, 1, 100) <= 0)
+      return;
+  }
+}
+} // namespace
+
+C12Simulator::C12Simulator(uint16_t port, const std::string &version,
+                           const std::string &bind_ip)
+    : port_(port), version_(version), bind_ip_(bind_ip) {}
+
+std::string C12Simulator::seal(const std::string &body) {
+  uint8_t crc = 0;
+  for (char c : body)
+    crc += static_cast<uint8_t>(c);
+  char hex[3];
+  snprintf(hex, sizeof(hex), "%02X", crc);
+  return body + hex;
+}
+
+std::string C12Simulator::attitudeFrame() const {
+  uint16_t raw[3];
+  for (size_t i = 0; i < axes_.size(); i++)
+    raw[i] = static_cast<uint16_t>(
+        static_cast<int16_t>(std::lround(axes_[i].position * 100.0)));
+  char data[13];
+  snprintf(data, sizeof(data), "%04X%04X%04X", raw[0], raw[1], raw[2]);
+  return seal(std::string("#TPUGCrGAC") + data);
+}
+
+void C12Simulator::advance(std::chrono::steady_clock::time_point now) {
+  if (advanced_at_ == std::chrono::steady_clock::time_point{}) {
+    advanced_at_ = now;
+    return;
+  }
+  double elapsed = std::chrono::duration<double>(now - advanced_at_).count();
+  advanced_at_ = now;
+  // 以不超过 1 ms 的步长积分，停顿过久时只补最近 100 ms
+  elapsed = std::min(elapsed, 0.1);
+  while (elapsed > 0.0) {
+    double dt = std::min(elapsed, 0.001);
+    for (Axis &axis : axes_)
+      step(axis, dt);
+    elapsed -= dt;
+  }
+}
+
+void C12Simulator::step(Axis &axis, double dt) {
+  double accel;
+  if (axis.rate_mode) {
+    accel = (axis.rate_command - axis.rate) / kRateLag;
+  } else {
+    accel = kAngleLoopOmega * kAngleLoopOmega *
+                (axis.target - axis.position) -
+            2.0 * kAngleLoopDamping * kAngleLoopOmega * axis.rate;
+  }
+  accel = std::max(-kMaxAccel, std::min(kMaxAccel, accel));
+  axis.rate += accel * dt;
+  if (!axis.rate_mode)
+    axis.rate = std::max(-axis.max_rate, std::min(axis.max_rate, axis.rate));
+  axis.position += axis.rate * dt;
+}
+
+bool C12Simulator::respond(std::string_view frame, std::string &reply) {
+  if (frame.size() < 12 ||
+      (frame.compare(0, 3, "#TP") != 0 && frame.compare(0, 3, "#tp") != 0))
+    return false;
+
+  std::string_view body = frame.substr(0, frame.size() - 2);
+  std::string_view ident = frame.substr(7, 3);
+  std::string_view data = body.substr(10);
+  char ctrl = frame[6];
+
+  // 应答交换源/目的地址
+  std::string head(frame.substr(0, 3));
+  head += frame[4];
+  head += frame[3];
+
+  if (ctrl == 'r') {
+    if (ident == "VER") {
+      reply = seal("#tp" + head.substr(3) + "6rVER" + version_);
+      return true;
+    }
+    if (ident == "REC") {
+      reply = seal(head + "2rREC" + (recording_ ? "01" : "00"));
+      return true;
+    }
+    if (ident == "IPV" || ident == "GTW") {
+      const std::string &value = ident == "IPV" ? ip_ : gateway_;
+      char len[2];
+      snprintf(len, sizeof(len), "%X", static_cast<int>(value.size() & 0x0F));
+      reply = seal("#tp" + head.substr(3) + len + "r" + std::string(ident) +
+                   value);
+      return true;
+    }
+    reply = seal(head + std::string(body.substr(5)));
+    return true;
+  }
+
+  if (ident == "REC" && data.size() >= 2) {
+    if (data == "01")
+      recording_ = true;
+    else if (data == "00")
+      recording_ = false;
+    else if (data == "0A")
+      recording_ = !recording_;
+  } else if (ident == "IPV") {
+    ip_ = std::string(data);
+  } else if (ident == "GTW") {
+    gateway_ = std::string(data);
+  } else if ((ident == "GSY" || ident == "GSP") && data.size() >= 2) {
+    // 速率单位 0.5 deg/s
+    Axis &axis = axes_[ident == "GSY" ? 0 : 1];
+    axis.rate_mode = true;
+    axis.rate_command =
+        static_cast<int8_t>(std::stoi(std::string(data.substr(0, 2)), nullptr,
+                                      16)) *
+        0.5;
+  } else if ((ident == "GAY" || ident == "GAP" || ident == "GAR") &&
+             data.size() >= 6) {
+    Axis &axis = axes_[ident == "GAY" ? 0 : ident == "GAP" ? 1 : 2];
+    int16_t angle = static_cast<int16_t>(
+        std::stoi(std::string(data.substr(0, 4)), nullptr, 16));
+    int speed = std::stoi(std::string(data.substr(4, 2)), nullptr, 16);
+    axis.rate_mode = false;
+    axis.target = angle / 100.0;
+    axis.max_rate = std::max(1, speed) * kAngleRatePerSpeed;
+  } else if (ident == "GAA" && data.size() >= 2) {
+    attitude_hz_ = std::stoi(std::string(data.substr(0, 2)), nullptr, 16);
+    if (attitude_hz_ > 100)
+      attitude_hz_ = 100;
+  }
+
+  reply = seal(head + std::string(body.substr(5)));
+  return true;
+}
+
+void C12Simulator::run(const std::atomic<bool> &running) {
+  UDPSocket sock = bind_ip_.empty() ? UDPSocket(port_)
+                                     : UDPSocket(bind_ip_, port_);
+  std::string peer_ip;
+  uint16_t peer_port = 0;
+  std::string reply;
+  auto next_push = std::chrono::steady_clock::now();
+  // 延迟发送的 CAP 应答，按到期时间排列
+  struct Delayed {
+    std::chrono::steady_clock::time_point due;
+    std::string frame;
+  };
+  std::deque<Delayed> delayed;
+
+  while (running) {
+    bool readable = false;
+    try {
+      readable = sock.poll(1);
+    } catch (SocketException &) {
+      continue; // 信号打断，回到循环检查 running
+    }
+    if (readable) {
+      // 批量收取，保证高帧率下不成为瓶颈
+      sock.drain([&](const char *data, int len, const sockaddr_in &source) {
+        if (!respond(std::string_view(data, len), reply))
+          return;
+        char ip[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &source.sin_addr, ip, sizeof(ip));
+        peer_ip = ip;
+        peer_port = ntohs(source.sin_port);
+        if (capture_latency_ms_ > 0 && len >= 10 &&
+            std::string_view(data + 7, 3) == "CAP") {
+          delayed.push_back(
+              {std::chrono::steady_clock::now() +
+                   std::chrono::milliseconds(capture_latency_ms_),
+               reply});
+          return;
+        }
+        sock.sendTo(reply.data(), static_cast<int>(reply.size()), peer_ip,
+                    peer_port);
+      });
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    while (!delayed.empty() && delayed.front().due <= now) {
+      const std::string &frame = delayed.front().frame;
+      sock.sendTo(frame.data(), static_cast<int>(frame.size()), peer_ip,
+                  peer_port);
+      delayed.pop_front();
+    }
+    advance(now);
+    if (attitude_hz_ > 0 && peer_port != 0) {
+      if (now >= next_push) {
+        std::string frame = attitudeFrame();
+        sock.sendTo(frame.data(), static_cast<int>(frame.size()), peer_ip,
+                    peer_port);
+        next_push = now + std::chrono::microseconds(1000000 / attitude_hz_);
+      }
+    }
+  }
+}
+
+void C12Simulator::runSerial(int fd, const std::atomic<bool> &running) {
+  FrameAssembler assembler;
+  std::string frame;
+  std::string reply;
+  char buf[4096];
+  auto next_push = std::chrono::steady_clock::now();
+
+  while (running) {
+    pollfd pfd{fd, POLLIN, 0};
+    if (::poll(&pfd, 1, 1) > 0 && (pfd.revents & POLLIN)) {
+      ssize_t n;
+      while ((n = read(fd, buf, sizeof(buf))) > 0)
+        assembler.append(buf, static_cast<size_t>(n));
+      while (assembler.next(frame)) {
+        if (respond(frame, reply))
+          writeAll(fd, reply);
+      }
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    advance(now);
+    if (attitude_hz_ > 0) {
+      if (now >= next_push) {
+        writeAll(fd, attitudeFrame());
+        next_push = now + std::chrono::microseconds(1000000 / attitude_hz_);
+      }
+    }
+  }
+}
+
+int C12Simulator::openPty(std::string &slave_path) {
+  int fd = posix_openpt(O_RDWR | O_NOCTTY);
+  if (fd < 0)
+    return -1;
+  if (grantpt(fd) < 0 || unlockpt(fd) < 0) {
+    close(fd);
+    return -1;
+  }
+  const char *name = ptsname(fd);
+  if (name == nullptr) {
+    close(fd);
+    return -1;
+  }
+  slave_path = name;
+
+  // 主端同样置为原始模式，避免行规程改写帧内容
+  termios tio;
+  if (tcgetattr(fd, &tio) == 0) {
+    cfmakeraw(&tio);
+    tcsetattr(fd, TCSANOW, &tio);
+  }
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+  return fd;
+}
+
+namespace c12sim {
+pid_t forkLoopback(uint16_t port, int capture_latency_ms, int serial_fd) {
+  pid_t pid = fork();
+  if (pid == 0) {
+    signal(SIGTERM, stopLoopbackSignal);
+    C12Simulator sim(port);
+    sim.setCaptureLatency(capture_latency_ms);
+    if (serial_fd >= 0)
+      sim.runSerial(serial_fd, g_loopback_running);
+    else
+      sim.run(g_loopback_running);
+    _exit(0);
+  }
+  if (serial_fd >= 0)
+    close(serial_fd);
+  // 等待模拟器绑定端口
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  return pid;
+}
+
+void stopLoopback(pid_t pid) {
+  if (pid <= 0)
+    return;
+  kill(pid, SIGTERM);
+  waitpid(pid, nullptr, 0);
+}
+} // namespace c12sim
@@ -0,0 +1,119 @@
+#ifndef __C12_SIM_H__
+#define __C12_SIM_H__
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <sys/types.h>
+
+/**
+ * @brief C12 云台回环模拟器，用于基准测试与联调
+ *
+ * 按协议回显写指令 (交换源/目的地址)，应答 VER/REC 读指令，
+ * 收到 GAA 后按设定频率推送 GAC 姿态帧。
+ *
+ * 姿态由简化的云台动力学给出，用于对比运动控制方式：
+ * - GSY/GSP 速率模式：速度以一阶惯性跟随指令 (时间常数 kRateLag)
+ * - GAY/GAP/GAR 角度模式 (固件内置运动)：欠阻尼的位置环，
+ *   速度上限为速度参数 x kAngleRatePerSpeed
+ * 两种模式的加速度均不超过 kMaxAccel。
+ */
+class C12Simulator {
+public:
+  static constexpr double kMaxAccel = 200.0;         // deg/s^2
+  static constexpr double kRateLag = 0.03;           // s
+  static constexpr double kAngleRatePerSpeed = 0.6;  // deg/s 每单位速度参数
+  static constexpr double kAngleLoopOmega = 8.0;     // rad/s
+  static constexpr double kAngleLoopDamping = 0.55;
+
+  /**
+   * @param port 监听端口
+   * @param version VER 应答中的版本
+   * @param bind_ip 监听地址，为空时监听所有地址；多个模拟器可分别绑定
+   * 127.0.0.x 模拟同一网段内的多台云台
+   */
+  explicit C12Simulator(uint16_t port = 5000,
+                        const std::string &version = "V1.0.0",
+                        const std::string &bind_ip = "");
+
+  /**
+   * @brief 生成一帧指令的应答
+   *
+   * @param frame
+   * @param reply 输出应答帧
+   * @return true 有应答
+   * @return false 帧无效或无需应答
+   */
+  bool respond(std::string_view frame, std::string &reply);
+
+  // 在当前线程上运行 UDP 服务，running 置 false 后返回
+  void run(const std::atomic<bool> &running);
+
+  // CAP 应答延迟，模拟相机出图耗时 (仅 UDP 服务)
+  void setCaptureLatency(int latency_ms) { capture_latency_ms_ = latency_ms; }
+
+  // 在当前线程上服务串口 (pty 主端或真实串口)，running 置 false 后返回
+  void runSerial(int fd, const std::atomic<bool> &running);
+
+  /**
+   * @brief 创建 pty 对，供 SerialTransport 在本机联调
+   *
+   * @param slave_path 输出从端路径，交给 SerialTransport 打开
+   * @return int 主端描述符 (非阻塞)，交给 runSerial；失败返回 -1
+   */
+  static int openPty(std::string &slave_path);
+
+  // 生成一帧 GAC 姿态帧
+  std::string attitudeFrame() const;
+
+  static std::string seal(const std::string &body);
+
+  // 推进动力学到 now，run/runSerial 每轮调用；直接使用 respond 时由调用方推进
+  void advance(std::chrono::steady_clock::time_point now);
+
+private:
+  // 单轴状态，角度与速度单位为 deg、deg/s
+  struct Axis {
+    double position = 0.0;
+    double rate = 0.0;
+    bool rate_mode = true;
+    double rate_command = 0.0;
+    double target = 0.0;
+    double max_rate = 0.0;
+  };
+
+  void step(Axis &axis, double dt);
+
+  uint16_t port_;
+  std::string version_;
+  std::string bind_ip_;
+  std::string ip_ = "192.168.144.108";
+  std::string gateway_ = "192.168.144.1";
+  bool recording_ = false;
+  int attitude_hz_ = 0;
+  int capture_latency_ms_ = 0;
+  std::array<Axis, 3> axes_{}; // yaw, pitch, roll
+  std::chrono::steady_clock::time_point advanced_at_{};
+};
+
+namespace c12sim {
+/**
+ * @brief fork 出运行模拟器的子进程，等待其绑定端口后返回
+ * 子进程收到 SIGTERM 后退出，由 stopLoopback 终止并回收
+ *
+ * @param port 监听端口
+ * @param capture_latency_ms CAP 应答延迟
+ * @param serial_fd 不小于 0 时服务该串口 (openPty 的主端) 而不是 UDP，
+ * 父进程中的副本在返回前关闭
+ * @return pid_t 子进程号，fork 失败返回 -1
+ */
+pid_t forkLoopback(uint16_t port, int capture_latency_ms = 0,
+                   int serial_fd = -1);
+
+void stopLoopback(pid_t pid);
+} // namespace c12sim
+
+#endif
@@ -0,0 +1,45 @@
+#include "c12_sim.h"
+
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+namespace {
+std::atomic<bool> g_running{true};
+
+void onSignal(int) { g_running = false; }
+} // namespace
+
+// 用法：c12_sim [port] [version] [bind_ip]
+//       c12_sim --pty [version]  创建 pty 对，在主端提供串口服务
+int main(int argc, char *argv[]) {
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+
+  if (argc > 1 && strcmp(argv[1], "--pty") == 0) {
+    std::string slave;
+    int fd = C12Simulator::openPty(slave);
+    if (fd < 0) {
+      perror("openpty");
+      return 1;
+    }
+    printf("C12 simulator serving serial on %s\n", slave.c_str());
+    fflush(stdout);
+    C12Simulator sim(0, argc > 2 ? argv[2] : "V1.0.0");
+    sim.runSerial(fd, g_running);
+    close(fd);
+    return 0;
+  }
+
+  uint16_t port = argc > 1 ? static_cast<uint16_t>(atoi(argv[1])) : 5000;
+  std::string version = argc > 2 ? argv[2] : "V1.0.0";
+  std::string bind_ip = argc > 3 ? argv[3] : "";
+
+  printf("C12 simulator listening on udp/%u\n", port);
+  C12Simulator sim(port, version, bind_ip);
+  sim.run(g_running);
+  return 0;
+}
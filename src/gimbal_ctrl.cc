@@ -1,24 +1,323 @@
 #include "gimbal_ctrl.h"
+#include "gimbal_pointing.h"
+#include "gimbal_protocol.h"
+#include "gimbal_shm.h"
+#include "gimbal_telemetry.h"
 
+#include <algorithm>
 #include <arpa/inet.h>
+#include <cerrno>
+#include <cmath>
+#include <csignal>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
+#include <fstream>
 #include <functional>
+#include <future>
 #include <iomanip>
 #include <iostream>
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #include <vector>
 
+namespace {
+// 已完成指令记录的保留数量，供 pollCommand 查询
+constexpr size_t kCompletedHistory = 256;
+// 接收缓冲池槽位数：覆盖已完成记录、待确认指令与调用方持有的回包
+constexpr size_t kRxPoolSlots = 1024;
+// 接收线程轮询周期，同时决定超时检测精度
+constexpr int kRxPollMs = 10;
+// 保留的内核发送时间戳数量
+constexpr size_t kTxStampHistory = 256;
+
+// 接收线程每次系统调用最多取出的数据报数
+constexpr unsigned int kRxBatch = 32;
+// 姿态历史的默认内存预算：2048 个槽位，100 Hz 下约 20 s
+constexpr size_t kHistoryBytes = 64 * 1024;
+
+double elapsedUs(const timespec &from, const timespec &to) {
+  return (to.tv_sec - from.tv_sec) * 1e6 + (to.tv_nsec - from.tv_nsec) / 1e3;
+}
+
+// 解析定长十六进制字段，非法字符返回 false
+bool parseHex(std::string_view field, uint32_t &value) {
+  value = 0;
+  for (char c : field) {
+    value <<= 4;
+    if (c >= '0' && c <= '9')
+      value |= c - '0';
+    else if (c >= 'A' && c <= 'F')
+      value |= c - 'A' + 10;
+    else if (c >= 'a' && c <= 'f')
+      value |= c - 'a' + 10;
+    else
+      return false;
+  }
+  return true;
+}
+
+std::string addressString(const sockaddr_in &addr) {
+  char buf[INET_ADDRSTRLEN];
+  inet_ntop(AF_INET, &addr.sin_addr, buf, sizeof(buf));
+  return buf;
+}
+
+// 回包是否来自 host；串口等无源地址的链路、非数字地址不作区分
+bool fromHost(const sockaddr_in &source, const std::string &host) {
+  in_addr addr{};
+  if (source.sin_addr.s_addr == 0 ||
+      inet_pton(AF_INET, host.c_str(), &addr) != 1)
+    return true;
+  return addr.s_addr == source.sin_addr.s_addr;
+}
+
+// 帧的数据位：标识位之后、校验位之前
+std::string_view frameData(std::string_view frame) {
+  if (frame.size() < 12)
+    return {};
+  return frame.substr(10, frame.size() - 12);
+}
+
+// 启动探测读取的能力项，均为 #TPUD2r<标识位>00 形式的读指令
+constexpr tp::Id kProbeIdentifiers[] = {tp::Id::VER, tp::Id::UID, tp::Id::VID,
+                                        tp::Id::EXT, tp::Id::TAS};
+
+// GSY/GSP 速率指令单位 0.5 deg/s，有符号 1 字节
+constexpr float kRateUnit = 0.5f;
+constexpr int kMaxStreamCode = 127;
+constexpr float kMaxStreamRate = kMaxStreamCode * kRateUnit;
+// 规划运动结束时锁定角度所用的速度参数
+constexpr uint8_t kLockSpeed = 100;
+
+/**
+ * @brief 流式速率指令：曲线速度前馈 + feedback_gain x (曲线位置 - 预测姿态)
+ *
+ * @param t 曲线内的采样时刻，已计入 lead_ms
+ * @param start 曲线起点角度
+ * @param predicted 指令生效时的预测姿态
+ * @param error 输出，曲线位置与预测姿态之差
+ * @return uint8_t GSY/GSP 数据位
+ */
+uint8_t streamRate(const GimbalCtrl::MotionParams &params,
+                   const MotionProfile &profile, double t, float start,
+                   float predicted, float &error) {
+  double position, rate;
+  profile.sample(t, position, rate);
+  error = static_cast<float>(start + position - predicted);
+  double command = rate + params.feedback_gain * error;
+  command = std::max<double>(-params.max_rate,
+                             std::min<double>(params.max_rate, command));
+  return static_cast<uint8_t>(
+      static_cast<int8_t>(std::lround(command / kRateUnit)));
+}
+
+// 同步写指令的等待时间，由协议描述表给出
+template <tp::Id I> constexpr int waitMs() {
+  return tp::describe(I).timeout_ms;
+}
+
+/**
+ * @brief 从缓存文件读取指定云台的信息
+ * 每行一台：<ip>:<port> VER=V1.0.0 UID=00000001 ...
+ */
+bool loadUnitCache(const std::string &path, const std::string &key,
+                   GimbalCtrl::UnitInfo &info) {
+  std::ifstream file(path);
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream fields(line);
+    std::string unit;
+    if (!(fields >> unit) || unit != key)
+      continue;
+
+    std::string field;
+    while (fields >> field) {
+      size_t eq = field.find('=');
+      if (eq == std::string::npos)
+        continue;
+      info.capabilities[field.substr(0, eq)] = field.substr(eq + 1);
+    }
+    auto it = info.capabilities.find("VER");
+    if (it == info.capabilities.end() || it->second.empty())
+      return false;
+    info.firmware = it->second;
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief 写入指定云台的信息，保留其他云台的行；先写临时文件再改名
+ */
+bool saveUnitCache(const std::string &path, const std::string &key,
+                   const GimbalCtrl::UnitInfo &info) {
+  std::vector<std::string> lines;
+  {
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+      if (line.compare(0, key.size() + 1, key + " ") != 0 && !line.empty())
+        lines.push_back(line);
+    }
+  }
+
+  std::ostringstream entry;
+  entry << key;
+  for (const auto &item : info.capabilities) {
+    // 数据位为协议字符，不含空白；含空白的值不写入以免破坏格式
+    if (item.second.find_first_of(" \t\r\n") == std::string::npos)
+      entry << ' ' << item.first << '=' << item.second;
+  }
+  lines.push_back(entry.str());
+
+  std::string tmp = path + ".tmp";
+  {
+    std::ofstream file(tmp, std::ios::trunc);
+    for (const auto &line : lines)
+      file << line << '\n';
+    if (!file)
+      return false;
+  }
+  return rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+/**
+ * @brief 判断已存在的共享内存段是否为已退出写端遗留
+ * 仅当段已初始化且记录的写端进程不存在时视为遗留；未初始化的段可能正由
+ * 其他写端创建，按占用处理
+ *
+ * @param writer_pid 输出段内记录的写端进程号，无法读取时为 0
+ */
+bool staleSegment(const std::string &name, uint32_t &writer_pid) {
+  writer_pid = 0;
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0)
+    return false;
+  struct stat st;
+  void *addr = MAP_FAILED;
+  if (fstat(fd, &st) == 0 &&
+      st.st_size >= static_cast<off_t>(sizeof(GimbalShmSegment)))
+    addr = mmap(nullptr, sizeof(GimbalShmSegment), PROT_READ, MAP_SHARED, fd,
+                0);
+  close(fd);
+  if (addr == MAP_FAILED)
+    return false;
+
+  const auto *segment = static_cast<const GimbalShmSegment *>(addr);
+  bool ready = segment->magic == kGimbalShmMagic;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  writer_pid = segment->writer_pid;
+  munmap(addr, sizeof(GimbalShmSegment));
+  if (!ready || writer_pid == 0 ||
+      writer_pid == static_cast<uint32_t>(getpid()))
+    return false;
+  return kill(static_cast<pid_t>(writer_pid), 0) != 0 && errno == ESRCH;
+}
+
+// 状态缓存字的布局
+constexpr int kCacheStampBits = 40;
+constexpr uint64_t kCacheStampMask = (1ull << kCacheStampBits) - 1;
+
+uint64_t packCached(int32_t value, uint64_t stamp_ms) {
+  return (static_cast<uint64_t>(static_cast<uint32_t>(value) & 0xFFFFFF)
+          << kCacheStampBits) |
+         (stamp_ms & kCacheStampMask);
+}
+
+/**
+ * @brief 由标识位与数据位确定缓存字段与值，字段与载荷格式取自协议描述表
+ *
+ * @param id
+ * @param data 数据位 (十六进制字符)
+ * @param field 输出字段下标
+ * @param value 输出值，REC 切换指令返回 RecordState::TOGGLE 由调用方处理
+ * @return false 该指令不缓存
+ */
+bool cachedField(tp::Id id, std::string_view data, size_t &field,
+                 int32_t &value) {
+  if (id == tp::Id::COUNT)
+    return false;
+  const tp::Descriptor &desc = tp::describe(id);
+  if (desc.cache_field == tp::kNoCache)
+    return false;
+  field = static_cast<size_t>(desc.cache_field);
+
+  uint32_t raw;
+  if (desc.payload == tp::Payload::ANGLE) {
+    if (data.size() < 4 || !parseHex(data.substr(0, 4), raw))
+      return false;
+    value = static_cast<int16_t>(raw);
+    return true;
+  }
+
+  if (data.size() < 2 || !parseHex(data.substr(0, 2), raw))
+    return false;
+  value = static_cast<int32_t>(raw);
+
+  switch (id) {
+  case tp::Id::REC:
+    return raw <= 0x01 ||
+           raw == static_cast<uint32_t>(GimbalCtrl::RecordState::TOGGLE);
+  case tp::Id::DZM:
+    // 放大/缩小为相对指令，不改变已知档位
+    return raw <= static_cast<uint32_t>(GimbalCtrl::ZoomMode::ZOOM_4X);
+  case tp::Id::PTZ:
+    // PTZ 与云台动作共用标识位，仅安装模式入缓存
+    return raw == static_cast<uint32_t>(GimbalCtrl::InstallMode::LIFT) ||
+           raw == static_cast<uint32_t>(GimbalCtrl::InstallMode::REVERSE);
+  default:
+    return true;
+  }
+}
+
+static_assert(tp::field::RECORDING ==
+                      static_cast<int8_t>(GimbalCtrl::StateField::RECORDING) &&
+                  tp::field::ROLL_TARGET ==
+                      static_cast<int8_t>(GimbalCtrl::StateField::ROLL_TARGET),
+              "tp::field must match GimbalCtrl::StateField");
+
+int64_t steadyNs(std::chrono::steady_clock::time_point t) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             t.time_since_epoch())
+      .count();
+}
+} // namespace
+
 GimbalCtrl::GimbalCtrl(const std::string &target_ip, uint16_t port)
-    : target_ip_(target_ip), port_(port) {
-  LOG_F(INFO, "GimbalCtrl init [ip]:%s [port]:%d", target_ip_.c_str(), port_);
+    : GimbalCtrl(std::make_unique<UdpTransport>(kRxBatch), target_ip, port) {}
+
+GimbalCtrl::GimbalCtrl(std::unique_ptr<GimbalTransport> transport,
+                       const std::string &target_ip, uint16_t port)
+    : transport_(std::move(transport)), target_ip_(target_ip), port_(port),
+      completed_(kCompletedHistory),
+      rx_pool_(RxBufferPool::create(kRxPoolSlots)) {
+  LOG_F(INFO, "GimbalCtrl init [ip]:%s [port]:%d [transport]:%s",
+        target_ip_.c_str(), port_, transport_->name());
+  histories_.push_back(std::make_unique<AttitudeHistory>(kHistoryBytes));
+  history_ = histories_.back().get();
+  running_ = true;
+  rx_thread_ = std::thread(&GimbalCtrl::rxLoop, this);
+  timer_ = std::make_unique<GimbalTimer>();
 }
 
-GimbalCtrl::~GimbalCtrl() {}
+GimbalCtrl::~GimbalCtrl() {
+  // 先停定时器，周期任务不再发帧
+  timer_.reset();
+  running_ = false;
+  if (rx_thread_.joinable())
+    rx_thread_.join();
+  disableSharedState();
+  disableTelemetryLog();
+  // 调用方仍持有的回包引用在释放时归还，最后一个引用释放后缓冲池销毁
+  rx_pool_->release();
+}
 
 // 云台基础控制
 bool GimbalCtrl::controlGimbal(GimbalAction action) {
@@ -30,9 +329,12 @@ bool GimbalCtrl::controlGimbal(GimbalAction action) {
 
 bool GimbalCtrl::setGimbalAngle(float yaw_angle, float pitch_angle,
                                 float roll_angle, float speed) {
-  yaw_angle = std::max(-90.0f, std::min(90.0f, yaw_angle));
-  pitch_angle = std::max(-90.0f, std::min(90.0f, pitch_angle));
-  roll_angle = std::max(-90.0f, std::min(90.0f, roll_angle));
+  yaw_angle =
+      std::max(-kGimbalAngleLimit, std::min(kGimbalAngleLimit, yaw_angle));
+  pitch_angle =
+      std::max(-kGimbalAngleLimit, std::min(kGimbalAngleLimit, pitch_angle));
+  roll_angle =
+      std::max(-kGimbalAngleLimit, std::min(kGimbalAngleLimit, roll_angle));
   speed = std::max(0.0f, std::min(100.0f, speed));
 
   int16_t yaw = static_cast<int16_t>(yaw_angle * 100);
@@ -40,81 +342,756 @@ bool GimbalCtrl::setGimbalAngle(float yaw_angle, float pitch_angle,
   int16_t roll = static_cast<int16_t>(roll_angle * 100);
   uint8_t _speed = static_cast<uint8_t>(speed); // TODO 确定是否需要 x10
 
-  // 先设置 yaw 角度
-  vector<uint8_t> data_buf = {
-      static_cast<uint8_t>((yaw >> 8) & 0xFF),
-      static_cast<uint8_t>(yaw & 0xFF),
-      static_cast<uint8_t>(_speed),
-  };
-  bool yaw_rtn = send(buildDynamicCommand("U", "G", 'w', "GAY", data_buf), -1);
-
-  // 再设置 pitch 角度
-  data_buf.assign(3, 0);
-  data_buf = {
-      static_cast<uint8_t>((pitch >> 8) & 0xFF),
-      static_cast<uint8_t>(pitch & 0xFF),
-      static_cast<uint8_t>(_speed),
-  };
+  // 先设置 yaw 角度，再设置 pitch，最后设置 roll
+  bool yaw_rtn =
+      send(tp::encodeWrite<tp::Id::GAY>(yaw, _speed), waitMs<tp::Id::GAY>());
   bool pitch_rtn =
-      send(buildDynamicCommand("U", "G", 'w', "GAP", data_buf), -1);
-
-  // 最后设置 roll 角度
-  data_buf.assign(3, 0);
-  data_buf = {
-      static_cast<uint8_t>((roll >> 8) & 0xFF),
-      static_cast<uint8_t>(roll & 0xFF),
-      static_cast<uint8_t>(_speed),
-  };
-  bool roll_rtn = send(buildDynamicCommand("U", "G", 'w', "GAR", data_buf), -1);
+      send(tp::encodeWrite<tp::Id::GAP>(pitch, _speed), waitMs<tp::Id::GAP>());
+  bool roll_rtn =
+      send(tp::encodeWrite<tp::Id::GAR>(roll, _speed), waitMs<tp::Id::GAR>());
 
   return yaw_rtn && pitch_rtn && roll_rtn;
 }
 
-// 云台速度控制 (单位：0.1 deg/s)
+/**
+ * @brief 设定两轴速率并进入速率模式
+ *
+ * 定时器线程每 period_ms 一拍：累计上一拍下发速率与设定速率之差的积分
+ * (位置误差 e)，本拍下发 round((设定速率 + e / 周期) / 0.5) 个单位，
+ * 使 e 始终在 +/-0.5 deg/s x 周期 / 2 以内。量化值与上一拍相同时不重发，
+ * 只按 refresh_ms 保活；超过 feed_timeout_ms 未再调用则自动停止。
+ * 已在速率模式中时只更新设定值，累计误差保留。
+ *
+ * @param yaw_speed 航向速率 (deg/s)，限制在 +/-63.5
+ * @param pitch_speed 俯仰速率 (deg/s)，限制在 +/-63.5
+ * @return false 链路断开或零速率指令发送失败
+ */
 bool GimbalCtrl::setGimbalSpeed(float yaw_speed, float pitch_speed) {
-  // 限制速度范围 (-127.0 ~ +127.0)
-  yaw_speed = std::max(-127.0f, std::min(127.0f, yaw_speed));
-  pitch_speed = std::max(-127.0f, std::min(127.0f, pitch_speed));
-
-  // 转换为协议格式 (0.5deg/s 单位)
-  int8_t yaw = static_cast<int8_t>(yaw_speed * 2);
-  int8_t pitch = static_cast<int8_t>(pitch_speed * 2);
-
-  // std::string yaw_data = hexEncode(yaw, 2);
-  // std::string pitch_data = hexEncode(pitch, 2);
-
-  //   分别发送航向和俯仰速度指令
-  //   bool yaw_ok = send(buildCommand("U", "G", 'w', "GSY", yaw_data));
-  //   bool pitch_ok = send(buildCommand("U", "G", 'w', "GSP", pitch_data));
-
-  bool yaw_ok = send(
-      buildStaticCommand("U", "G", 'w', "GSY", {static_cast<uint8_t>(yaw)}),
-      -1);
-  bool pitch_ok = send(
-      buildStaticCommand("U", "G", 'w', "GSP", {static_cast<uint8_t>(pitch)}),
-      -1);
-
-  //   return yaw_ok && pitch_ok;
-  //   return yaw_ok;
+  yaw_speed = std::max(-kMaxStreamRate, std::min(kMaxStreamRate, yaw_speed));
+  pitch_speed =
+      std::max(-kMaxStreamRate, std::min(kMaxStreamRate, pitch_speed));
+
+  if (yaw_speed == 0.0f && pitch_speed == 0.0f) {
+    // 停止指令同时中止规划运动与扫描，否则其下一拍会重新下发速率
+    cancelMotion();
+    cancelScan();
+    cancelSpeed();
+    bool yaw_ok = stream(tp::encodeWrite<tp::Id::GSY>(0));
+    bool pitch_ok = stream(tp::encodeWrite<tp::Id::GSP>(0));
+    return yaw_ok && pitch_ok;
+  }
+  if (getLinkState() == LinkState::DOWN) {
+    LOG_F(ERROR, "setGimbalSpeed: link down");
+    return false;
+  }
+
+  cancelMotion();
+  cancelScan();
+
+  Clock::time_point now = Clock::now();
+  {
+    std::lock_guard<std::mutex> lock(motion_mutex_);
+    if (speed_status_.active && speed_run_.generation == motion_generation_) {
+      speed_status_.yaw_rate = yaw_speed;
+      speed_status_.pitch_rate = pitch_speed;
+      speed_status_.fed_at = now;
+      return true;
+    }
+    speed_status_ = SpeedStatus();
+    speed_status_.active = true;
+    speed_status_.yaw_rate = yaw_speed;
+    speed_status_.pitch_rate = pitch_speed;
+    speed_status_.started_at = now;
+    speed_status_.fed_at = now;
+    speed_run_ = SpeedRun();
+    for (RateModulator &modulator : speed_run_.modulator)
+      modulator = RateModulator(kRateUnit, motion_params_.period_ms / 1000.0,
+                                kMaxStreamCode);
+    uint32_t generation = ++motion_generation_;
+    speed_run_.generation = generation;
+    speed_task_ = timer_->schedule(
+        now, std::chrono::milliseconds(motion_params_.period_ms),
+        [this, generation](Clock::time_point deadline) {
+          return speedTick(deadline, generation);
+        });
+  }
+
+  LOG_F(INFO, "setGimbalSpeed: (%.3f, %.3f) deg/s", yaw_speed, pitch_speed);
+  return true;
+}
+
+GimbalCtrl::SpeedStatus GimbalCtrl::getSpeedStatus() {
+  std::lock_guard<std::mutex> lock(motion_mutex_);
+  return speed_status_;
+}
+
+bool GimbalCtrl::cancelSpeed() {
+  GimbalTimer::TaskId task;
+  {
+    std::lock_guard<std::mutex> lock(motion_mutex_);
+    task = speed_task_;
+    speed_task_ = 0;
+  }
+  // 等待正在执行的一拍结束，不能持有 motion_mutex_
+  if (task != 0)
+    timer_->cancel(task);
+
+  std::lock_guard<std::mutex> lock(motion_mutex_);
+  bool active = speed_status_.active;
+  speed_status_.active = false;
+  return active;
+}
+
+/**
+ * @brief 速率模式的一拍，在定时器线程中执行
+ *
+ * @param deadline 本拍的计划时刻
+ * @param generation 启动时的 motion_generation_
+ * @return false 已退出速率模式，停止周期任务
+ */
+bool GimbalCtrl::speedTick(Clock::time_point deadline, uint32_t generation) {
+  std::string frames[2];
+  uint64_t refreshes = 0;
+  int starved_ms = 0;
+  {
+    std::lock_guard<std::mutex> lock(motion_mutex_);
+    SpeedStatus &status = speed_status_;
+    SpeedRun &run = speed_run_;
+    const MotionGuard &guard = motion_guard_;
+    if (!status.active || run.generation != generation)
+      return false;
+    // 并发启动的运动或扫描已取代速率模式
+    if (generation != motion_generation_) {
+      status.active = false;
+      speed_task_ = 0;
+      return false;
+    }
+
+    // 应用停止更新速率 (线程挂起或退出)：不再沿用最后的速率
+    if (guard.feed_timeout_ms > 0 &&
+        deadline - status.fed_at >
+            std::chrono::milliseconds(guard.feed_timeout_ms)) {
+      status.active = false;
+      speed_task_ = 0;
+      starved_ms = guard.feed_timeout_ms;
+    }
+
+    // 上一拍的速率作用到本拍的计划时刻；定时器跳过的周期同样计入
+    double dt = status.ticks == 0
+                    ? 0.0
+                    : std::chrono::duration<double>(deadline - run.last_tick)
+                          .count();
+    const float target[2] = {status.yaw_rate, status.pitch_rate};
+    float *error[2] = {&status.yaw_error, &status.pitch_error};
+    for (size_t axis = 0; axis < 2 && status.active; axis++) {
+      RateModulator &modulator = run.modulator[axis];
+      int last = modulator.code();
+      int code = modulator.step(target[axis], dt);
+      *error[axis] = static_cast<float>(modulator.error());
+      status.error_max = std::max(status.error_max, std::fabs(*error[axis]));
+      bool changed = status.ticks == 0 || run.resend || code != last;
+      // 量化值不变时云台沿用上一帧，按 refresh_ms 重发，丢包或云台复位后恢复
+      bool refresh = !changed && guard.refresh_ms > 0 &&
+                     deadline - run.sent_at[axis] >=
+                         std::chrono::milliseconds(guard.refresh_ms);
+      if (changed || refresh) {
+        uint8_t data = static_cast<uint8_t>(static_cast<int8_t>(code));
+        frames[axis] = axis == 0 ? tp::encodeWrite<tp::Id::GSY>(data)
+                                 : tp::encodeWrite<tp::Id::GSP>(data);
+        run.sent_at[axis] = deadline;
+        status.rate_commands++;
+        if (refresh)
+          refreshes++;
+      }
+    }
+    run.resend = false;
+    run.last_tick = deadline;
+    status.ticks++;
+  }
+
+  if (starved_ms > 0) {
+    LOG_F(WARNING, "setGimbalSpeed: no rate update for %d ms, stopping",
+          starved_ms);
+    stream(tp::encodeWrite<tp::Id::GSY>(0));
+    stream(tp::encodeWrite<tp::Id::GSP>(0));
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_.auto_stops++;
+    return false;
+  }
+  if (refreshes > 0) {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_.rate_refreshes += refreshes;
+  }
+
+  // 本拍计划时刻即请求时刻，定时器滞后超过期限的帧被丢弃，下一拍重发
+  bool sent = true;
+  for (const std::string &frame : frames)
+    if (!frame.empty() && !stream(frame, deadline))
+      sent = false;
+  if (!sent) {
+    std::lock_guard<std::mutex> lock(motion_mutex_);
+    speed_run_.resend = true;
+  }
+  return true;
+}
+
+void GimbalCtrl::setMotionParams(const MotionParams &params) {
+  std::lock_guard<std::mutex> lock(motion_mutex_);
+  motion_params_ = params;
+  motion_params_.max_rate =
+      std::max(kRateUnit, std::min(kMaxStreamRate, params.max_rate));
+  motion_params_.period_ms = std::max(1, params.period_ms);
+}
+
+void GimbalCtrl::setMotionGuard(const MotionGuard &guard) {
+  std::lock_guard<std::mutex> lock(motion_mutex_);
+  motion_guard_ = guard;
+  command_deadline_ms_.store(guard.command_deadline_ms,
+                             std::memory_order_relaxed);
+}
+
+/**
+ * @brief 规划并开始一段运动
+ *
+ * 由最近一帧姿态出发，两轴各自规划时间最优曲线后按较慢轴缩放，
+ * 在定时器线程上每 period_ms 下发一次 GSY/GSP：速率 = 超前 lead_ms 的
+ * 曲线速度 + feedback_gain x (曲线位置 - 姿态)。曲线结束时下发 GAY/GAP
+ * 锁定目标，姿态进入 lock_tolerance 后完成。进行中的运动、扫描或速率模式被取代。
+ *
+ * @param yaw_angle 目标航向角 (deg)
+ * @param pitch_angle 目标俯仰角 (deg)
+ * @return false 无近期姿态 (未开启 GAA 输出) 或链路断开
+ */
+bool GimbalCtrl::moveGimbal(float yaw_angle, float pitch_angle) {
+  yaw_angle =
+      std::max(-kGimbalAngleLimit, std::min(kGimbalAngleLimit, yaw_angle));
+  pitch_angle =
+      std::max(-kGimbalAngleLimit, std::min(kGimbalAngleLimit, pitch_angle));
+
+  Clock::time_point now = Clock::now();
+  Attitude attitude = getAttitude();
+  if (attitude.stamp == Clock::time_point{} ||
+      now - attitude.stamp > std::chrono::milliseconds(500)) {
+    LOG_F(ERROR, "moveGimbal: no recent attitude, enable attitude output");
+    return false;
+  }
+  if (getLinkState() == LinkState::DOWN) {
+    LOG_F(ERROR, "moveGimbal: link down");
+    return false;
+  }
+
+  cancelScan();
+  cancelSpeed();
+  cancelMotion();
+
+  double duration;
+  {
+    std::lock_guard<std::mutex> lock(motion_mutex_);
+    const MotionParams &params = motion_params_;
+    MotionRun run;
+    run.yaw_start = attitude.yaw;
+    run.pitch_start = attitude.pitch;
+    run.yaw = MotionProfile::plan(yaw_angle - attitude.yaw, params.max_rate,
+                                  params.max_accel, params.max_jerk);
+    run.pitch =
+        MotionProfile::plan(pitch_angle - attitude.pitch, params.max_rate,
+                            params.max_accel, params.max_jerk);
+    duration = std::max(run.yaw.duration(), run.pitch.duration());
+    run.yaw.stretch(duration);
+    run.pitch.stretch(duration);
+    run.generation = ++motion_generation_;
+    motion_run_ = run;
+
+    motion_status_ = MotionStatus();
+    motion_status_.state = MotionState::STREAMING;
+    motion_status_.yaw_target = yaw_angle;
+    motion_status_.pitch_target = pitch_angle;
+    motion_status_.planned_s = duration;
+    motion_status_.started_at = now;
+    uint32_t generation = run.generation;
+    motion_task_ = timer_->schedule(
+        now, std::chrono::milliseconds(params.period_ms),
+        [this, generation](Clock::time_point deadline) {
+          return motionTick(deadline, generation);
+        });
+  }
+
+  LOG_F(INFO, "moveGimbal: (%.2f, %.2f) -> (%.2f, %.2f) planned %.3f s",
+        attitude.yaw, attitude.pitch, yaw_angle, pitch_angle, duration);
+  return true;
+}
+
+bool GimbalCtrl::waitMotion(int timeout_ms) {
+  std::unique_lock<std::mutex> lock(motion_mutex_);
+  auto done = [&] {
+    return motion_status_.state != MotionState::STREAMING &&
+           motion_status_.state != MotionState::LOCKING;
+  };
+  motion_cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), done);
+  return motion_status_.state == MotionState::SETTLED;
+}
+
+void GimbalCtrl::stopMotion() {
+  if (!cancelMotion())
+    return;
+  stream(tp::encodeWrite<tp::Id::GSY>(0));
+  stream(tp::encodeWrite<tp::Id::GSP>(0));
+  LOG_F(INFO, "stopMotion");
+}
+
+GimbalCtrl::MotionStatus GimbalCtrl::getMotionStatus() {
+  std::lock_guard<std::mutex> lock(motion_mutex_);
+  return motion_status_;
+}
+
+bool GimbalCtrl::cancelMotion() {
+  GimbalTimer::TaskId task;
+  {
+    std::lock_guard<std::mutex> lock(motion_mutex_);
+    task = motion_task_;
+    motion_task_ = 0;
+  }
+  // 等待正在执行的一拍结束，不能持有 motion_mutex_
+  if (task != 0)
+    timer_->cancel(task);
+
+  bool active;
+  {
+    std::lock_guard<std::mutex> lock(motion_mutex_);
+    active = motion_status_.state == MotionState::STREAMING ||
+             motion_status_.state == MotionState::LOCKING;
+    if (active) {
+      motion_status_.state = MotionState::STOPPED;
+      motion_status_.finished_at = Clock::now();
+    }
+  }
+  if (active)
+    motion_cv_.notify_all();
+  return active;
+}
+
+/**
+ * @brief 规划运动的一拍，在定时器线程中执行
+ *
+ * @param deadline 本拍的计划时刻
+ * @param generation 启动时的 motion_generation_
+ * @return false 运动结束，停止周期任务
+ */
+bool GimbalCtrl::motionTick(Clock::time_point deadline, uint32_t generation) {
+  Attitude attitude = getAttitude();
+  int lead_ms;
+  {
+    std::lock_guard<std::mutex> lock(motion_mutex_);
+    lead_ms = motion_params_.lead_ms;
+  }
+  // 本拍指令生效时的姿态，已计入此前下发、尚未反映到遥测的速率指令
+  Attitude predicted =
+      predictAttitude(deadline + std::chrono::milliseconds(lead_ms));
+  std::string frames[2];
+  bool locking = false;
+  bool finished = false;
+  {
+    std::lock_guard<std::mutex> lock(motion_mutex_);
+    const MotionParams &params = motion_params_;
+    MotionRun &run = motion_run_;
+    MotionStatus &status = motion_status_;
+    if (run.generation != generation)
+      return false;
+    double t =
+        std::chrono::duration<double>(deadline - status.started_at).count();
+
+    if (generation != motion_generation_) {
+      // 并发启动的扫描或速率模式已取代本次运动
+      if (status.state == MotionState::STREAMING ||
+          status.state == MotionState::LOCKING) {
+        status.state = MotionState::STOPPED;
+        status.finished_at = Clock::now();
+        finished = true;
+      }
+      motion_task_ = 0;
+      if (!finished)
+        return false;
+    } else if (status.state == MotionState::STREAMING && t < status.planned_s) {
+      // 指令在 lead_ms 后生效：以该时刻的曲线速度前馈，并与该时刻的
+      // 预测姿态比较修正
+      double lead = t + params.lead_ms / 1000.0;
+      float yaw_error, pitch_error;
+      frames[0] = tp::encodeWrite<tp::Id::GSY>(streamRate(
+          params, run.yaw, lead, run.yaw_start, predicted.yaw, yaw_error));
+      frames[1] = tp::encodeWrite<tp::Id::GSP>(
+          streamRate(params, run.pitch, lead, run.pitch_start, predicted.pitch,
+                     pitch_error));
+      status.max_tracking_error =
+          std::max({status.max_tracking_error, std::fabs(yaw_error),
+                    std::fabs(pitch_error)});
+      status.rate_commands += 2;
+    } else if (status.state == MotionState::STREAMING) {
+      // 曲线结束，由固件的角度环锁定目标
+      status.state = MotionState::LOCKING;
+      run.lock_sent_at = deadline;
+      locking = true;
+      frames[0] = tp::encodeWrite<tp::Id::GAY>(
+          static_cast<int16_t>(std::lround(status.yaw_target * 100)),
+          kLockSpeed);
+      frames[1] = tp::encodeWrite<tp::Id::GAP>(
+          static_cast<int16_t>(std::lround(status.pitch_target * 100)),
+          kLockSpeed);
+    } else if (status.state == MotionState::LOCKING) {
+      bool settled =
+          attitude.stamp > run.lock_sent_at &&
+          std::fabs(attitude.yaw - status.yaw_target) <=
+              params.lock_tolerance &&
+          std::fabs(attitude.pitch - status.pitch_target) <=
+              params.lock_tolerance;
+      if (settled) {
+        status.state = MotionState::SETTLED;
+      } else if (deadline - run.lock_sent_at >
+                 std::chrono::milliseconds(params.lock_timeout_ms)) {
+        status.state = MotionState::TIMEOUT;
+        LOG_F(WARNING, "moveGimbal: not settled within %d ms",
+              params.lock_timeout_ms);
+      }
+      finished = status.state != MotionState::LOCKING;
+      if (finished) {
+        status.finished_at = Clock::now();
+        motion_task_ = 0;
+      }
+    } else {
+      return false;
+    }
+  }
+
+  if (finished) {
+    motion_cv_.notify_all();
+    return false;
+  }
+  // 锁定帧只发一次且为绝对角度，晚发仍然正确：不受期限约束，
+  // 否则定时器滞后时被丢弃，运动以 TIMEOUT 结束
+  for (const std::string &frame : frames)
+    if (!frame.empty())
+      stream(frame, locking ? Clock::time_point{} : deadline);
+  return true;
+}
+
+/**
+ * @brief 规划并开始扫描
+ *
+ * 由最近一帧姿态出发逐段规划整个时间表 (见 ScanSchedule)。定时器上每
+ * period_ms 一拍：运动段按 moveGimbal 的方式下发速率指令，到达时刻下发
+ * GAY/GAP 锁定航点并驻留至下一段开始。拍照按绝对时刻逐个登记为一次性
+ * 任务，不受运动拍周期的量化。进行中的扫描或规划运动被取代。
+ *
+ * @param pattern 扫描图样
+ * @return false 图样为空、无近期姿态 (未开启 GAA 输出) 或链路断开
+ */
+bool GimbalCtrl::startScan(const ScanPattern &pattern) {
+  if (pattern.size() == 0) {
+    LOG_F(ERROR, "startScan: empty pattern");
+    return false;
+  }
+  Clock::time_point now = Clock::now();
+  Attitude attitude = getAttitude();
+  if (attitude.stamp == Clock::time_point{} ||
+      now - attitude.stamp > std::chrono::milliseconds(500)) {
+    LOG_F(ERROR, "startScan: no recent attitude, enable attitude output");
+    return false;
+  }
+  if (getLinkState() == LinkState::DOWN) {
+    LOG_F(ERROR, "startScan: link down");
+    return false;
+  }
+
+  cancelMotion();
+  cancelSpeed();
+  cancelScan();
+
+  uint32_t generation;
+  size_t captures;
+  double planned;
+  {
+    std::lock_guard<std::mutex> lock(motion_mutex_);
+    const MotionParams &params = motion_params_;
+    scan_run_ = ScanRun();
+    scan_run_.schedule =
+        ScanSchedule::plan(pattern, attitude.yaw, attitude.pitch,
+                           params.max_rate, params.max_accel, params.max_jerk);
+    scan_status_ = ScanStatus();
+    scan_status_.state = ScanState::RUNNING;
+    scan_status_.points = pattern.size();
+    scan_status_.planned_s = scan_run_.schedule.duration();
+    scan_status_.started_at = now;
+    scan_status_.captures_planned = scan_run_.schedule.captures();
+    generation = ++motion_generation_;
+    scan_run_.generation = generation;
+    captures = scan_run_.schedule.captures();
+    planned = scan_run_.schedule.duration();
+    scan_task_ = timer_->schedule(
+        now, std::chrono::milliseconds(params.period_ms),
+        [this, generation](Clock::time_point deadline) {
+          return scanTick(deadline, generation);
+        });
+  }
+
+  LOG_F(INFO, "startScan: %zu points, %zu captures, planned %.3f s",
+        pattern.size(), captures, planned);
+  scheduleCapture(generation, 0);
+  return true;
+}
+
+bool GimbalCtrl::waitScan(int timeout_ms) {
+  std::unique_lock<std::mutex> lock(motion_mutex_);
+  motion_cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&] {
+    return scan_status_.state != ScanState::RUNNING;
+  });
+  return scan_status_.state == ScanState::DONE;
+}
+
+void GimbalCtrl::stopScan() {
+  if (!cancelScan())
+    return;
+  stream(tp::encodeWrite<tp::Id::GSY>(0));
+  stream(tp::encodeWrite<tp::Id::GSP>(0));
+  LOG_F(INFO, "stopScan");
+}
+
+GimbalCtrl::ScanStatus GimbalCtrl::getScanStatus() {
+  std::lock_guard<std::mutex> lock(motion_mutex_);
+  return scan_status_;
+}
+
+bool GimbalCtrl::cancelScan() {
+  GimbalTimer::TaskId tick, capture;
+  bool active;
+  {
+    std::lock_guard<std::mutex> lock(motion_mutex_);
+    active = scan_status_.state == ScanState::RUNNING;
+    if (active) {
+      scan_status_.state = ScanState::STOPPED;
+      scan_status_.finished_at = Clock::now();
+    }
+    tick = scan_task_;
+    capture = capture_task_;
+    scan_task_ = 0;
+    capture_task_ = 0;
+  }
+  // 等待正在执行的任务结束；拍照任务见到 STOPPED 后不再登记下一个
+  if (tick != 0)
+    timer_->cancel(tick);
+  if (capture != 0)
+    timer_->cancel(capture);
+  if (active)
+    motion_cv_.notify_all();
+  return active;
+}
+
+/**
+ * @brief 扫描的一拍，在定时器线程中执行
+ *
+ * @param deadline 本拍的计划时刻
+ * @param generation 启动时的 motion_generation_
+ * @return false 扫描结束，停止周期任务
+ */
+bool GimbalCtrl::scanTick(Clock::time_point deadline, uint32_t generation) {
+  int lead_ms;
+  bool superseded;
+  {
+    std::lock_guard<std::mutex> lock(motion_mutex_);
+    lead_ms = motion_params_.lead_ms;
+    // 并发启动的运动或速率模式已取代扫描，排队的拍照见到 STOPPED 后退出
+    superseded = scan_status_.state == ScanState::RUNNING &&
+                 scan_run_.generation == generation &&
+                 generation != motion_generation_;
+    if (superseded) {
+      scan_status_.state = ScanState::STOPPED;
+      scan_status_.finished_at = Clock::now();
+      scan_task_ = 0;
+      capture_task_ = 0;
+    }
+  }
+  if (superseded) {
+    motion_cv_.notify_all();
+    return false;
+  }
+  Attitude predicted =
+      predictAttitude(deadline + std::chrono::milliseconds(lead_ms));
+  std::string frames[2];
+  bool locking = false;
+  bool finished = false;
+  {
+    std::lock_guard<std::mutex> lock(motion_mutex_);
+    const MotionParams &params = motion_params_;
+    ScanRun &run = scan_run_;
+    ScanStatus &status = scan_status_;
+    if (status.state != ScanState::RUNNING || run.generation != generation)
+      return false;
+
+    const std::vector<ScanLeg> &legs = run.schedule.legs();
+    double t =
+        std::chrono::duration<double>(deadline - status.started_at).count();
+    // 驻留为 0 或短于一拍的航点不锁定，直接驶向下一点
+    while (run.leg + 1 < legs.size() && t >= legs[run.leg].leave_s) {
+      run.leg++;
+      run.locked = false;
+    }
+    const ScanLeg &leg = legs[run.leg];
+    status.point = run.leg;
+
+    if (t < leg.arrive_s) {
+      double lead = t - leg.start_s + params.lead_ms / 1000.0;
+      float yaw_error, pitch_error;
+      frames[0] = tp::encodeWrite<tp::Id::GSY>(streamRate(
+          params, leg.yaw, lead, leg.yaw_from, predicted.yaw, yaw_error));
+      frames[1] = tp::encodeWrite<tp::Id::GSP>(
+          streamRate(params, leg.pitch, lead, leg.pitch_from, predicted.pitch,
+                     pitch_error));
+      status.rate_commands += 2;
+    } else if (!run.locked) {
+      run.locked = true;
+      locking = true;
+      frames[0] = tp::encodeWrite<tp::Id::GAY>(
+          static_cast<int16_t>(std::lround(leg.point.yaw * 100)), kLockSpeed);
+      frames[1] = tp::encodeWrite<tp::Id::GAP>(
+          static_cast<int16_t>(std::lround(leg.point.pitch * 100)),
+          kLockSpeed);
+    } else if (t >= leg.leave_s && capture_task_ == 0) {
+      // 最后一段驻留结束且没有排队的拍照
+      status.state = ScanState::DONE;
+      status.finished_at = Clock::now();
+      scan_task_ = 0;
+      finished = true;
+    }
+  }
+
+  if (finished) {
+    motion_cv_.notify_all();
+    LOG_F(INFO, "scan done");
+    return false;
+  }
+  // 航点锁定帧与 motionTick 相同，不受期限约束
+  for (const std::string &frame : frames)
+    if (!frame.empty())
+      stream(frame, locking ? Clock::time_point{} : deadline);
+  return true;
+}
+
+// 登记第 from 段起的下一次拍照，没有时清空 capture_task_
+// 登记与记下任务号在同一临界区内：已到时刻的拍照立即在定时器线程上执行，
+// 它登记的下一次拍照不会被本次的任务号覆盖
+void GimbalCtrl::scheduleCapture(uint32_t generation, size_t from) {
+  std::lock_guard<std::mutex> lock(motion_mutex_);
+  if (generation != scan_run_.generation ||
+      scan_status_.state != ScanState::RUNNING)
+    return;
+  size_t leg = scan_run_.schedule.nextCapture(from);
+  if (leg >= scan_run_.schedule.legs().size()) {
+    capture_task_ = 0;
+    return;
+  }
+  Clock::time_point at =
+      scan_status_.started_at +
+      std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(
+          scan_run_.schedule.legs()[leg].capture_s));
+
+  capture_task_ = timer_->schedule(
+      at, Clock::duration::zero(),
+      [this, generation, leg](Clock::time_point deadline) {
+        return scanCapture(deadline, generation, leg);
+      });
+}
+
+/**
+ * @brief 扫描中的一次拍照，在定时器线程中于计划时刻执行
+ *
+ * 异步发送 CAP (不重发) 后记录发出时刻相对计划时刻的滞后，以及该时刻的
+ * 预测姿态与航点的偏差，然后登记下一次拍照。
+ */
+bool GimbalCtrl::scanCapture(Clock::time_point deadline, uint32_t generation,
+                             size_t leg) {
+  ScanPoint point;
+  {
+    std::lock_guard<std::mutex> lock(motion_mutex_);
+    if (generation != scan_run_.generation ||
+        scan_status_.state != ScanState::RUNNING)
+      return false;
+    point = scan_run_.schedule.legs()[leg].point;
+  }
+  int timeout_ms;
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    timeout_ms = async_timeout_ms_;
+  }
+
+  // CAP 非幂等，回显丢失时重发会在同一航点多拍一张，故不重发
+  CommandHandle handle = submit(
+      tp::encodeWrite<tp::Id::CAP>(0x01), timeout_ms, 0,
+      [this, generation](const CommandRecord &record) {
+        std::lock_guard<std::mutex> lock(motion_mutex_);
+        if (generation != scan_run_.generation)
+          return;
+        if (record.state == CommandState::CONFIRMED)
+          scan_status_.captures_confirmed++;
+        else if (record.state == CommandState::FAILED)
+          scan_status_.captures_failed++;
+      });
+  Clock::time_point sent = Clock::now();
+  Attitude attitude = predictAttitude(sent);
+  float error = std::hypot(attitude.yaw - point.yaw,
+                           attitude.pitch - point.pitch);
+  double late_us =
+      std::chrono::duration<double, std::micro>(sent - deadline).count();
+
+  {
+    std::lock_guard<std::mutex> lock(motion_mutex_);
+    if (generation != scan_run_.generation)
+      return false;
+    ScanStatus &status = scan_status_;
+    status.captures_triggered++;
+    if (handle == 0)
+      status.captures_failed++;
+    status.trigger_late_max_us = std::max(status.trigger_late_max_us, late_us);
+    status.trigger_late_sum_us += late_us;
+    status.position_error_max = std::max(status.position_error_max, error);
+    status.position_error_sum += error;
+  }
+  LOG_F(1, "scan capture %zu at (%.2f, %.2f), error %.3f deg, late %.0f us",
+        leg, point.yaw, point.pitch, error, late_us);
+
+  scheduleCapture(generation, leg + 1);
   return false;
 }
 
 bool GimbalCtrl::controlRecording(RecordState state) {
   uint8_t data = static_cast<uint8_t>(state);
-  std::string cmd = buildStaticCommand("U", "D", 'w', "REC", data);
+  std::string cmd = tp::encodeWrite<tp::Id::REC>(data);
   LOG_F(INFO, "controlRecording cmd:%s", cmd.c_str());
 
   // return sendAndVerify(cmd);
-  return send(cmd, 999);
+  return send(cmd, waitMs<tp::Id::REC>());
+}
+
+/**
+ * @brief 容忍一定过期的录像状态查询，优先使用状态缓存
+ *
+ * @param max_age_ms 缓存确认值允许的最大年龄
+ * @return true 正在录像
+ */
+bool GimbalCtrl::queryRecordingStatus(int max_age_ms) {
+  CachedValue cached =
+      loadCached(confirmed_state_[static_cast<size_t>(StateField::RECORDING)]);
+  if (cached.valid() &&
+      Clock::now() - cached.stamp <= std::chrono::milliseconds(max_age_ms))
+    return cached.value != 0;
+
+  return queryRecordingStatus();
 }
 
 bool GimbalCtrl::queryRecordingStatus(void) {
-  std::string cmd = buildStaticCommand("U", "D", 'r', "REC");
+  std::string cmd = tp::encodeRead<tp::Id::REC>();
   LOG_F(INFO, "queryRecordingStatus cmd:%s", cmd.c_str());
   // return sendAndVerify(cmd);
 
   std::string response;
-  send(cmd, response, 999);
+  send(cmd, response, waitMs<tp::Id::REC>());
 
   // 校验返回值
   // #TPDU2rREC003E 为未录像
@@ -131,9 +1108,893 @@ bool GimbalCtrl::queryRecordingStatus(void) {
 
 // 拍照
 bool GimbalCtrl::capturePhoto() {
-  std::string cmd = buildStaticCommand("U", "D", 'w', "CAP", 0x01);
+  std::string cmd = tp::encodeWrite<tp::Id::CAP>(0x01);
   // return sendAndVerify(cmd);
-  return send(cmd, 999);
+  return send(cmd, waitMs<tp::Id::CAP>());
+}
+
+/**
+ * @brief 开始连拍或延时拍摄，立即返回
+ *
+ * 第 index 张的计划时刻为 开始 + index x interval_ms，由定时器按绝对时刻
+ * 触发，发送耗时与确认时延不累积；定时器落后跳过的时刻计入滞后。
+ * 进行中的连拍被取代，其已发出照片的确认不再记录。
+ *
+ * @param params
+ * @param callback 每张确认或失败后调用 (通常在接收线程中)
+ * @return false 参数无效或链路断开
+ */
+bool GimbalCtrl::startBurst(const BurstParams &params, ShotCallback callback) {
+  if (params.count < 0 || params.interval_ms <= 0) {
+    LOG_F(ERROR, "startBurst: invalid count %d interval %d ms", params.count,
+          params.interval_ms);
+    return false;
+  }
+  if (getLinkState() == LinkState::DOWN) {
+    LOG_F(ERROR, "startBurst: link down");
+    return false;
+  }
+  stopBurst();
+
+  Clock::time_point first =
+      Clock::now() + std::chrono::milliseconds(std::max(0, params.delay_ms));
+  uint32_t generation;
+  {
+    std::lock_guard<std::mutex> lock(burst_mutex_);
+    burst_params_ = params;
+    burst_status_ = BurstStatus();
+    burst_status_.state = BurstState::RUNNING;
+    burst_status_.planned = static_cast<uint64_t>(params.count);
+    burst_status_.started_at = first;
+    burst_shots_.clear();
+    burst_callback_ =
+        callback ? std::make_shared<const ShotCallback>(std::move(callback))
+                 : nullptr;
+    generation = ++burst_generation_;
+  }
+
+  LOG_F(INFO, "startBurst: %d shots every %d ms", params.count,
+        params.interval_ms);
+
+  GimbalTimer::TaskId task = timer_->schedule(
+      first, std::chrono::milliseconds(params.interval_ms),
+      [this, generation](Clock::time_point) { return burstTick(generation); });
+  std::lock_guard<std::mutex> lock(burst_mutex_);
+  burst_task_ = task;
+  return true;
+}
+
+bool GimbalCtrl::waitBurst(int timeout_ms) {
+  std::unique_lock<std::mutex> lock(burst_mutex_);
+  const BurstStatus &status = burst_status_;
+  burst_cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&] {
+    return status.state != BurstState::RUNNING &&
+           status.confirmed + status.failed >= status.triggered;
+  });
+  return status.state == BurstState::DONE &&
+         status.confirmed == status.triggered;
+}
+
+void GimbalCtrl::stopBurst() {
+  GimbalTimer::TaskId task;
+  {
+    std::lock_guard<std::mutex> lock(burst_mutex_);
+    task = burst_task_;
+    burst_task_ = 0;
+  }
+  // 等待正在执行的一张发出，不能持有 burst_mutex_
+  if (task != 0)
+    timer_->cancel(task);
+
+  bool active;
+  {
+    std::lock_guard<std::mutex> lock(burst_mutex_);
+    active = burst_status_.state == BurstState::RUNNING;
+    if (active) {
+      burst_status_.state = BurstState::STOPPED;
+      burst_status_.finished_at = Clock::now();
+    }
+  }
+  if (active) {
+    burst_cv_.notify_all();
+    LOG_F(INFO, "stopBurst");
+  }
+}
+
+GimbalCtrl::BurstStatus GimbalCtrl::getBurstStatus() {
+  std::lock_guard<std::mutex> lock(burst_mutex_);
+  return burst_status_;
+}
+
+std::vector<GimbalCtrl::Shot> GimbalCtrl::getBurstShots() {
+  std::lock_guard<std::mutex> lock(burst_mutex_);
+  return std::vector<Shot>(burst_shots_.begin(), burst_shots_.end());
+}
+
+/**
+ * @brief 连拍的一张，在定时器线程中执行
+ *
+ * 先登记记录再发送，确认先于本函数返回到达时也能找到对应记录
+ *
+ * @return false 全部张数已发出或连拍已被取代，停止周期任务
+ */
+bool GimbalCtrl::burstTick(uint32_t generation) {
+  uint64_t index;
+  Clock::time_point planned;
+  int timeout_ms;
+  {
+    std::lock_guard<std::mutex> lock(burst_mutex_);
+    if (generation != burst_generation_ ||
+        burst_status_.state != BurstState::RUNNING)
+      return false;
+    index = burst_status_.triggered;
+    planned = burst_status_.started_at +
+              std::chrono::milliseconds(burst_params_.interval_ms) * index;
+    Shot shot;
+    shot.index = index;
+    shot.planned_at = planned;
+    burst_shots_.push_back(shot);
+    if (burst_shots_.size() > kBurstHistory)
+      burst_shots_.pop_front();
+    burst_status_.triggered++;
+  }
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    timeout_ms = async_timeout_ms_;
+  }
+
+  CommandHandle handle = submit(
+      tp::encodeWrite<tp::Id::CAP>(0x01), timeout_ms, 0,
+      [this, generation, index](const CommandRecord &record) {
+        burstCompleted(generation, index, record);
+      });
+  Clock::time_point sent = Clock::now();
+  Attitude attitude = getAttitude();
+  double late_us =
+      std::chrono::duration<double, std::micro>(sent - planned).count();
+
+  bool done;
+  Shot failed;
+  std::shared_ptr<const ShotCallback> callback;
+  {
+    std::lock_guard<std::mutex> lock(burst_mutex_);
+    if (generation != burst_generation_)
+      return false;
+    BurstStatus &status = burst_status_;
+    status.late_max_us = std::max(status.late_max_us, late_us);
+    status.late_sum_us += late_us;
+
+    uint64_t front = burst_shots_.front().index;
+    if (index >= front) {
+      Shot &shot = burst_shots_[index - front];
+      // 确认可能已先到达并填写了这些字段
+      if (shot.handle == 0) {
+        shot.handle = handle;
+        shot.sent_at = sent;
+        shot.attitude = attitude;
+      }
+      if (handle == 0) {
+        shot.state = CommandState::FAILED;
+        shot.completed_at = sent;
+        status.failed++;
+        failed = shot;
+        callback = burst_callback_;
+      }
+    }
+
+    done = status.state == BurstState::RUNNING && status.planned > 0 &&
+           status.triggered >= status.planned;
+    if (done) {
+      status.state = BurstState::DONE;
+      status.finished_at = sent;
+      burst_task_ = 0;
+    }
+  }
+
+  if (handle == 0)
+    LOG_F(WARNING, "burst shot %lu not sent",
+          static_cast<unsigned long>(index));
+  if (callback)
+    (*callback)(failed);
+  if (done || handle == 0)
+    burst_cv_.notify_all();
+  return !done;
+}
+
+// 连拍中一张确认或超时，在接收线程中调用
+void GimbalCtrl::burstCompleted(uint32_t generation, uint64_t index,
+                                const CommandRecord &record) {
+  Shot shot;
+  std::shared_ptr<const ShotCallback> callback;
+  {
+    std::lock_guard<std::mutex> lock(burst_mutex_);
+    if (generation != burst_generation_ || burst_shots_.empty() ||
+        index < burst_shots_.front().index)
+      return;
+    Shot &entry = burst_shots_[index - burst_shots_.front().index];
+    entry.handle = record.handle;
+    entry.state = record.state;
+    entry.sent_at = record.sent_at;
+    entry.completed_at = record.completed_at;
+    entry.attitude = record.attitude;
+    entry.rtt_us = record.rtt_us;
+    if (record.state == CommandState::CONFIRMED)
+      burst_status_.confirmed++;
+    else
+      burst_status_.failed++;
+    shot = entry;
+    callback = burst_callback_;
+  }
+  // 先回调再唤醒，waitBurst 返回时各张的回调均已执行
+  if (callback)
+    (*callback)(shot);
+  burst_cv_.notify_all();
+}
+
+/**
+ * @brief 异步拍照，立即发送，不等待应答
+ *
+ * @param callback 确认或重发失败后调用 (接收线程中)
+ * @return GimbalCtrl::CommandHandle 指令句柄，发送失败返回 0
+ */
+GimbalCtrl::CommandHandle
+GimbalCtrl::capturePhotoAsync(CommandCallback callback) {
+  std::string cmd = tp::encodeWrite<tp::Id::CAP>(0x01);
+  int timeout_ms, retries;
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    timeout_ms = async_timeout_ms_;
+    retries = async_retries_;
+  }
+  return submit(cmd, timeout_ms, retries, std::move(callback));
+}
+
+/**
+ * @brief 异步录像控制，立即发送，不等待应答
+ *
+ * @param state
+ * @param callback 确认或重发失败后调用 (接收线程中)
+ * @return GimbalCtrl::CommandHandle 指令句柄，发送失败返回 0
+ */
+GimbalCtrl::CommandHandle
+GimbalCtrl::controlRecordingAsync(RecordState state, CommandCallback callback) {
+  uint8_t data = static_cast<uint8_t>(state);
+  std::string cmd = tp::encodeWrite<tp::Id::REC>(data);
+  int timeout_ms, retries;
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    timeout_ms = async_timeout_ms_;
+    retries = async_retries_;
+  }
+  return submit(cmd, timeout_ms, retries, std::move(callback));
+}
+
+/**
+ * @brief 透传一帧完整指令，按异步指令跟踪确认
+ *
+ * @param frame 含校验位的完整帧
+ * @param callback 确认或重发失败后调用 (接收线程中)
+ * @param issued_at 请求时刻，默认为调用时刻
+ * @return GimbalCtrl::CommandHandle 帧无效、指令过期、链路断开或发送失败
+ * 返回 0
+ */
+GimbalCtrl::CommandHandle
+GimbalCtrl::sendFrameAsync(const std::string &frame, CommandCallback callback,
+                           Clock::time_point issued_at) {
+  if (!validateFrame(frame)) {
+    LOG_F(WARNING, "sendFrameAsync: invalid frame %s", frame.c_str());
+    return 0;
+  }
+  int timeout_ms, retries;
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    timeout_ms = async_timeout_ms_;
+    retries = async_retries_;
+  }
+  return submit(frame, timeout_ms, retries, std::move(callback), issued_at);
+}
+
+/**
+ * @brief 查询异步指令状态
+ *
+ * @param handle
+ * @param record 输出指令记录，记录已被淘汰时 state 为 EXPIRED
+ * @return true 句柄存在
+ * @return false 句柄未知或记录已被淘汰
+ */
+bool GimbalCtrl::pollCommand(CommandHandle handle, CommandRecord &record) {
+  std::lock_guard<std::mutex> lock(pending_mutex_);
+  return findRecord(handle, record);
+}
+
+/**
+ * @brief 在等待中与最近完成的指令中查找记录，调用方需持有 pending_mutex_
+ *
+ * @return false 句柄未知或记录已被淘汰，后者 record.state 为 EXPIRED
+ */
+bool GimbalCtrl::findRecord(CommandHandle handle, CommandRecord &record) {
+  auto it = pending_.find(handle);
+  if (it != pending_.end()) {
+    record = it->second.record;
+    return true;
+  }
+  const CommandRecord &done = completed_[handle % kCompletedHistory];
+  if (done.handle == handle) {
+    record = done;
+    return true;
+  }
+  // 已分配过的句柄：结果被之后的 kCompletedHistory 条完成记录覆盖
+  if (handle != 0 && handle < next_handle_) {
+    record = CommandRecord();
+    record.handle = handle;
+    record.state = CommandState::EXPIRED;
+  }
+  return false;
+}
+
+/**
+ * @brief 设置异步指令的单次超时与重发次数
+ *
+ * @param timeout_ms
+ * @param retries
+ */
+void GimbalCtrl::setCommandRetry(int timeout_ms, int retries) {
+  std::lock_guard<std::mutex> lock(pending_mutex_);
+  async_timeout_ms_ = std::max(1, timeout_ms);
+  async_retries_ = std::max(0, retries);
+}
+
+/**
+ * @brief 设置云台姿态主动送出
+ *
+ * @param rate_hz 0 关闭，1-100 Hz
+ * @return true
+ * @return false
+ */
+bool GimbalCtrl::enableAttitudeOutput(uint8_t rate_hz) {
+  rate_hz = std::min<uint8_t>(rate_hz, 100);
+  std::string cmd = tp::encodeWrite<tp::Id::GAA>(rate_hz);
+  LOG_F(INFO, "enableAttitudeOutput cmd:%s", cmd.c_str());
+  return send(cmd, waitMs<tp::Id::GAA>());
+}
+
+/**
+ * @brief 设置编组控制地址
+ *
+ * @param group_ip 组播地址 (224.0.0.0/4) 或子网广播地址
+ * @param ttl 组播 TTL，广播地址忽略
+ */
+void GimbalCtrl::setGroupAddress(const std::string &group_ip,
+                                 unsigned char ttl) {
+  std::lock_guard<std::mutex> lock(socket_mutex_);
+  group_ip_ = group_ip;
+
+  in_addr addr{};
+  if (inet_pton(AF_INET, group_ip.c_str(), &addr) == 1 &&
+      IN_MULTICAST(ntohl(addr.s_addr))) {
+    try {
+      transport_->setMulticastTTL(ttl);
+    } catch (SocketException &e) {
+      LOG_F(ERROR, "Socket error: %s", e.what());
+    }
+  }
+  LOG_F(INFO, "setGroupAddress [ip]:%s [ttl]:%d", group_ip_.c_str(), ttl);
+}
+
+/**
+ * @brief 编组拍照，所有单元收到同一帧
+ *
+ * @param expected_units 期望应答的单元数，0 为收集至超时
+ * @param callback
+ * @return GimbalCtrl::CommandHandle 未设置编组地址或发送失败返回 0
+ */
+GimbalCtrl::CommandHandle
+GimbalCtrl::capturePhotoGroup(size_t expected_units, CommandCallback callback) {
+  std::string cmd = tp::encodeWrite<tp::Id::CAP>(0x01);
+  return submitGroup(cmd, expected_units, std::move(callback));
+}
+
+/**
+ * @brief 编组录像控制
+ *
+ * @param state
+ * @param expected_units 期望应答的单元数，0 为收集至超时
+ * @param callback
+ * @return GimbalCtrl::CommandHandle 未设置编组地址或发送失败返回 0
+ */
+GimbalCtrl::CommandHandle
+GimbalCtrl::controlRecordingGroup(RecordState state, size_t expected_units,
+                                  CommandCallback callback) {
+  uint8_t data = static_cast<uint8_t>(state);
+  std::string cmd = tp::encodeWrite<tp::Id::REC>(data);
+  return submitGroup(cmd, expected_units, std::move(callback));
+}
+
+/**
+ * @brief 开启/关闭内核收发时间戳
+ *
+ * @param enable
+ * @return true
+ * @return false 平台不支持或设置失败
+ */
+bool GimbalCtrl::setKernelTimestamping(bool enable) {
+  std::lock_guard<std::mutex> lock(socket_mutex_);
+  try {
+    transport_->setTimestamping(enable);
+  } catch (SocketException &e) {
+    LOG_F(ERROR, "Socket error: %s", e.what());
+    return false;
+  }
+  // 重复开启不改变内核的发送序号，此前的发送时间戳仍然有效
+  if (enable && !timestamping_)
+    tx_epoch_.fetch_add(1, std::memory_order_release);
+  timestamping_ = enable;
+  LOG_F(INFO, "setKernelTimestamping %s", enable ? "on" : "off");
+  return true;
+}
+
+GimbalCtrl::LinkStats GimbalCtrl::getLinkStats() {
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  LinkStats stats = stats_;
+  stats.rx_buffer_misses = rx_pool_->misses();
+  return stats;
+}
+
+void GimbalCtrl::resetLinkStats() {
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  stats_ = LinkStats();
+}
+
+/**
+ * @brief 开启周期心跳
+ * 心跳为 REC 读指令，超时即为一次失败，应答刷新录像状态缓存；
+ * 周期内录像状态已确认时跳过
+ *
+ * @param interval_ms 心跳周期，0 关闭
+ */
+void GimbalCtrl::enableHeartbeat(int interval_ms) {
+  std::lock_guard<std::mutex> lock(link_mutex_);
+  heartbeat_ms_ = std::max(0, interval_ms);
+  next_heartbeat_ = Clock::now();
+}
+
+/**
+ * @brief 设置断路策略
+ *
+ * @param down_after_failures 判定断开所需的连续失败次数
+ * @param probe_interval_ms 断开后放行探测指令的间隔
+ */
+void GimbalCtrl::setLinkPolicy(int down_after_failures,
+                               int probe_interval_ms) {
+  std::lock_guard<std::mutex> lock(link_mutex_);
+  down_after_failures_ = std::max(1, down_after_failures);
+  probe_interval_ms_ = std::max(1, probe_interval_ms);
+}
+
+GimbalCtrl::LinkState GimbalCtrl::getLinkState() {
+  std::lock_guard<std::mutex> lock(link_mutex_);
+  return link_state_;
+}
+
+void GimbalCtrl::setLinkStateCallback(LinkStateCallback callback) {
+  std::lock_guard<std::mutex> lock(link_mutex_);
+  link_callback_ = std::move(callback);
+}
+
+GimbalCtrl::Attitude GimbalCtrl::getAttitude() {
+  std::lock_guard<std::mutex> lock(attitude_mutex_);
+  return attitude_;
+}
+
+GimbalCtrl::Attitude GimbalCtrl::predictAttitude(Clock::time_point t) {
+  Attitude attitude;
+  AttitudeEstimator::Estimate estimate;
+  {
+    std::lock_guard<std::mutex> lock(attitude_mutex_);
+    estimate = estimator_.predict(t);
+  }
+  if (!estimate.valid)
+    return attitude;
+  attitude.yaw = estimate.angle[AttitudeEstimator::YAW];
+  attitude.pitch = estimate.angle[AttitudeEstimator::PITCH];
+  attitude.roll = estimate.angle[AttitudeEstimator::ROLL];
+  attitude.stamp = t;
+  return attitude;
+}
+
+void GimbalCtrl::setEstimatorParams(const AttitudeEstimator::Params &params) {
+  std::lock_guard<std::mutex> lock(attitude_mutex_);
+  estimator_.setParams(params);
+}
+
+/**
+ * @brief 查询历史姿态，无锁，可在任意线程调用
+ *
+ * @param t 采样时刻，如照片或视频帧的时间戳
+ * @param attitude 输出，相邻两帧姿态的线性插值，stamp 为 t
+ * @return false t 早于保留的最早样本或晚于最新样本
+ */
+bool GimbalCtrl::attitudeAt(Clock::time_point t, Attitude &attitude) {
+  AttitudeHistory::Sample sample;
+  if (!history_.load(std::memory_order_acquire)->at(t, sample))
+    return false;
+  attitude.yaw = sample.angle[0];
+  attitude.pitch = sample.angle[1];
+  attitude.roll = sample.angle[2];
+  attitude.stamp = sample.stamp;
+  return true;
+}
+
+/**
+ * @brief 按内存预算重建姿态历史，已有样本丢弃
+ *
+ * 旧的缓冲保留至析构，正在查询的读端不会访问已释放的内存；
+ * 因此只应在配置阶段调用，而非周期性调用。
+ *
+ * @param budget_bytes 每个样本占 32 字节，容量取预算内最大的 2 的幂
+ */
+void GimbalCtrl::setAttitudeHistory(size_t budget_bytes) {
+  std::lock_guard<std::mutex> lock(attitude_mutex_);
+  histories_.push_back(std::make_unique<AttitudeHistory>(budget_bytes));
+  history_.store(histories_.back().get(), std::memory_order_release);
+  LOG_F(INFO, "setAttitudeHistory: %zu samples",
+        histories_.back()->capacity());
+}
+
+/**
+ * @brief 开启共享内存状态发布
+ *
+ * @param name POSIX 共享内存名，如 /gimbal_state
+ * @return true 已创建并写入首个快照
+ * @return false 创建或映射失败，或该段已由其他写端占用
+ */
+bool GimbalCtrl::enableSharedState(const std::string &name) {
+  disableSharedState();
+
+  // 以 O_EXCL 独占创建，不接管仍在发布的段，disableSharedState 也只删除
+  // 自己创建的段；写端已退出的遗留段先删除再创建
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+  uint32_t owner = 0;
+  if (fd < 0 && errno == EEXIST && staleSegment(name, owner)) {
+    LOG_F(WARNING, "enableSharedState: remove stale %s of pid %u",
+          name.c_str(), owner);
+    shm_unlink(name.c_str());
+    fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+  }
+  if (fd < 0) {
+    if (errno == EEXIST)
+      LOG_F(ERROR, "enableSharedState: %s is in use by pid %u", name.c_str(),
+            owner);
+    else
+      LOG_F(ERROR, "enableSharedState: shm_open %s failed: %s", name.c_str(),
+            strerror(errno));
+    return false;
+  }
+  void *addr = MAP_FAILED;
+  if (ftruncate(fd, sizeof(GimbalShmSegment)) == 0)
+    addr = mmap(nullptr, sizeof(GimbalShmSegment), PROT_READ | PROT_WRITE,
+                MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    LOG_F(ERROR, "enableSharedState: map %s failed: %s", name.c_str(),
+          strerror(errno));
+    shm_unlink(name.c_str());
+    return false;
+  }
+
+  // 读端以 magic 判断段是否就绪，最后写入
+  auto *segment = static_cast<GimbalShmSegment *>(addr);
+  segment->version = kGimbalShmVersion;
+  segment->writer_pid = static_cast<uint32_t>(getpid());
+  segment->seq.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  segment->magic = kGimbalShmMagic;
+
+  {
+    std::lock_guard<std::mutex> lock(shm_mutex_);
+    shm_segment_ = segment;
+    shm_name_ = name;
+    shm_publish_count_ = 0;
+  }
+  shm_enabled_.store(true, std::memory_order_release);
+  publishState();
+  LOG_F(INFO, "Publishing gimbal state to shm %s", name.c_str());
+  return true;
+}
+
+void GimbalCtrl::disableSharedState() {
+  shm_enabled_.store(false, std::memory_order_release);
+  std::lock_guard<std::mutex> lock(shm_mutex_);
+  if (shm_segment_ == nullptr)
+    return;
+  munmap(shm_segment_, sizeof(GimbalShmSegment));
+  shm_unlink(shm_name_.c_str());
+  shm_segment_ = nullptr;
+}
+
+/**
+ * @brief 把当前姿态、确认状态与链路状态写入共享内存
+ * 快照在 shm_mutex_ 内生成并写入，并发的发布者不会以旧快照覆盖新快照。
+ * 调用时不得持有 attitude_mutex_ 与 link_mutex_
+ */
+void GimbalCtrl::publishState() {
+  if (!shm_enabled_.load(std::memory_order_acquire))
+    return;
+
+  auto toNs = [](Clock::time_point stamp) -> int64_t {
+    if (stamp == Clock::time_point{})
+      return 0;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               stamp.time_since_epoch())
+        .count();
+  };
+  auto toValue = [&](StateField field) {
+    CachedValue cached =
+        loadCached(confirmed_state_[static_cast<size_t>(field)]);
+    GimbalShmValue value{};
+    if (cached.valid()) {
+      value.value = cached.value;
+      value.valid = 1;
+      value.stamp_ns = toNs(cached.stamp);
+    }
+    return value;
+  };
+
+  std::lock_guard<std::mutex> lock(shm_mutex_);
+  if (shm_segment_ == nullptr)
+    return;
+
+  GimbalShmSnapshot snapshot{};
+  Attitude attitude = getAttitude();
+  snapshot.yaw = attitude.yaw;
+  snapshot.pitch = attitude.pitch;
+  snapshot.roll = attitude.roll;
+  snapshot.attitude_stamp_ns = toNs(attitude.stamp);
+  snapshot.link_state = static_cast<uint32_t>(getLinkState());
+  snapshot.recording = toValue(StateField::RECORDING);
+  snapshot.zoom = toValue(StateField::ZOOM);
+  snapshot.color_mode = toValue(StateField::COLOR_MODE);
+  snapshot.install_mode = toValue(StateField::INSTALL_MODE);
+  snapshot.yaw_target = toValue(StateField::YAW_TARGET);
+  snapshot.pitch_target = toValue(StateField::PITCH_TARGET);
+  snapshot.roll_target = toValue(StateField::ROLL_TARGET);
+  snapshot.publish_stamp_ns = toNs(Clock::now());
+  snapshot.publish_count = ++shm_publish_count_;
+  gimbalShmPublish(shm_segment_, snapshot);
+}
+
+bool GimbalCtrl::enableTelemetryLog(const std::string &prefix) {
+  return enableTelemetryLog(prefix, TelemetryWriter::Params());
+}
+
+bool GimbalCtrl::enableTelemetryLog(const std::string &prefix,
+                                    const TelemetryWriter::Params &params) {
+  disableTelemetryLog();
+  std::lock_guard<std::mutex> lock(telemetry_mutex_);
+  if (!telemetry_.open(prefix, params))
+    return false;
+  telemetry_enabled_.store(true, std::memory_order_release);
+  return true;
+}
+
+void GimbalCtrl::disableTelemetryLog() {
+  telemetry_enabled_.store(false, std::memory_order_release);
+  std::lock_guard<std::mutex> lock(telemetry_mutex_);
+  if (!telemetry_.isOpen())
+    return;
+  TelemetryWriter::Stats stats = telemetry_.stats();
+  telemetry_.close();
+  LOG_F(INFO,
+        "Telemetry log closed: %lu attitude, %lu command, %lu rtt rows in %u "
+        "files, %lu dropped",
+        static_cast<unsigned long>(stats.rows[0]),
+        static_cast<unsigned long>(stats.rows[1]),
+        static_cast<unsigned long>(stats.rows[2]), stats.files,
+        static_cast<unsigned long>(stats.dropped));
+}
+
+TelemetryWriter::Stats GimbalCtrl::getTelemetryStats() {
+  std::lock_guard<std::mutex> lock(telemetry_mutex_);
+  return telemetry_.stats();
+}
+
+void GimbalCtrl::setAttitudeCallback(AttitudeCallback callback) {
+  std::lock_guard<std::mutex> lock(attitude_mutex_);
+  attitude_callback_ =
+      callback ? std::make_shared<const AttitudeCallback>(std::move(callback))
+               : nullptr;
+}
+
+/**
+ * @brief 设置云台 IP 与网关
+ * 两条写指令依次发送并等待回显，新地址通常在云台重启后生效
+ *
+ * @param ip
+ * @param gateway
+ * @return true 均已确认
+ */
+bool GimbalCtrl::setNetworkConfig(const std::string &ip,
+                                  const std::string &gateway) {
+  in_addr addr;
+  if (inet_pton(AF_INET, ip.c_str(), &addr) != 1 ||
+      inet_pton(AF_INET, gateway.c_str(), &addr) != 1) {
+    LOG_F(ERROR, "Invalid network config: %s %s", ip.c_str(),
+          gateway.c_str());
+    return false;
+  }
+
+  std::string cmd = tp::encodeWrite<tp::Id::IPV>(ip);
+  LOG_F(INFO, "setNetworkConfig cmd:%s", cmd.c_str());
+  if (!send(cmd, waitMs<tp::Id::IPV>()))
+    return false;
+
+  cmd = tp::encodeWrite<tp::Id::GTW>(gateway);
+  LOG_F(INFO, "setNetworkConfig cmd:%s", cmd.c_str());
+  return send(cmd, waitMs<tp::Id::GTW>());
+}
+
+/**
+ * @brief 读取云台 IP 与网关，两条读指令同时发出
+ *
+ * @return std::pair<std::string, std::string> {ip, gateway}，失败项为空
+ */
+std::pair<std::string, std::string> GimbalCtrl::getNetworkConfig() {
+  CommandHandle ip_handle =
+      submit(tp::encodeRead<tp::Id::IPV>(), waitMs<tp::Id::IPV>(), 0);
+  CommandHandle gateway_handle =
+      submit(tp::encodeRead<tp::Id::GTW>(), waitMs<tp::Id::GTW>(), 0);
+
+  std::pair<std::string, std::string> config;
+  CommandRecord record;
+  if (waitCommand(ip_handle, record))
+    config.first = std::string(frameData(record.response));
+  if (waitCommand(gateway_handle, record))
+    config.second = std::string(frameData(record.response));
+
+  LOG_F(INFO, "getNetworkConfig ip:%s gateway:%s", config.first.c_str(),
+        config.second.c_str());
+  return config;
+}
+
+/**
+ * @brief 展开发现目标为地址列表
+ * 支持 "a.b.c.d/n" 网段 (不含网络与广播地址)、"a.b.c.d-e.f.g.h" 范围与单个地址
+ *
+ * @return false 格式错误或地址数超过上限
+ */
+bool GimbalCtrl::expandTargets(const std::string &targets,
+                               std::vector<std::string> &addresses) {
+  constexpr uint32_t kMaxTargets = 4096;
+
+  auto parse = [](const std::string &text, uint32_t &host) {
+    in_addr addr;
+    if (inet_pton(AF_INET, text.c_str(), &addr) != 1)
+      return false;
+    host = ntohl(addr.s_addr);
+    return true;
+  };
+
+  uint32_t first, last;
+  size_t pos;
+  if ((pos = targets.find('/')) != std::string::npos) {
+    int prefix = atoi(targets.c_str() + pos + 1);
+    if (!parse(targets.substr(0, pos), first) || prefix < 16 || prefix > 32)
+      return false;
+    uint32_t mask = prefix == 32 ? 0xFFFFFFFFu : ~(0xFFFFFFFFu >> prefix);
+    first &= mask;
+    last = first | ~mask;
+    if (prefix < 31) {
+      first++;
+      last--;
+    }
+  } else if ((pos = targets.find('-')) != std::string::npos) {
+    if (!parse(targets.substr(0, pos), first) ||
+        !parse(targets.substr(pos + 1), last) || last < first)
+      return false;
+  } else {
+    if (!parse(targets, first))
+      return false;
+    last = first;
+  }
+
+  if (last - first >= kMaxTargets)
+    return false;
+
+  for (uint64_t host = first; host <= last; host++) {
+    in_addr addr;
+    addr.s_addr = htonl(static_cast<uint32_t>(host));
+    char buf[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &addr, buf, sizeof(buf));
+    addresses.emplace_back(buf);
+  }
+  return true;
+}
+
+/**
+ * @brief 网络发现
+ * 所有探测帧先全部发出，再在同一超时窗口内收集应答，总耗时约为 timeout_ms
+ *
+ * @param targets 网段、地址范围或单个 (广播) 地址
+ * @param port 云台控制端口
+ * @param timeout_ms 收集窗口
+ * @return std::vector<GimbalCtrl::DiscoveredUnit> 按 IP 排序的应答单元
+ */
+std::vector<GimbalCtrl::DiscoveredUnit>
+GimbalCtrl::discover(const std::string &targets, uint16_t port,
+                     int timeout_ms) {
+  std::vector<DiscoveredUnit> units;
+  std::vector<std::string> addresses;
+  if (!expandTargets(targets, addresses)) {
+    LOG_F(ERROR, "Invalid discovery targets: %s", targets.c_str());
+    return units;
+  }
+
+  const std::string probe = tp::encodeRead<tp::Id::VER>();
+  std::map<uint32_t, DiscoveredUnit> found; // 按主机序地址排序
+
+  try {
+    UDPSocket sock;
+    UDPRecvBatch batch(kRxBatch);
+    Clock::time_point start = Clock::now();
+    // 按目的地址记录发送时刻；广播探测的应答来自其他地址，以 start 计
+    std::map<uint32_t, Clock::time_point> sent_at;
+    for (const auto &address : addresses) {
+      sock.sendTo(probe.data(), static_cast<int>(probe.size()), address, port);
+      in_addr addr{};
+      if (inet_pton(AF_INET, address.c_str(), &addr) == 1)
+        sent_at.emplace(ntohl(addr.s_addr), Clock::now());
+    }
+    LOG_F(INFO, "Discovery probe sent to %zu addresses", addresses.size());
+
+    Clock::time_point deadline = start + std::chrono::milliseconds(timeout_ms);
+    for (Clock::time_point now = start; now < deadline; now = Clock::now()) {
+      int wait_ms = static_cast<int>(
+          std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now)
+              .count());
+      if (!sock.poll(std::max(1, wait_ms)))
+        continue;
+
+      int received = sock.recvBatch(batch, 0);
+      now = Clock::now();
+      for (int i = 0; i < received; i++) {
+        std::string_view frame(batch.data(i), batch.length(i));
+        if (!validateFrame(frame) || tp::frameId(frame) != tp::Id::VER)
+          continue;
+
+        // 每个单元只记录首个应答
+        uint32_t host = ntohl(batch.source(i).sin_addr.s_addr);
+        if (found.count(host))
+          continue;
+        DiscoveredUnit &unit = found[host];
+        unit.ip = addressString(batch.source(i));
+        unit.port = ntohs(batch.source(i).sin_port);
+        unit.firmware = std::string(frameData(frame));
+        auto sent = sent_at.find(host);
+        unit.rtt_ms = std::chrono::duration<double, std::milli>(
+                          now - (sent != sent_at.end() ? sent->second : start))
+                          .count();
+      }
+    }
+  } catch (SocketException &e) {
+    LOG_F(ERROR, "Discovery socket error: %s", e.what());
+  }
+
+  for (auto &item : found) {
+    LOG_F(INFO, "Discovered %s:%u firmware %s", item.second.ip.c_str(),
+          item.second.port, item.second.firmware.c_str());
+    units.push_back(std::move(item.second));
+  }
+  return units;
+}
+
+GimbalCtrl::CachedState GimbalCtrl::getCachedState(StateField field) {
+  size_t index = static_cast<size_t>(field);
+  CachedState state;
+  if (index >= kStateFields)
+    return state;
+  state.commanded = loadCached(commanded_state_[index]);
+  state.confirmed = loadCached(confirmed_state_[index]);
+  return state;
 }
 
 /**
@@ -144,10 +2005,9 @@ bool GimbalCtrl::capturePhoto() {
  * @return false
  */
 bool GimbalCtrl::setZoomMode(ZoomMode mode) {
-  std::string cmd =
-      buildStaticCommand("U", "G", 'w', "DZM", {static_cast<uint8_t>(mode)});
+  std::string cmd = tp::encodeWrite<tp::Id::DZM>(static_cast<uint8_t>(mode));
   LOG_F(INFO, "setZoomMode cmd:%s", cmd.c_str());
-  return send(cmd, 999);
+  return send(cmd, waitMs<tp::Id::DZM>());
 }
 
 /**
@@ -158,34 +2018,184 @@ bool GimbalCtrl::setZoomMode(ZoomMode mode) {
  * @return true
  * @return false
  */
-bool GimbalCtrl::setThermalColorMode(ColorMode mode) {
-  uint8_t data = static_cast<uint8_t>(mode);
-  std::string cmd = buildStaticCommand("U", "D", 'w', "IMG", data);
+bool GimbalCtrl::setThermalColorMode(ColorMode mode) {
+  uint8_t data = static_cast<uint8_t>(mode);
+  std::string cmd = tp::encodeWrite<tp::Id::IMG>(data);
+
+  return send(cmd, waitMs<tp::Id::IMG>());
+}
+
+/**
+ * @brief 设置安装模式
+ *
+ * @param mode
+ * @return true 吊装
+ * @return false 竖装
+ */
+bool GimbalCtrl::setInstallMode(InstallMode mode) {
+  std::string cmd = tp::encodeWrite<tp::Id::PTZ>(static_cast<uint8_t>(mode));
+  LOG_F(INFO, "setInstallMode cmd:%s", cmd.c_str());
+
+  return send(cmd, waitMs<tp::Id::PTZ>());
+}
+
+/**
+ * @brief 读取固件版本
+ * 应答如 #tpDU6rVERV1.0.078，数据位 V1.0.0 即版本
+ *
+ * @return std::string 失败返回空串
+ */
+std::string GimbalCtrl::getFirmwareVersion() {
+  std::string cmd = tp::encodeRead<tp::Id::VER>();
+  LOG_F(INFO, "getFirmwareVersion cmd:%s", cmd.c_str());
+
+  std::string response;
+  if (!send(cmd, response, waitMs<tp::Id::VER>()))
+    return "";
+
+  std::string version(frameData(response));
+  {
+    std::lock_guard<std::mutex> lock(unit_mutex_);
+    unit_info_.firmware = version;
+    unit_info_.capabilities[tp::describe(tp::Id::VER).name] = version;
+  }
+  return version;
+}
+
+// 一次探测的共享状态，各读指令的完成回调在接收线程中汇总
+struct GimbalCtrl::ProbeState {
+  std::mutex mutex;
+  UnitInfo info;
+  size_t remaining = 0;
+  std::string cache_path;
+  std::string key;
+  std::promise<void> done;
+};
+
+/**
+ * @brief 启动探测
+ *
+ * @param cache_path 缓存文件，为空则不持久化
+ * @return true 已取得固件版本
+ */
+bool GimbalCtrl::probeUnit(const std::string &cache_path) {
+  auto state = std::make_shared<ProbeState>();
+  state->cache_path = cache_path;
+  state->key = target_ip_ + ":" + std::to_string(port_);
+
+  UnitInfo cached;
+  if (!cache_path.empty() && loadUnitCache(cache_path, state->key, cached)) {
+    {
+      std::lock_guard<std::mutex> lock(unit_mutex_);
+      unit_info_ = cached;
+    }
+    LOG_F(INFO, "Unit %s from cache, firmware %s", state->key.c_str(),
+          cached.firmware.c_str());
+
+    // 后台核对固件版本，变化时重新探测
+    int timeout_ms, retries;
+    {
+      std::lock_guard<std::mutex> lock(pending_mutex_);
+      timeout_ms = async_timeout_ms_;
+      retries = async_retries_;
+    }
+    std::string cmd = tp::encodeRead<tp::Id::VER>();
+    submit(cmd, timeout_ms, retries,
+           [this, state, firmware = cached.firmware](
+               const CommandRecord &record) {
+             if (record.state != CommandState::CONFIRMED)
+               return;
+             std::string current(frameData(record.response));
+             if (current == firmware)
+               return;
+             LOG_F(WARNING, "Firmware changed %s -> %s, probe again",
+                   firmware.c_str(), current.c_str());
+             startProbe(state);
+           });
+    return true;
+  }
+
+  std::future<void> done = state->done.get_future();
+  startProbe(state);
+  done.wait();
+
+  std::lock_guard<std::mutex> lock(unit_mutex_);
+  return !unit_info_.firmware.empty();
+}
 
-  return send(cmd, 999);
+GimbalCtrl::UnitInfo GimbalCtrl::getUnitInfo() {
+  std::lock_guard<std::mutex> lock(unit_mutex_);
+  return unit_info_;
 }
 
 /**
- * @brief 设置安装模式
+ * @brief 并行发出全部能力读指令，最后一条完成时更新云台信息并写缓存
  *
- * @param mode
- * @return true 吊装
- * @return false 竖装
+ * @param state 探测状态，由各完成回调共享
+ * @return std::vector<GimbalCtrl::CommandHandle> 已发出的指令
  */
-bool GimbalCtrl::setInstallMode(InstallMode mode) {
-  std::string cmd =
-      buildStaticCommand("U", "G", 'w', "PTZ", {static_cast<uint8_t>(mode)});
-  LOG_F(INFO, "setInstallMode cmd:%s", cmd.c_str());
+std::vector<GimbalCtrl::CommandHandle>
+GimbalCtrl::startProbe(std::shared_ptr<ProbeState> state) {
+  auto finish = [this, state] {
+    {
+      std::lock_guard<std::mutex> lock(unit_mutex_);
+      unit_info_ = state->info;
+    }
+    if (!state->cache_path.empty() && !state->info.firmware.empty() &&
+        !saveUnitCache(state->cache_path, state->key, state->info))
+      LOG_F(WARNING, "Failed to write unit cache %s",
+            state->cache_path.c_str());
+    state->done.set_value();
+  };
 
-  return send(cmd);
-}
+  int timeout_ms, retries;
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    timeout_ms = async_timeout_ms_;
+    retries = async_retries_;
+  }
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->info = UnitInfo();
+    state->remaining = std::size(kProbeIdentifiers);
+  }
 
-std::string GimbalCtrl::getFirmwareVersion() {
-  std::string cmd = buildStaticCommand("U", "D", 'r', "VER");
-  LOG_F(INFO, "getFirmwareVersion cmd:%s", cmd.c_str());
-  send(cmd);
-  std::string dummy = " ";
-  return dummy;
+  std::vector<CommandHandle> handles;
+  for (tp::Id identifier : kProbeIdentifiers) {
+    std::string cmd = tp::encodeRead(identifier);
+    CommandHandle handle = submit(
+        cmd, timeout_ms, retries,
+        [state, finish](const CommandRecord &record) {
+          bool last;
+          {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (record.state == CommandState::CONFIRMED) {
+              std::string data(frameData(record.response));
+              state->info.capabilities[record.identifier] = data;
+              if (tp::lookup(record.identifier) == tp::Id::VER)
+                state->info.firmware = data;
+            }
+            last = --state->remaining == 0;
+          }
+          if (last)
+            finish();
+        });
+
+    if (handle != 0) {
+      handles.push_back(handle);
+      continue;
+    }
+
+    // 未发出的指令不会回调，直接计入完成
+    bool last;
+    {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      last = --state->remaining == 0;
+    }
+    if (last)
+      finish();
+  }
+  return handles;
 }
 
 /**
@@ -195,29 +2205,36 @@ std::string GimbalCtrl::getFirmwareVersion() {
  * @param dest_addr
  * @param control_type
  * @param identifier
- * @param data
- * @return std::string
+ * @param data 不超过 tp::kMaxDataLen 个字符
+ * @return std::string 数据超长时为空，与 tp::encodeWrite 一致
  */
 std::string GimbalCtrl::buildCommand(const std::string &source_addr,
                                      const std::string &dest_addr,
                                      char control_type,
                                      const std::string &identifier,
                                      const std::string &data) {
+  if (data.length() > tp::kMaxDataLen) {
+    LOG_F(ERROR, "buildCommand: %s data of %zu chars exceeds %zu",
+          identifier.c_str(), data.length(), tp::kMaxDataLen);
+    return std::string();
+  }
+
   std::ostringstream cmd;
 
   // 帧头 + 地址位
   cmd << "#tp" << source_addr << dest_addr;
 
-  // 数据长度 (标识符 3 + 数据长度)
-  uint8_t len = static_cast<uint8_t>(3 + data.length());
-  cmd << std::hex << std::setw(1) << static_cast<int>(len);
+  // 数据长度，仅一位，如 #tpUDDwIPV192.168.31.22D7 中的 D 为 13 个数据字符
+  cmd << std::hex << std::uppercase << std::setw(1)
+      << static_cast<int>(data.length());
 
   // 控制位 + 标识位 + 数据
   cmd << control_type << identifier << data;
 
   // 计算校验和
   uint8_t crc = calculateChecksum(cmd.str());
-  cmd << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(crc);
+  cmd << std::hex << std::uppercase << std::setw(2) << std::setfill('0')
+      << static_cast<int>(crc);
 
   return cmd.str();
 }
@@ -229,8 +2246,8 @@ std::string GimbalCtrl::buildCommand(const std::string &source_addr,
  * @param dest_addr
  * @param control_type
  * @param identifier
- * @param data
- * @return std::string
+ * @param data 不超过 tp::kMaxDataLen / 2 字节
+ * @return std::string 数据超长时为空
  */
 std::string GimbalCtrl::buildDynamicCommand(const std::string &source_addr,
                                             const std::string &dest_addr,
@@ -244,6 +2261,12 @@ std::string GimbalCtrl::buildDynamicCommand(const std::string &source_addr,
   //     data_buf.assign(1, 0); // 不足 2 字节时填充 0
   //   }
 
+  if (data.size() * 2 > tp::kMaxDataLen) {
+    LOG_F(ERROR, "buildDynamicCommand: %s data of %zu bytes exceeds %zu",
+          identifier.c_str(), data.size(), tp::kMaxDataLen / 2);
+    return std::string();
+  }
+
   std::ostringstream cmd;
 
   cmd << "#TP" << source_addr << dest_addr;
@@ -315,7 +2338,7 @@ std::string GimbalCtrl::buildStaticCommand(const std::string &source_addr,
   return cmd.str();
 }
 
-uint8_t GimbalCtrl::calculateChecksum(const std::string &frame) {
+uint8_t GimbalCtrl::calculateChecksum(std::string_view frame) {
   uint8_t crc = 0;
   for (char c : frame) {
     crc += static_cast<uint8_t>(c);
@@ -330,41 +2353,58 @@ std::string GimbalCtrl::hexEncode(int32_t value, int num_digits) {
 }
 
 bool GimbalCtrl::sendAndVerify(const std::string &command) {
-  std::lock_guard<std::mutex> lock(socket_mutex_);
-
-  try {
-    // 发送命令
-    sock_.sendTo(command.data(), command.size(), target_ip_, port_);
+  CommandHandle handle = submit(command, 1000, 0);
+  CommandRecord record;
+  if (!waitCommand(handle, record))
+    return false;
 
-    // 接收响应
-    const int BUFFER_SIZE = 256;
-    char buffer[BUFFER_SIZE];
-    std::string sourceAddr;
-    unsigned short sourcePort;
+  LOG_F(INFO, "Received response: %s", record.response.c_str());
+  return true;
+}
 
-    int received = sock_.recvFrom(buffer, BUFFER_SIZE, sourceAddr, sourcePort);
-    if (received <= 0)
+bool GimbalCtrl::send(const std::string &command, int timeout_ms) {
+  if (timeout_ms <= 0) {
+    Clock::time_point issued_at = Clock::now();
+    std::lock_guard<std::mutex> lock(socket_mutex_);
+    if (commandExpired(command, issued_at))
       return false;
-
-    std::string response(buffer, received);
-
-    LOG_F(INFO, "Received response: %s", response.c_str());
-
-    // 验证响应
-    if (response.find("ERE!!") != std::string::npos) {
+    try {
+      transport_->sendTo(command, target_ip_, port_);
+      LOG_F(INFO, "Send command: %s", command.c_str());
+      cacheFrame(command, false, Clock::now());
+      return true;
+    } catch (SocketException &e) {
+      if (error_callback_) {
+        error_callback_(e.what());
+      }
       return false;
     }
+  }
 
-    // 检查地址交换
-    if (response.length() < 5)
-      return false;
-    if (response.substr(3, 2) != command.substr(5, 2) ||
-        response.substr(5, 2) != command.substr(3, 2)) {
-      return false;
-    }
+  CommandHandle handle = submit(command, timeout_ms, 0);
+  CommandRecord record;
+  if (!waitCommand(handle, record)) {
+    LOG_F(ERROR, "Receive failed, timeout or error");
+    return false;
+  }
 
-    return true;
+  LOG_F(INFO, "Received response: %s", record.response.c_str());
+  return true;
+}
 
+// 流式指令：只发不等，逐帧日志降为 1 级，供定时器线程周期下发
+bool GimbalCtrl::stream(const std::string &command,
+                        Clock::time_point issued_at) {
+  if (issued_at == Clock::time_point{})
+    issued_at = Clock::now();
+  std::lock_guard<std::mutex> lock(socket_mutex_);
+  if (commandExpired(command, issued_at))
+    return false;
+  try {
+    transport_->sendTo(command, target_ip_, port_);
+    LOG_F(1, "Stream command: %s", command.c_str());
+    cacheFrame(command, false, Clock::now());
+    return true;
   } catch (SocketException &e) {
     if (error_callback_) {
       error_callback_(e.what());
@@ -373,117 +2413,998 @@ bool GimbalCtrl::sendAndVerify(const std::string &command) {
   }
 }
 
-bool GimbalCtrl::send(const std::string &command, int timeout_ms) {
-  std::lock_guard<std::mutex> lock(socket_mutex_);
+/**
+ * @brief 运动指令的时效检查，过期时计入统计，调用方持有 socket_mutex_
+ * 非零速率与角度指令自请求起超过 command_deadline_ms 即过期；
+ * 零速率为停止指令，任何时候发出都是安全的，不设期限
+ *
+ * @param command 完整帧
+ * @param issued_at 请求时刻
+ * @return true 已过期，不应发送
+ */
+bool GimbalCtrl::commandExpired(const std::string &command,
+                                Clock::time_point issued_at) {
+  int deadline_ms = command_deadline_ms_.load(std::memory_order_relaxed);
+  if (deadline_ms <= 0 || command.size() < 12 || command[6] != 'w')
+    return false;
 
+  switch (tp::frameId(command)) {
+  case tp::Id::GSY:
+  case tp::Id::GSP:
+    if (command.compare(10, 2, "00") == 0)
+      return false;
+    break;
+  case tp::Id::GAY:
+  case tp::Id::GAP:
+  case tp::Id::GAR:
+    break;
+  default:
+    return false;
+  }
+
+  Clock::duration late = Clock::now() - issued_at;
+  if (late <= std::chrono::milliseconds(deadline_ms))
+    return false;
+  LOG_F(WARNING, "Drop expired command %s (issued %.1f ms ago)",
+        command.c_str(),
+        std::chrono::duration<double, std::milli>(late).count());
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  stats_.expired_dropped++;
+  return true;
+}
+
+bool GimbalCtrl::send(const std::string &command, std::string &response,
+                      int timeout_ms) {
+  if (timeout_ms <= 0)
+    return send(command, timeout_ms);
+
+  CommandHandle handle = submit(command, timeout_ms, 0);
+  CommandRecord record;
+  bool ok = waitCommand(handle, record);
+  if (!ok)
+    LOG_F(ERROR, "Receive failed, timeout or error");
+
+  response.assign(record.response.data(), record.response.size());
+  return ok;
+}
+
+/**
+ * @brief 登记待确认指令并立即发送
+ *
+ * @param command 完整帧
+ * @param timeout_ms 单次等待应答超时
+ * @param retries 超时后的重发次数
+ * @param callback 完成回调
+ * @param issued_at 请求时刻，默认为调用时刻
+ * @return GimbalCtrl::CommandHandle 指令过期或发送失败返回 0
+ */
+GimbalCtrl::CommandHandle GimbalCtrl::submit(const std::string &command,
+                                             int timeout_ms, int retries,
+                                             CommandCallback callback,
+                                             Clock::time_point issued_at) {
+  PendingCommand pending;
+  pending.frame = command;
+  pending.dest_ip = target_ip_;
+  pending.timeout_ms = timeout_ms;
+  pending.retries_left = retries;
+  pending.issued_at = issued_at;
+  pending.callback = std::move(callback);
+  return submitPending(std::move(pending));
+}
+
+/**
+ * @brief 登记编组指令并发往编组地址
+ *
+ * @param command 完整帧
+ * @param expected_units 期望应答数，0 为收集至超时
+ * @param callback 完成回调
+ * @return GimbalCtrl::CommandHandle 未设置编组地址或发送失败返回 0
+ */
+GimbalCtrl::CommandHandle GimbalCtrl::submitGroup(const std::string &command,
+                                                  size_t expected_units,
+                                                  CommandCallback callback) {
+  PendingCommand pending;
+  {
+    std::lock_guard<std::mutex> lock(socket_mutex_);
+    pending.dest_ip = group_ip_;
+  }
+  if (pending.dest_ip.empty()) {
+    LOG_F(ERROR, "Group address not set");
+    return 0;
+  }
+
+  pending.frame = command;
+  pending.group = true;
+  pending.expected_units = expected_units;
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    pending.timeout_ms = async_timeout_ms_;
+  }
+  pending.callback = std::move(callback);
+  return submitPending(std::move(pending));
+}
+
+/**
+ * @brief 登记待确认指令并立即发送
+ *
+ * @param pending 已填写帧、目的地址与超时参数的待确认指令
+ * @return GimbalCtrl::CommandHandle 指令过期或发送失败返回 0
+ */
+GimbalCtrl::CommandHandle GimbalCtrl::submitPending(PendingCommand pending) {
+  const std::string &command = pending.frame;
+  if (command.size() < 10)
+    return 0;
+  if (pending.issued_at == Clock::time_point{})
+    pending.issued_at = Clock::now();
+
+  // 链路断开时直接失败，不占用等待时间；编组指令不受单机链路状态影响
+  const bool group = pending.group;
+  bool probe = false;
+  if (!group && !admitCommand(Clock::now(), probe)) {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_.fast_failed++;
+    return 0;
+  }
+
+  // 回包地址位与发送帧互换，控制位与标识位保持一致
+  pending.match = command.substr(4, 1) + command.substr(3, 1) +
+                  command.substr(6, 4);
+  pending.record.identifier = command.substr(7, 3);
+  pending.record.attempts = 1;
+  pending.record.attitude = getAttitude();
+
+  std::string frame = pending.frame;
+  std::string dest_ip = pending.dest_ip;
+  CommandHandle handle = 0;
+
+  // 先清出接收队列中已有的数据报，它们不可能是本指令的回包；
+  // 清出的帧按接收序号排入 backlog_，与接收线程读到的帧按同一顺序分发
+  // 加锁顺序：rx_mutex_ -> socket_mutex_ -> pending_mutex_
+  std::unique_lock<std::mutex> rx_lock(rx_mutex_);
+  size_t drained = drainStale(backlog_);
+
+  // 持有 socket_mutex_ 登记，保证 tx_id 与实际发送顺序一致
+  std::unique_lock<std::mutex> sock_lock(socket_mutex_);
+  // 排队或等锁期间已超过期限的运动指令不登记、不发送
+  const bool expired = commandExpired(frame, pending.issued_at);
+  if (expired && probe) {
+    // 未发出的探测不占用探测名额
+    std::lock_guard<std::mutex> link_lock(link_mutex_);
+    probe_in_flight_ = false;
+  }
+  if (!expired) {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    handle = next_handle_++;
+    if (next_handle_ == 0)
+      next_handle_ = 1;
+    pending.record.handle = handle;
+    if (probe) {
+      // 在登记前记下探测指令，它的结果不会早于此处到达
+      std::lock_guard<std::mutex> link_lock(link_mutex_);
+      probe_handle_ = handle;
+    }
+    pending.record.sent_at = Clock::now();
+    pending.last_sent_at = pending.record.sent_at;
+    pending.tx_id = transport_->txCount();
+    pending.tx_epoch = tx_epoch_.load(std::memory_order_relaxed);
+    pending.rx_seq = rx_seq_;
+    pending.deadline =
+        pending.record.sent_at + std::chrono::milliseconds(pending.timeout_ms);
+    pending_.emplace(handle, std::move(pending));
+  }
+  rx_lock.unlock();
+
+  bool sent = !expired;
+  if (sent) {
+    try {
+      transport_->sendTo(frame, dest_ip, port_);
+      LOG_F(INFO, "Send command: %s -> %s", frame.c_str(), dest_ip.c_str());
+    } catch (SocketException &e) {
+      sent = false;
+      sock_lock.unlock();
+      {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        pending_.erase(handle);
+      }
+      if (error_callback_) {
+        error_callback_(e.what());
+      }
+    }
+  }
+  if (sock_lock.owns_lock())
+    sock_lock.unlock();
+  if (!group && !expired) {
+    if (sent)
+      cacheFrame(frame, false, Clock::now());
+    else
+      updateLink(false, Clock::now(), handle);
+  }
+
+  if (drained > 0) {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_.drained += drained;
+  }
+  // 清出的数据报仍可能是更早指令的回包，照常分发；正在分发的线程
+  // (含本线程在回调中嵌套提交的情形) 会接着处理，这里不再等待
+  rx_lock.lock();
+  bool dispatcher = !dispatching_ && !backlog_.empty();
+  if (dispatcher)
+    dispatching_ = true;
+  rx_lock.unlock();
+  if (dispatcher)
+    dispatchBacklog();
+
+  return sent ? handle : 0;
+}
+
+/**
+ * @brief 非阻塞清出接收队列，调用方需持有 rx_mutex_
+ *
+ * @param frames 追加清出的数据报及其接收序号
+ * @return size_t 清出的条数
+ */
+size_t GimbalCtrl::drainStale(std::vector<RxFrame> &frames) {
+  size_t count = 0;
   try {
-    // 发送命令
-    sock_.cleanUp();
-    sock_.sendTo(command.data(), command.size(), target_ip_, port_);
-    LOG_F(INFO, "Send command: %s", command.c_str());
-
-    // 接收响应
-    const int BUFFER_SIZE = 256;
-    char buffer[BUFFER_SIZE];
-    std::string sourceAddr;
-    unsigned short sourcePort;
-
-    if (timeout_ms <= 0) {
-      return true;
+    transport_->drain([&](std::string_view data, const sockaddr_in &source) {
+      frames.push_back(
+          RxFrame{rx_pool_->copy(data), source, ++rx_seq_, timespec{}});
+      count++;
+    });
+  } catch (SocketException &e) {
+    LOG_F(ERROR, "Socket error: %s", e.what());
+  }
+  return count;
+}
+
+/**
+ * @brief 按接收序号分发 backlog_ 中的帧，取空后交出分发权
+ * 调用方已在 rx_mutex_ 内置位 dispatching_，且不持有任何锁
+ *
+ * 同一时刻只有一个线程分发，帧按序号依次分发：两条相同指令在途时，
+ * 先到的回包总是先于后到的回包关联，不会被误判为过期回包
+ */
+void GimbalCtrl::dispatchBacklog() {
+  uint64_t unmatched = 0;
+  std::unique_lock<std::mutex> lock(rx_mutex_);
+  while (!backlog_.empty()) {
+    dispatch_frames_.swap(backlog_);
+    lock.unlock();
+    collectTxTimestamps();
+    for (const RxFrame &item : dispatch_frames_) {
+      if (!dispatch(item.frame, item.source, item.rx_stamp, item.seq))
+        unmatched++;
     }
+    dispatch_frames_.clear();
+    lock.lock();
+  }
+  dispatching_ = false;
+  lock.unlock();
 
-    // TODO 超时检测、校验
-    // int received = sock_.recvFrom(buffer, BUFFER_SIZE, sourceAddr,
-    // sourcePort);
-    int received = sock_.recvFromWithTimeout(buffer, sizeof(buffer), sourceAddr,
-                                             sourcePort, timeout_ms);
-    if (received <= 0) {
-      LOG_F(ERROR, "Receive failed, timeout or error");
-      return false;
+  if (unmatched > 0) {
+    std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+    stats_.unmatched += unmatched;
+  }
+}
+
+/**
+ * @brief 阻塞等待指令完成
+ *
+ * 等待期间完成的结果保留在 awaited_ 中直到取走，不会被之后的完成记录挤出；
+ * 开始等待前已完成的指令从最近完成记录中查找
+ *
+ * @param handle
+ * @param record 输出完成记录；超时时 state 为 PENDING，记录已被淘汰时为
+ * EXPIRED
+ * @param timeout_ms 最长等待时间，小于 0 时不限时
+ * @return true 已确认
+ * @return false 失败、超时、记录已被淘汰或句柄无效
+ */
+bool GimbalCtrl::waitCommand(CommandHandle handle, CommandRecord &record,
+                             int timeout_ms) {
+  if (handle == 0)
+    return false;
+
+  // 移出 pending_ 与写入 completed_、awaited_ 在同一临界区内完成
+  std::unique_lock<std::mutex> lock(pending_mutex_);
+  if (pending_.count(handle) == 0)
+    return findRecord(handle, record) &&
+           record.state == CommandState::CONFIRMED;
+
+  Awaited &awaited = awaited_[handle];
+  awaited.waiters++;
+  auto done = [&] { return awaited.done; };
+  if (timeout_ms < 0)
+    pending_cv_.wait(lock, done);
+  else
+    pending_cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), done);
+
+  if (awaited.done)
+    record = awaited.record;
+  else
+    findRecord(handle, record);
+  if (--awaited.waiters == 0)
+    awaited_.erase(handle);
+  return record.state == CommandState::CONFIRMED;
+}
+
+/**
+ * @brief 接收线程：收取所有回包并关联到等待中的指令，同时处理超时重发
+ */
+void GimbalCtrl::rxLoop() {
+  // 回包在传输层缓冲区内原地解析
+  while (running_) {
+    unsigned int received = 0;
+    uint64_t seq = 0;
+    bool dispatcher = false;
+    try {
+      // 等待时不持锁；数据报可能已被发送方清出，因此读取为非阻塞
+      bool readable = transport_->poll(kRxPollMs);
+      std::lock_guard<std::mutex> lock(rx_mutex_);
+      if (readable) {
+        received = static_cast<unsigned int>(transport_->receive());
+        seq = rx_seq_ + 1;
+        rx_seq_ += received;
+      }
+      if (dispatching_) {
+        // 其他线程正在分发：本批排在其后由它分发，视图在下次读取前复制
+        for (unsigned int i = 0; i < received; i++) {
+          RxDatagram dgram = transport_->datagram(i);
+          backlog_.push_back(RxFrame{rx_pool_->copy(dgram.data), dgram.source,
+                                     seq + i, dgram.rx_stamp});
+        }
+        received = 0;
+      } else {
+        // 发送方清出、尚未分发的帧序号更小，先于本批分发
+        dispatching_ = true;
+        dispatcher = true;
+        dispatch_frames_.swap(backlog_);
+      }
+    } catch (SocketException &e) {
+      LOG_F(ERROR, "Socket error: %s", e.what());
+      std::this_thread::sleep_for(std::chrono::milliseconds(kRxPollMs));
+    }
+
+    if (dispatcher) {
+      // 回包之前的发送时间戳必然已入错误队列
+      collectTxTimestamps();
+      uint64_t unmatched = 0;
+      for (const RxFrame &item : dispatch_frames_) {
+        if (!dispatch(item.frame, item.source, item.rx_stamp, item.seq))
+          unmatched++;
+      }
+      dispatch_frames_.clear();
+      for (unsigned int i = 0; i < received; i++) {
+        RxDatagram dgram = transport_->datagram(i);
+        if (!dispatch(dgram.data, dgram.source, dgram.rx_stamp, seq + i))
+          unmatched++;
+      }
+      if (unmatched > 0) {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.unmatched += unmatched;
+      }
+      // 分发期间其他线程清出的帧序号更大，接着分发
+      dispatchBacklog();
     }
 
-    std::string response(buffer, received);
+    Clock::time_point now = Clock::now();
+    expirePending(now);
+    heartbeat(now);
+  }
+}
+
+/**
+ * @brief 校验帧头、长度与校验和
+ *
+ * @param frame
+ * @return true
+ * @return false
+ */
+bool GimbalCtrl::validateFrame(std::string_view frame) {
+  if (frame.size() < 12)
+    return false;
+  if (frame.compare(0, 3, "#TP") != 0 && frame.compare(0, 3, "#tp") != 0)
+    return false;
+
+  uint32_t crc;
+  if (!parseHex(frame.substr(frame.size() - 2), crc))
+    return false;
+
+  return calculateChecksum(frame.substr(0, frame.size() - 2)) ==
+         static_cast<uint8_t>(crc);
+}
+
+/**
+ * @brief 分发一帧回包
+ *
+ * @param frame
+ * @param source 源地址
+ * @param rx_stamp 内核接收时间戳，无则为零
+ * @param seq 接收序号
+ * @return true 已被消费 (姿态帧、确认帧或识别出的过期回包)
+ * @return false 无对应指令
+ */
+bool GimbalCtrl::dispatch(std::string_view frame, const sockaddr_in &source,
+                          const timespec &rx_stamp, uint64_t seq) {
+  Clock::time_point now = Clock::now();
+  const int frame_len = static_cast<int>(frame.size());
 
-    LOG_F(INFO, "Received response: %s", response.c_str());
+  if (!validateFrame(frame)) {
+    LOG_F(WARNING, "Drop invalid frame: %.*s", frame_len, frame.data());
+    return false;
+  }
 
+  // 主动送出的帧无对应指令，直接处理；同一端口上其他单元 (编组成员等)
+  // 的推送不属于本机，不进入姿态、估计器与链路状态
+  tp::Id id = tp::frameId(frame);
+  tp::Reply reply =
+      id == tp::Id::COUNT ? tp::Reply::ECHO : tp::describe(id).reply;
+  const bool own = fromHost(source, target_ip_);
+  if (reply == tp::Reply::PUSH) {
+    if (id == tp::Id::GAC && own)
+      handleAttitude(frame, now);
+    else if (!own)
+      LOG_F(1, "Ignore push from %s: %.*s", addressString(source).c_str(),
+            frame_len, frame.data());
     return true;
+  }
 
-  } catch (SocketException &e) {
-    if (error_callback_) {
-      error_callback_(e.what());
+  std::unique_lock<std::mutex> lock(pending_mutex_);
+
+  // 错误应答不携带标识位，按地址位关联到最早的待确认指令
+  bool is_error = reply == tp::Reply::ERROR;
+  std::string_view addr = frame.substr(3, 2);
+  std::string_view ctrl_id = frame.substr(6, 4);
+  std::string source_ip = addressString(source);
+  bool stale = false;
+
+  // 先匹配发往该单元的单机指令，再匹配编组指令：单机指令的回包不会被
+  // 更早的同类编组指令收走，编组成员的错误应答也不会使单机指令失败
+  auto found = pending_.end();
+  for (bool group : {false, true}) {
+    for (auto it = pending_.begin(); it != pending_.end(); ++it) {
+      const PendingCommand &pending = it->second;
+      std::string_view match = pending.match;
+      if (pending.group != group || match.substr(0, 2) != addr ||
+          (!is_error && match.substr(2) != ctrl_id))
+        continue;
+      if (!group && !fromHost(source, pending.dest_ip))
+        continue;
+
+      // 在指令登记前就已读出的回包属于之前超时的同类指令
+      if (seq <= pending.rx_seq) {
+        stale = true;
+        continue;
+      }
+
+      // 编组指令每个单元只记录第一帧应答
+      if (group && pending.record.replies.count(source_ip))
+        continue;
+      found = it;
+      break;
     }
-    return false;
+    if (found != pending_.end())
+      break;
   }
-}
 
-// bool GimbalCtrl::send(const std::string &command, std::string &response,
-//                       int timeout_ms) {
-//   std::lock_guard<std::mutex> lock(socket_mutex_);
+  if (found != pending_.end()) {
+    PendingCommand &pending = found->second;
+    if (pending.group) {
+      // 编组指令按源地址收集，错误应答同样计为该单元的应答
+      pending.record.replies.emplace(source_ip, std::string(frame));
+      if (is_error) {
+        pending.record.rejected++;
+        LOG_F(WARNING, "Group command rejected by %s: %s", source_ip.c_str(),
+              pending.frame.c_str());
+      } else {
+        recordRtt(pending.record, pending, rx_stamp, now);
+      }
+      if (pending.expected_units == 0 ||
+          pending.record.replies.size() < pending.expected_units)
+        return true;
+    } else if (is_error) {
+      LOG_F(ERROR, "Command rejected: %s -> %.*s", pending.frame.c_str(),
+            frame_len, frame.data());
+    } else {
+      recordRtt(pending.record, pending, rx_stamp, now);
+    }
 
-//   try {
-//     // 发送命令
-//     sock_.cleanUp();
-//     sock_.sendTo(command.data(), command.size(), target_ip_, port_);
-//     LOG_F(INFO, "Send command: %s", command.c_str());
+    bool failed = is_error || pending.record.rejected > 0;
+    PendingCommand done = std::move(pending);
+    pending_.erase(found);
+    complete(done, failed ? CommandState::FAILED : CommandState::CONFIRMED,
+             rx_pool_->copy(frame), now);
+    auto global_callback = command_callback_;
+    lock.unlock();
 
-//     // 接收响应
-//     const int BUFFER_SIZE = 256;
-//     char buffer[BUFFER_SIZE];
-//     std::string sourceAddr;
-//     unsigned short sourcePort;
+    if (!done.group && !is_error)
+      cacheFrame(frame, true, now);
 
-//     if (timeout_ms <= 0) {
-//       return true;
-//     }
+    notifyComplete(done, global_callback.get());
+    return true;
+  }
+  lock.unlock();
 
-//     // TODO 超时检测、校验
-//     int received = sock_.recvFrom(buffer, BUFFER_SIZE, sourceAddr,
-//     sourcePort); if (received <= 0)
-//       return false;
+  if (stale) {
+    LOG_F(WARNING, "Discard stale response: %.*s", frame_len, frame.data());
+    std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+    stats_.stale_discarded++;
+    return true;
+  }
 
-//     std::string _response(buffer, received);
-//     response = _response;
-//     LOG_F(INFO, "Received response: %s", response.c_str());
+  // 不等待应答的指令 (如角度指令) 的回显同样是确认，属正常情况；
+  // 只有本机的回显更新状态缓存
+  if (own)
+    cacheFrame(frame, true, now);
+  LOG_F(1, "Unmatched response: %.*s", frame_len, frame.data());
+  return false;
+}
 
-//     return true;
+/**
+ * @brief 处理超时：还有重发次数则原帧重发，否则标记失败
+ *
+ * @param now
+ */
+void GimbalCtrl::expirePending(Clock::time_point now) {
+  std::vector<PendingCommand> expired;
+  std::vector<std::string> errors;
+  std::shared_ptr<const CommandCallback> global_callback;
+
+  {
+    // 与 submitPending 相同的加锁顺序：socket_mutex_ -> pending_mutex_
+    std::lock_guard<std::mutex> sock_lock(socket_mutex_);
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    global_callback = command_callback_;
+    for (auto it = pending_.begin(); it != pending_.end();) {
+      PendingCommand &pending = it->second;
+      if (now < pending.deadline) {
+        ++it;
+        continue;
+      }
+
+      // 重发同样受期限约束，过期的运动指令按超时失败处理
+      if (pending.retries_left > 0 &&
+          !commandExpired(pending.frame, pending.issued_at)) {
+        pending.retries_left--;
+        pending.record.attempts++;
+        pending.deadline = now + std::chrono::milliseconds(pending.timeout_ms);
+        pending.last_sent_at = now;
+        pending.tx_id = transport_->txCount();
+        pending.tx_epoch = tx_epoch_.load(std::memory_order_relaxed);
+        try {
+          transport_->sendTo(pending.frame, pending.dest_ip, port_);
+          LOG_F(WARNING, "Resend command: %s", pending.frame.c_str());
+        } catch (SocketException &e) {
+          errors.push_back(e.what());
+        }
+        ++it;
+        continue;
+      }
+
+      // 不限应答数的编组指令以超时为收集结束，收到应答且无单元拒绝即为确认
+      if (pending.group && pending.expected_units == 0 &&
+          !pending.record.replies.empty()) {
+        complete(pending,
+                 pending.record.rejected == 0 ? CommandState::CONFIRMED
+                                              : CommandState::FAILED,
+                 RxBufferRef(), now);
+      } else {
+        LOG_F(WARNING, "Command timeout: %s", pending.frame.c_str());
+        complete(pending, CommandState::FAILED, RxBufferRef(), now);
+      }
+      expired.push_back(std::move(pending));
+      it = pending_.erase(it);
+    }
+  }
 
-//   } catch (SocketException &e) {
-//     if (error_callback_) {
-//       error_callback_(e.what());
-//     }
-//     return false;
-//   }
-// }
+  if (error_callback_) {
+    for (const auto &error : errors)
+      error_callback_(error);
+  }
 
-bool GimbalCtrl::send(const std::string &command, std::string &response,
-                      int timeout_ms) {
-  std::lock_guard<std::mutex> lock(socket_mutex_);
+  for (const auto &pending : expired)
+    notifyComplete(pending, global_callback.get());
+}
 
+/**
+ * @brief 读取错误队列中的内核发送时间戳，仅由持有分发权的线程调用
+ */
+void GimbalCtrl::collectTxTimestamps() {
+  uint32_t epoch = tx_epoch_.load(std::memory_order_acquire);
+  if (epoch != tx_stamps_epoch_) {
+    tx_stamps_.clear();
+    tx_stamps_epoch_ = epoch;
+  }
+  uint32_t tx_id;
+  timespec tx_stamp;
   try {
-    // 发送命令
-    sock_.sendTo(command.data(), command.size(), target_ip_, port_);
+    while (transport_->readTxTimestamp(tx_id, tx_stamp)) {
+      tx_stamps_[tx_id] = tx_stamp;
+      if (tx_stamps_.size() > kTxStampHistory)
+        tx_stamps_.erase(tx_stamps_.begin());
+    }
+  } catch (SocketException &e) {
+    LOG_F(ERROR, "Socket error: %s", e.what());
+  }
+}
 
-    if (timeout_ms <= 0)
-      return true;
+/**
+ * @brief 计算往返时延并计入统计
+ * 收发两端都有内核时间戳时使用内核时间，否则退化为用户态时间
+ */
+void GimbalCtrl::recordRtt(CommandRecord &record, const PendingCommand &pending,
+                           const timespec &rx_stamp, Clock::time_point now) {
+  double rtt_us =
+      std::chrono::duration<double, std::micro>(now - pending.last_sent_at)
+          .count();
+  bool kernel = false;
+
+  if ((rx_stamp.tv_sec != 0 || rx_stamp.tv_nsec != 0) &&
+      pending.tx_epoch == tx_stamps_epoch_) {
+    auto it = tx_stamps_.find(pending.tx_id);
+    if (it != tx_stamps_.end()) {
+      rtt_us = elapsedUs(it->second, rx_stamp);
+      kernel = true;
+    }
+  }
 
-    // 接收响应
-    char buffer[256];
-    std::string sourceAddr;
-    unsigned short sourcePort;
+  record.rtt_us = rtt_us;
+  record.kernel_rtt = kernel;
+  if (telemetry_enabled_.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lock(telemetry_mutex_);
+    telemetry_.rtt(steadyNs(now), record.identifier.c_str(),
+                   static_cast<float>(rtt_us), kernel);
+  }
 
-    int received = sock_.recvFromWithTimeout(buffer, sizeof(buffer), sourceAddr,
-                                             sourcePort, timeout_ms);
+  size_t bucket = 0;
+  while (bucket + 1 < stats_.rtt_histogram.size() &&
+         rtt_us >= static_cast<double>(2ull << bucket))
+    bucket++;
+
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  if (stats_.rtt_samples == 0 || rtt_us < stats_.rtt_min_us)
+    stats_.rtt_min_us = rtt_us;
+  stats_.rtt_max_us = std::max(stats_.rtt_max_us, rtt_us);
+  stats_.rtt_sum_us += rtt_us;
+  stats_.rtt_samples++;
+  if (kernel)
+    stats_.kernel_rtt_samples++;
+  stats_.rtt_histogram[bucket]++;
+}
 
-    if (received <= 0) {
-      LOG_F(ERROR, "Receive failed, timeout or error");
-      return false;
+/**
+ * @brief 记录指令完成结果，调用方需持有 pending_mutex_
+ */
+void GimbalCtrl::complete(PendingCommand &pending, CommandState state,
+                          RxBufferRef response, Clock::time_point now) {
+  pending.record.state = state;
+  pending.record.completed_at = now;
+  pending.record.response = std::move(response);
+
+  // 覆盖同一槽位上更早的记录，不分配内存
+  completed_[pending.record.handle % kCompletedHistory] = pending.record;
+  if (!awaited_.empty()) {
+    auto it = awaited_.find(pending.record.handle);
+    if (it != awaited_.end()) {
+      it->second.done = true;
+      it->second.record = pending.record;
     }
+  }
+}
+
+/**
+ * @brief 唤醒阻塞等待者并调用完成回调，调用方不得持有 pending_mutex_
+ */
+void GimbalCtrl::notifyComplete(const PendingCommand &pending,
+                                const CommandCallback *global_callback) {
+  pending_cv_.notify_all();
+
+  if (!pending.group)
+    updateLink(pending.record.state == CommandState::CONFIRMED,
+               pending.record.completed_at, pending.record.handle);
+
+  if (pending.callback)
+    pending.callback(pending.record);
+  if (global_callback != nullptr && *global_callback)
+    (*global_callback)(pending.record);
+}
+
+/**
+ * @brief 解析云台姿态主动送出帧
+ * #TPUGCrGACY0Y1Y2Y3P0P1P2P3R0R1R2R3CC，单位 0.01 度，16 位有符号数
+ */
+void GimbalCtrl::handleAttitude(std::string_view frame,
+                                Clock::time_point now) {
+  if (frame.size() < 10 + 12 + 2)
+    return;
+
+  uint32_t yaw, pitch, roll;
+  if (!parseHex(frame.substr(10, 4), yaw) ||
+      !parseHex(frame.substr(14, 4), pitch) ||
+      !parseHex(frame.substr(18, 4), roll))
+    return;
+
+  Attitude attitude;
+  std::shared_ptr<const AttitudeCallback> callback;
+  {
+    std::lock_guard<std::mutex> lock(attitude_mutex_);
+    attitude_.yaw = static_cast<int16_t>(yaw) / 100.0f;
+    attitude_.pitch = static_cast<int16_t>(pitch) / 100.0f;
+    attitude_.roll = static_cast<int16_t>(roll) / 100.0f;
+    attitude_.stamp = now;
+    attitude = attitude_;
+    callback = attitude_callback_;
+    estimator_.addMeasurement({attitude.yaw, attitude.pitch, attitude.roll},
+                              now);
+    // 历史按采样时刻索引；写端由 attitude_mutex_ 串行
+    history_.load(std::memory_order_relaxed)
+        ->push(now - std::chrono::milliseconds(
+                         estimator_.params().telemetry_latency_ms),
+               {attitude.yaw, attitude.pitch, attitude.roll});
+  }
+  if (telemetry_enabled_.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lock(telemetry_mutex_);
+    telemetry_.attitude(steadyNs(now), attitude.yaw, attitude.pitch,
+                        attitude.roll);
+  }
+  if (callback)
+    (*callback)(attitude);
+  publishState();
+
+  // 姿态推送同样说明链路可用
+  updateLink(true, now);
+}
+
+/**
+ * @brief 把下发的运动指令交给姿态估计器
+ *
+ * @param frame 完整帧
+ * @param now 发送时间
+ */
+void GimbalCtrl::estimateCommand(std::string_view frame,
+                                 Clock::time_point now) {
+  if (frame[6] != 'w')
+    return;
+
+  tp::Id id = tp::frameId(frame);
+  uint32_t raw;
+  switch (id) {
+  case tp::Id::GSY:
+  case tp::Id::GSP: {
+    if (!parseHex(frame.substr(10, 2), raw))
+      return;
+    float rate = static_cast<int8_t>(raw) * kRateUnit;
+    std::lock_guard<std::mutex> lock(attitude_mutex_);
+    estimator_.addRateCommand(id == tp::Id::GSY ? AttitudeEstimator::YAW
+                                                : AttitudeEstimator::PITCH,
+                              rate, now);
+    break;
+  }
+  case tp::Id::GAY:
+  case tp::Id::GAP:
+  case tp::Id::GAR: {
+    std::lock_guard<std::mutex> lock(attitude_mutex_);
+    estimator_.addAngleCommand(id == tp::Id::GAY   ? AttitudeEstimator::YAW
+                               : id == tp::Id::GAP ? AttitudeEstimator::PITCH
+                                                   : AttitudeEstimator::ROLL,
+                               now);
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+/**
+ * @brief 把下发的写指令记入遥测，速率与角度换算为物理量
+ *
+ * @param frame 完整帧
+ * @param now 发送时间
+ */
+void GimbalCtrl::logCommand(std::string_view frame, Clock::time_point now) {
+  if (frame[6] != 'w' || !telemetry_enabled_.load(std::memory_order_acquire))
+    return;
+
+  std::string_view data = frame.substr(10, frame.size() - 12);
+  uint32_t raw = 0;
+  int32_t value = 0;
+  float physical;
+  switch (tp::frameId(frame)) {
+  case tp::Id::GSY:
+  case tp::Id::GSP:
+    if (parseHex(data.substr(0, 2), raw))
+      value = static_cast<int8_t>(raw);
+    physical = value * kRateUnit;
+    break;
+  case tp::Id::GAY:
+  case tp::Id::GAP:
+  case tp::Id::GAR:
+    if (parseHex(data.substr(0, 4), raw))
+      value = static_cast<int16_t>(raw);
+    physical = value / 100.0f;
+    break;
+  default:
+    // 其余指令记录数据域的数值，非数值数据域 (如地址) 记为 0
+    if (data.size() <= 8 && parseHex(data, raw))
+      value = static_cast<int32_t>(raw);
+    physical = static_cast<float>(value);
+    break;
+  }
+
+  char identifier[4] = {frame[7], frame[8], frame[9], 0};
+  std::lock_guard<std::mutex> lock(telemetry_mutex_);
+  telemetry_.command(steadyNs(now), identifier, physical, value);
+}
 
-    response.assign(buffer, received);
+/**
+ * @brief 断路器准入判断
+ * 断开期间每个探测间隔只放行一条指令 (半开)，其结果决定恢复或继续断开
+ *
+ * @param now
+ * @param probe 输出是否作为探测放行，是则调用方登记后填写 probe_handle_
+ * @return true 放行
+ * @return false 链路断开，指令应立即失败
+ */
+bool GimbalCtrl::admitCommand(Clock::time_point now, bool &probe) {
+  std::lock_guard<std::mutex> lock(link_mutex_);
+  if (link_state_ != LinkState::DOWN)
     return true;
 
-  } catch (SocketException &e) {
-    LOG_F(ERROR, "Socket error: %s", e.what());
+  if (probe_in_flight_ || now < next_probe_)
     return false;
+
+  probe = true;
+  probe_in_flight_ = true;
+  probe_handle_ = 0;
+  next_probe_ = now + std::chrono::milliseconds(probe_interval_ms_);
+  LOG_F(INFO, "Link down, send probe");
+  return true;
+}
+
+/**
+ * @brief 根据指令结果更新链路状态，状态变化时调用回调
+ * 调用方不得持有任何锁
+ *
+ * @param alive 收到确认或主动推送帧
+ * @param now
+ * @param handle 产生该结果的指令
+ */
+void GimbalCtrl::updateLink(bool alive, Clock::time_point now,
+                            CommandHandle handle) {
+  LinkState from, to;
+  LinkStateCallback callback;
+  {
+    std::lock_guard<std::mutex> lock(link_mutex_);
+    from = link_state_;
+    // 只有当前探测自身的结果结束探测，更早指令迟到的失败不放行新的探测
+    if (handle != 0 && handle == probe_handle_) {
+      probe_in_flight_ = false;
+      probe_handle_ = 0;
+    }
+    if (alive) {
+      consecutive_failures_ = 0;
+      last_alive_ = now;
+      link_state_ = LinkState::ALIVE;
+    } else {
+      consecutive_failures_++;
+      if (consecutive_failures_ >= down_after_failures_) {
+        // 新一轮断开：上一轮遗留的探测不再跟踪
+        if (from != LinkState::DOWN) {
+          probe_in_flight_ = false;
+          probe_handle_ = 0;
+        }
+        link_state_ = LinkState::DOWN;
+        next_probe_ = now + std::chrono::milliseconds(probe_interval_ms_);
+      } else {
+        link_state_ = LinkState::DEGRADED;
+      }
+    }
+    to = link_state_;
+    if (from != to)
+      callback = link_callback_;
+  }
+
+  if (from == to)
+    return;
+
+  static const char *names[] = {"UNKNOWN", "ALIVE", "DEGRADED", "DOWN"};
+  if (to == LinkState::ALIVE)
+    LOG_F(INFO, "Link state %s -> %s", names[static_cast<int>(from)],
+          names[static_cast<int>(to)]);
+  else
+    LOG_F(WARNING, "Link state %s -> %s", names[static_cast<int>(from)],
+          names[static_cast<int>(to)]);
+  if (callback)
+    callback(from, to);
+  publishState();
+}
+
+/**
+ * @brief 周期心跳，仅在接收线程中调用
+ * 链路断开时心跳经 admitCommand 成为半开探测
+ */
+void GimbalCtrl::heartbeat(Clock::time_point now) {
+  int interval_ms;
+  {
+    std::lock_guard<std::mutex> lock(link_mutex_);
+    if (heartbeat_ms_ <= 0 || now < next_heartbeat_)
+      return;
+    interval_ms = heartbeat_ms_;
+    next_heartbeat_ = now + std::chrono::milliseconds(interval_ms);
+  }
+
+  // 周期内录像状态已确认 (如调用方刚查询过)，无需额外探测
+  CachedValue recording =
+      loadCached(confirmed_state_[static_cast<size_t>(StateField::RECORDING)]);
+  if (getLinkState() == LinkState::ALIVE && recording.valid() &&
+      now - recording.stamp < std::chrono::milliseconds(interval_ms))
+    return;
+
+  // 读录像状态兼作心跳，应答同时刷新状态缓存
+  submit(tp::encodeRead<tp::Id::REC>(), interval_ms, 0);
+}
+
+/**
+ * @brief 将下发或收到的帧写入状态缓存
+ *
+ * @param frame 完整帧
+ * @param confirmed true 为云台应答 (确认值)，false 为下发指令
+ * @param now
+ */
+void GimbalCtrl::cacheFrame(std::string_view frame, bool confirmed,
+                            Clock::time_point now) {
+  if (frame.size() < 12)
+    return;
+  if (!confirmed) {
+    estimateCommand(frame, now);
+    logCommand(frame, now);
+  }
+
+  // 下发只缓存写指令；应答包括写指令回显与读指令应答
+  char ctrl = frame[6];
+  if (ctrl != 'w' && (!confirmed || ctrl != 'r'))
+    return;
+
+  size_t field;
+  int32_t value;
+  if (!cachedField(tp::frameId(frame), frame.substr(10, frame.size() - 12),
+                   field, value))
+    return;
+
+  std::atomic<uint64_t> &slot =
+      confirmed ? confirmed_state_[field] : commanded_state_[field];
+
+  // 录像切换指令：在已知确认状态上取反
+  if (field == static_cast<size_t>(StateField::RECORDING) &&
+      value == static_cast<int32_t>(RecordState::TOGGLE)) {
+    CachedValue known = loadCached(confirmed_state_[field]);
+    if (!known.valid())
+      return;
+    value = known.value ? 0 : 1;
   }
+
+  uint64_t stamp_ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(now - cache_epoch_)
+          .count() +
+      1;
+  slot.store(packCached(value, stamp_ms), std::memory_order_release);
+  if (confirmed)
+    publishState();
+}
+
+GimbalCtrl::CachedValue
+GimbalCtrl::loadCached(const std::atomic<uint64_t> &slot) {
+  uint64_t packed = slot.load(std::memory_order_acquire);
+  CachedValue cached;
+  uint64_t stamp_ms = packed & kCacheStampMask;
+  if (stamp_ms == 0)
+    return cached;
+
+  // 24 位有符号值
+  int32_t value = static_cast<int32_t>(packed >> kCacheStampBits);
+  if (value & 0x800000)
+    value -= 0x1000000;
+  cached.value = value;
+  cached.stamp = cache_epoch_ + std::chrono::milliseconds(stamp_ms - 1);
+  return cached;
 }
@@ -2,17 +2,41 @@
 #define __GIMBAL_CTRL_H__
 
 #include "loguru/loguru.hpp"
+#include "gimbal_estimator.h"
+#include "gimbal_export.h"
+#include "gimbal_history.h"
+#include "gimbal_motion.h"
+#include "gimbal_rx_buffer.h"
+#include "gimbal_scan.h"
+#include "gimbal_telemetry_writer.h"
+#include "gimbal_timer.h"
+#include "gimbal_transport.h"
 #include "practical_socket/PracticalSocket.h"
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <ctime>
+#include <deque>
 #include <functional>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <netinet/in.h>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 
-class GimbalCtrl {
+struct GimbalShmSegment;
+
+class GIMBAL_EXPORT GimbalCtrl {
 public:
+  using Clock = std::chrono::steady_clock;
+
   // 云台动作枚举
   enum class GimbalAction : uint8_t {
     STOP = 0x00,
@@ -72,28 +96,367 @@ public:
     uint8_t sharpness;  // 锐度 0-255
   };
 
+  // 云台姿态 (由 GAA 主动送出的 GAC 帧更新)
+  struct Attitude {
+    float yaw = 0.0f;   // 航向角 (deg)
+    float pitch = 0.0f; // 俯仰角 (deg)
+    float roll = 0.0f;  // 横滚角 (deg)
+    Clock::time_point stamp{}; // 采样时间，未收到过姿态时为默认值
+  };
+
+  // 异步指令句柄，0 为无效句柄
+  using CommandHandle = uint32_t;
+
+  // 异步指令状态
+  // EXPIRED：结果已被更新的完成记录挤出历史，无法再查询
+  enum class CommandState : uint8_t { PENDING, CONFIRMED, FAILED, EXPIRED };
+
+  // 异步指令跟踪记录
+  struct CommandRecord {
+    CommandHandle handle = 0;
+    std::string identifier; // 标识位，如 CAP、REC
+    CommandState state = CommandState::PENDING;
+    Clock::time_point sent_at{};      // 首次发送时间
+    Clock::time_point completed_at{}; // 确认/失败时间
+    Attitude attitude;                // 发送时刻的云台姿态
+    int attempts = 0;                 // 已发送次数
+    RxBufferRef response; // 确认帧，引用接收缓冲池中的槽位
+    std::map<std::string, std::string> replies; // 编组指令：源地址 -> 应答帧
+    size_t rejected = 0; // 编组指令：以错误帧 (ERE) 应答的单元数
+    double rtt_us = 0.0;     // 最后一次发送到确认帧的往返时延
+    bool kernel_rtt = false; // rtt_us 是否由内核收发时间戳计算
+  };
+
+  // 链路统计
+  struct LinkStats {
+    uint64_t rtt_samples = 0;
+    uint64_t kernel_rtt_samples = 0; // 其中使用内核时间戳的样本数
+    double rtt_min_us = 0.0;
+    double rtt_max_us = 0.0;
+    double rtt_sum_us = 0.0;
+    std::array<uint64_t, 21> rtt_histogram{}; // 第 i 桶: [2^i, 2^(i+1)) us
+    uint64_t drained = 0;         // 发送前从接收队列清出的数据报数
+    uint64_t stale_discarded = 0; // 早于对应指令发送、被丢弃的过期回包数
+    uint64_t unmatched = 0;       // 无对应待确认指令的回包数
+    uint64_t fast_failed = 0;     // 链路断开期间直接拒绝的指令数
+    uint64_t rx_buffer_misses = 0; // 接收缓冲池耗尽、退化为堆分配的回包数
+    uint64_t expired_dropped = 0; // 超过期限、发送前丢弃的运动指令数
+    uint64_t rate_refreshes = 0;  // 速率模式保活重发的帧数
+    uint64_t auto_stops = 0;      // 应用停止更新速率后自动停止的次数
+  };
+
+  // 链路状态：连续失败时 ALIVE -> DEGRADED -> DOWN，任一确认即恢复 ALIVE
+  enum class LinkState : uint8_t { UNKNOWN, ALIVE, DEGRADED, DOWN };
+
+  using LinkStateCallback = std::function<void(LinkState from, LinkState to)>;
+
+  // 状态缓存字段
+  enum class StateField : uint8_t {
+    RECORDING,    // 0 未录像，1 录像中
+    ZOOM,         // ZoomMode 绝对档位
+    COLOR_MODE,   // ColorMode
+    INSTALL_MODE, // InstallMode
+    YAW_TARGET,   // 目标角度，单位 0.01 度
+    PITCH_TARGET,
+    ROLL_TARGET,
+    COUNT
+  };
+
+  // 缓存的一个值及其时间，stamp 为默认值表示从未记录
+  struct CachedValue {
+    int32_t value = 0;
+    Clock::time_point stamp{};
+    bool valid() const { return stamp != Clock::time_point{}; }
+  };
+
+  // 网络发现到的云台
+  struct DiscoveredUnit {
+    std::string ip;
+    uint16_t port = 0;
+    std::string firmware; // VER 应答中的版本，如 V1.0.0
+    double rtt_ms = 0.0;  // 发往该地址的探测帧到首个应答的时间
+  };
+
+  // 启动探测得到的云台信息
+  struct UnitInfo {
+    std::string firmware;                            // VER，如 V1.0.0
+    std::map<std::string, std::string> capabilities; // 标识位 -> 读应答数据位
+  };
+
+  // 规划运动参数
+  struct MotionParams {
+    float max_rate = 60.0f;    // deg/s，不超过速率指令上限 63.5
+    float max_accel = 180.0f;  // deg/s^2
+    float max_jerk = 1800.0f;  // deg/s^3
+    int period_ms = 20;        // 速率指令下发周期
+    int lead_ms = 40;          // 速率前馈超前量，补偿云台速度响应滞后
+    float feedback_gain = 3.0f; // 1/s，按姿态误差修正速率
+    float lock_tolerance = 0.2f; // deg，角度锁定后判定到位的误差
+    int lock_timeout_ms = 1000;  // 角度锁定后等待到位的时间
+  };
+
+  // 运动指令时效与速率模式保活，各项为 0 时关闭
+  struct MotionGuard {
+    // 速率 (非零) 与角度指令自发出请求起超过该时长仍未发送则丢弃，
+    // 包括等待发送锁与定时器滞后的时间
+    int command_deadline_ms = 100;
+    int refresh_ms = 250; // 速率模式中量化值不变时的重发周期
+    // 超过该时长未调用 setGimbalSpeed 则自动下发零速率并退出速率模式
+    int feed_timeout_ms = 1000;
+  };
+
+  enum class MotionState : uint8_t {
+    IDLE,
+    STREAMING, // 按规划曲线下发速率指令
+    LOCKING,   // 已下发目标角度，等待姿态到位
+    SETTLED,   // 到位
+    TIMEOUT,   // 锁定后未在 lock_timeout_ms 内到位
+    STOPPED    // 被 stopMotion 或新的运动打断
+  };
+
+  struct MotionStatus {
+    MotionState state = MotionState::IDLE;
+    float yaw_target = 0.0f;
+    float pitch_target = 0.0f;
+    double planned_s = 0.0; // 规划的运动时长
+    Clock::time_point started_at{};
+    Clock::time_point finished_at{}; // 到位/超时/停止时间
+    uint64_t rate_commands = 0;      // 已下发的速率指令帧数
+    float max_tracking_error = 0.0f; // 流式阶段姿态偏离规划曲线的最大值 (deg)
+  };
+
+  struct SpeedStatus {
+    bool active = false;
+    float yaw_rate = 0.0f; // 设定速率 (deg/s)
+    float pitch_rate = 0.0f;
+    float yaw_error = 0.0f; // 设定速率与已下发速率的积分之差 (deg)
+    float pitch_error = 0.0f;
+    float error_max = 0.0f; // 速率模式开始以来 |error| 的最大值
+    uint64_t ticks = 0;
+    uint64_t rate_commands = 0; // 已下发的速率指令帧数，含保活重发
+    Clock::time_point started_at{};
+    Clock::time_point fed_at{}; // 最近一次 setGimbalSpeed
+  };
+
+  enum class ScanState : uint8_t {
+    IDLE,
+    RUNNING,
+    DONE,   // 时间表执行完毕
+    STOPPED // 被 stopScan、新的扫描或规划运动打断
+  };
+
+  // 扫描执行统计；拍照误差为触发时刻的预测姿态与航点的角距离
+  struct ScanStatus {
+    ScanState state = ScanState::IDLE;
+    size_t points = 0;
+    size_t point = 0;       // 正在执行的航点下标
+    double planned_s = 0.0; // 时间表总时长
+    Clock::time_point started_at{};
+    Clock::time_point finished_at{};
+    uint64_t rate_commands = 0;
+    uint64_t captures_planned = 0;
+    uint64_t captures_triggered = 0;
+    uint64_t captures_confirmed = 0;
+    uint64_t captures_failed = 0;
+    double trigger_late_max_us = 0.0; // 拍照指令发出晚于计划时刻
+    double trigger_late_sum_us = 0.0;
+    float position_error_max = 0.0f; // deg
+    float position_error_sum = 0.0f;
+  };
+
+  // 连拍/延时拍摄参数
+  struct BurstParams {
+    int count = 10;        // 张数，0 为持续拍摄直至 stopBurst (延时拍摄)
+    int interval_ms = 100; // 相邻两张的计划间隔
+    int delay_ms = 0;      // 第一张相对 startBurst 的延迟
+  };
+
+  // 连拍中的一张
+  struct Shot {
+    uint64_t index = 0;       // 本次连拍内的序号，从 0 开始
+    CommandHandle handle = 0; // 发送失败为 0
+    CommandState state = CommandState::PENDING;
+    Clock::time_point planned_at{};
+    Clock::time_point sent_at{};
+    Clock::time_point completed_at{}; // 确认/失败时间
+    Attitude attitude;                // 发送时刻的云台姿态
+    double rtt_us = 0.0;
+  };
+
+  using ShotCallback = std::function<void(const Shot &)>;
+
+  enum class BurstState : uint8_t {
+    IDLE,
+    RUNNING,
+    DONE,   // 全部张数已发出 (确认可能仍在途中)
+    STOPPED // 被 stopBurst 或新的连拍打断
+  };
+
+  struct BurstStatus {
+    BurstState state = BurstState::IDLE;
+    uint64_t planned = 0; // 0 为不限
+    uint64_t triggered = 0;
+    uint64_t confirmed = 0;
+    uint64_t failed = 0;
+    double late_max_us = 0.0; // 发出晚于计划时刻
+    double late_sum_us = 0.0;
+    Clock::time_point started_at{};  // 第一张的计划时刻
+    Clock::time_point finished_at{}; // 最后一张发出或停止的时间
+  };
+
+  // 最近下发值与最近经云台确认的值
+  struct CachedState {
+    CachedValue commanded;
+    CachedValue confirmed;
+  };
+
+  using CommandCallback = std::function<void(const CommandRecord &)>;
+
   explicit GimbalCtrl(const std::string &target_ip = "192.168.1.100",
                       uint16_t port = 5000);
+  /**
+   * @brief 使用指定传输层后端构造，如 IoUringTransport
+   */
+  GimbalCtrl(std::unique_ptr<GimbalTransport> transport,
+             const std::string &target_ip, uint16_t port = 5000);
   ~GimbalCtrl();
 
   // 云台控制接口
   bool controlGimbal(GimbalAction action);
+  // 速率模式：speed 为 deg/s，在定时器线程上每 period_ms (MotionParams)
+  // 调制一次 GSY/GSP。协议单位为 0.5 deg/s，量化误差以 sigma-delta 方式
+  // 累计到后续各拍，平均速率等于设定值，位置误差不超过半个单位 x 一个周期。
+  // 两轴均为 0 时立即下发零速率并中止速率模式、规划运动与扫描；
+  // 非零速率同样取代进行中的规划运动与扫描。
+  // 速率不变时每 refresh_ms 重发一次；应用须在 feed_timeout_ms 内再次调用，
+  // 否则自动停止 (见 MotionGuard)
   bool setGimbalSpeed(float yaw_speed, float pitch_speed);
+  SpeedStatus getSpeedStatus();
   bool setGimbalAngle(float yaw_angle, float pitch_angle, float roll_angle,
                       float speed = 10.0f);
 
+  // 规划运动接口：由当前姿态 (需先开启 GAA 姿态输出) 到目标角度规划
+  // 限加加速度的时间最优曲线，在定时器线程上以 GSY/GSP 速率指令流式执行，
+  // 结束时下发 GAY/GAP 锁定目标角度。两轴按较慢轴同时到达。
+  void setMotionParams(const MotionParams &params);
+  void setMotionGuard(const MotionGuard &guard);
+  bool moveGimbal(float yaw_angle, float pitch_angle); // 立即返回
+  bool waitMotion(int timeout_ms); // 到位返回 true
+  void stopMotion();               // 中止并下发零速率
+  MotionStatus getMotionStatus();
+
+  // 扫描接口：由当前姿态按 MotionParams 预先规划整个时间表，在定时器线程上
+  // 逐段流式运动、到位锁定，并在计划时刻异步拍照。与规划运动、速率模式互相取代
+  bool startScan(const ScanPattern &pattern); // 立即返回
+  bool waitScan(int timeout_ms);              // 执行完毕返回 true
+  void stopScan();                            // 中止并下发零速率
+  ScanStatus getScanStatus();
+
   // 媒体控制接口
   bool controlRecording(RecordState state);
   bool queryRecordingStatus();
+  // 缓存的确认值不超过 max_age_ms 时直接返回，否则查询云台
+  bool queryRecordingStatus(int max_age_ms);
   bool capturePhoto();
 
+  // 连拍/延时拍摄接口：在定时器线程上按绝对时刻 planned_at = 开始 +
+  // index x interval_ms 发出 CAP，不等待确认；确认在接收线程中异步记录。
+  // 为避免重复拍照，各张不重发，超时即记为失败
+  bool startBurst(const BurstParams &params, ShotCallback callback = nullptr);
+  // 全部发出且均已确认或失败后返回，全部确认返回 true
+  bool waitBurst(int timeout_ms);
+  void stopBurst(); // 停止后续拍摄，已发出的照片照常跟踪确认
+  BurstStatus getBurstStatus();
+  std::vector<Shot> getBurstShots(); // 最近 kBurstHistory 张
+
+  // 异步媒体控制接口：立即发帧并返回句柄，确认结果通过回调或 pollCommand 获取
+  // 注意：超时重发可能导致重复拍照
+  CommandHandle capturePhotoAsync(CommandCallback callback = nullptr);
+  CommandHandle controlRecordingAsync(RecordState state,
+                                      CommandCallback callback = nullptr);
+  bool pollCommand(CommandHandle handle, CommandRecord &record);
+  // timeout_ms < 0 不限时；等待期间的结果保留到取走，超时时 state 为 PENDING
+  bool waitCommand(CommandHandle handle, CommandRecord &record,
+                   int timeout_ms = -1);
+  void setCommandRetry(int timeout_ms, int retries);
+
+  // 编组控制接口：一帧发往组播/广播地址，按源地址收集各单元应答
+  // expected_units 为 0 时收集至超时；编组指令不重发
+  // 任一单元以错误帧应答时指令为 FAILED，replies 中记录该单元的错误帧
+  void setGroupAddress(const std::string &group_ip, unsigned char ttl = 1);
+  CommandHandle capturePhotoGroup(size_t expected_units = 0,
+                                  CommandCallback callback = nullptr);
+  CommandHandle controlRecordingGroup(RecordState state,
+                                      size_t expected_units = 0,
+                                      CommandCallback callback = nullptr);
+
+  // 链路时延统计接口
+  // 开启后往返时延使用内核收发时间戳，排除用户态调度抖动
+  bool setKernelTimestamping(bool enable);
+  LinkStats getLinkStats();
+  void resetLinkStats();
+
+  // 链路健康接口
+  // 连续 down_after_failures 条指令失败判定断开，断开期间指令立即失败，
+  // 每 probe_interval_ms 放行一条指令作为探测 (半开)，确认后恢复
+  void enableHeartbeat(int interval_ms); // 0 关闭，周期性读取 REC
+  void setLinkPolicy(int down_after_failures, int probe_interval_ms);
+  LinkState getLinkState();
+  // 状态变化回调 (在触发变化的线程中调用，通常为接收线程)
+  void setLinkStateCallback(LinkStateCallback callback);
+
+  // 姿态接口
+  bool enableAttitudeOutput(uint8_t rate_hz); // 0 关闭，1-100 Hz
+  Attitude getAttitude();
+  // 每帧姿态更新后调用 (接收线程中)
+  using AttitudeCallback = std::function<void(const Attitude &)>;
+  void setAttitudeCallback(AttitudeCallback callback);
+  // 姿态预测：融合带时间戳的姿态与已下发的速率指令，给出近未来 t 时刻的
+  // 姿态 (stamp 为 t)，用于补偿遥测与指令时延；未收到过姿态时 stamp 为默认值
+  Attitude predictAttitude(Clock::time_point t);
+  void setEstimatorParams(const AttitudeEstimator::Params &params);
+  // 姿态历史：按采样时刻 (接收时间 - 遥测时延) 保留最近的姿态，
+  // 用于照片、视频帧的地理配准；任意线程无锁查询，二分后在相邻两帧间插值
+  bool attitudeAt(Clock::time_point t, Attitude &attitude);
+  void setAttitudeHistory(size_t budget_bytes); // 默认 64 KiB (2048 帧)
+
+  // 状态缓存接口，无锁读取
+  CachedState getCachedState(StateField field);
+
+  // 共享内存状态发布 (布局与读端见 gimbal_shm.h)
+  // 姿态、确认状态或链路状态变化时以顺序锁写入 name 段，析构时删除该段
+  // 该段已由仍在运行的写端占用时返回 false；写端已退出的遗留段会被替换
+  bool enableSharedState(const std::string &name = "/gimbal_state");
+  void disableSharedState();
+
+  // 遥测记录 (布局与离线读端见 gimbal_telemetry.h)
+  // 把姿态、下发的写指令与往返时延按列写入预分配的内存映射文件
+  // <prefix>-NNNN.gtl，供事后分析；写入不格式化文本，不调用 write
+  bool enableTelemetryLog(const std::string &prefix);
+  bool enableTelemetryLog(const std::string &prefix,
+                          const TelemetryWriter::Params &params);
+  void disableTelemetryLog();
+  TelemetryWriter::Stats getTelemetryStats();
+
   // 图像参数接口
   // bool setImageParams(const ImageParams &params);
   // ImageParams getImageParams();
 
-  // 网络配置接口
+  // 网络配置接口 (IPV/GTW)，新地址通常在云台重启后生效
   bool setNetworkConfig(const std::string &ip, const std::string &gateway);
-  std::pair<std::string, std::string> getNetworkConfig();
+  std::pair<std::string, std::string> getNetworkConfig(); // {ip, gateway}
+
+  // 网络发现：经一个 socket 同时向所有候选地址发送 VER 读指令，
+  // 在一个超时窗口内按源地址收集应答
+  // targets 可为网段 "192.168.144.0/24"、范围 "192.168.144.100-192.168.144.120"
+  // 或单个地址 (含广播地址)
+  static std::vector<DiscoveredUnit> discover(const std::string &targets,
+                                              uint16_t port = 5000,
+                                              int timeout_ms = 500);
+  // 展开 discover 的 targets；网段不含网络与广播地址，
+  // 格式错误或超过 4096 个地址时返回 false
+  static bool expandTargets(const std::string &targets,
+                            std::vector<std::string> &addresses);
 
   // 可见光控制接口
   bool setZoomMode(ZoomMode mode);
@@ -107,7 +470,41 @@ public:
   bool setInstallMode(InstallMode mode);
 
   // 系统信息接口
-  std::string getFirmwareVersion(); // TODO
+  std::string getFirmwareVersion(); // 失败返回空串
+
+  // 启动探测：经关联层并行读取 VER 及 UID/VID/EXT/TAS 等能力项。
+  // 给出缓存文件时按云台地址持久化结果，下次启动命中缓存即立即返回，
+  // 仅在后台核对固件版本，版本变化时重新探测并更新缓存
+  bool probeUnit(const std::string &cache_path = "");
+  UnitInfo getUnitInfo();
+
+  // 帧构造接口，供不持有 GimbalCtrl 的进程 (如 gimbald 客户端) 自行组帧
+  // 数据超出一位长度位 (tp::kMaxDataLen 个字符) 时返回空串
+  static std::string buildCommand(const std::string &source_addr,
+                                  const std::string &dest_addr,
+                                  char control_type,
+                                  const std::string &identifier,
+                                  const std::string &data = "");
+
+  static std::string buildDynamicCommand(const std::string &source_addr,
+                                         const std::string &dest_addr,
+                                         char control_type,
+                                         const std::string &identifier,
+                                         const std::vector<uint8_t> &data);
+
+  static std::string buildStaticCommand(const std::string &source_addr,
+                                        const std::string &dest_addr,
+                                        char control_type,
+                                        const std::string &identifier,
+                                        const uint8_t &data = 0x00);
+
+  // 透传接口：登记并发送一帧完整指令，按异步指令跟踪确认
+  // issued_at 为指令的请求时刻 (如进入转发队列的时刻)，默认为调用时刻，
+  // 运动指令超过 command_deadline_ms 后不再发送或重发
+  // 帧校验失败、指令过期、链路断开或发送失败返回 0，此时不调用回调
+  CommandHandle
+  sendFrameAsync(const std::string &frame, CommandCallback callback = nullptr,
+                 Clock::time_point issued_at = Clock::time_point{});
 
   // 错误回调设置
   using ErrorCallback = std::function<void(const std::string &)>;
@@ -115,38 +512,272 @@ public:
     error_callback_ = std::move(callback);
   }
 
-private:
-  std::string buildCommand(const std::string &source_addr,
-                           const std::string &dest_addr, char control_type,
-                           const std::string &identifier,
-                           const std::string &data = "");
-
-  std::string buildDynamicCommand(const std::string &source_addr,
-                                  const std::string &dest_addr,
-                                  char control_type,
-                                  const std::string &identifier,
-                                  const std::vector<uint8_t> &data);
+  // 异步指令完成回调 (通常在接收线程中调用)
+  void setCommandCallback(CommandCallback callback) {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    command_callback_ =
+        callback ? std::make_shared<const CommandCallback>(std::move(callback))
+                 : nullptr;
+  }
 
-  std::string buildStaticCommand(const std::string &source_addr,
-                                 const std::string &dest_addr,
-                                 char control_type,
-                                 const std::string &identifier,
-                                 const uint8_t &data = 0x00);
+private:
+  // 等待回包的指令
+  struct PendingCommand {
+    CommandRecord record;
+    std::string frame; // 原始帧，用于重发
+    std::string match; // 期望回包的匹配键：交换后的地址位 + 控制位 + 标识位
+    std::string dest_ip;
+    bool group = false;        // 编组指令，收集多个单元应答
+    size_t expected_units = 0; // 编组指令期望应答数，0 为不限
+    int timeout_ms = 0;
+    int retries_left = 0;
+    uint32_t tx_id = 0;  // 最后一次发送的内核发送序号
+    uint32_t tx_epoch = 0; // 发送时的时间戳开启轮次，tx_id 只在同一轮内有效
+    uint64_t rx_seq = 0; // 登记时的接收序号，只接受其后读出的回包
+    Clock::time_point issued_at{}; // 请求时刻，运动指令的期限由此起算
+    Clock::time_point last_sent_at{};
+    Clock::time_point deadline{};
+    CommandCallback callback;
+  };
 
   bool send(const std::string &command, int timeout_ms = 1000);
   bool send(const std::string &command, std::string &response,
             int timeout_ms = 1000);
   bool sendAndVerify(const std::string &command);
-  uint8_t calculateChecksum(const std::string &frame);
+  // issued_at 为指令的请求时刻，默认为调用时刻；运动指令过期时丢弃
+  bool stream(const std::string &command,
+              Clock::time_point issued_at = Clock::time_point{});
+  bool commandExpired(const std::string &command,
+                      Clock::time_point issued_at);
+  static uint8_t calculateChecksum(std::string_view frame);
   std::string hexEncode(int32_t value, int num_digits);
   bool waitForData(int timeout_ms);
 
+  // 回包关联
+  CommandHandle submit(const std::string &command, int timeout_ms,
+                       int retries, CommandCallback callback = nullptr,
+                       Clock::time_point issued_at = Clock::time_point{});
+  CommandHandle submitGroup(const std::string &command, size_t expected_units,
+                            CommandCallback callback);
+  CommandHandle submitPending(PendingCommand pending);
+  void rxLoop();
+  // 已从 socket 读出、待分发的数据报
+  struct RxFrame {
+    RxBufferRef frame;
+    sockaddr_in source;
+    uint64_t seq;
+    timespec rx_stamp; // 清出的帧没有内核时间戳，为零
+  };
+
+  size_t drainStale(std::vector<RxFrame> &frames);
+  void dispatchBacklog();
+  bool dispatch(std::string_view frame, const sockaddr_in &source,
+                const timespec &rx_stamp, uint64_t seq);
+  void collectTxTimestamps();
+  void recordRtt(CommandRecord &record, const PendingCommand &pending,
+                 const timespec &rx_stamp, Clock::time_point now);
+  void expirePending(Clock::time_point now);
+  bool findRecord(CommandHandle handle, CommandRecord &record);
+  void complete(PendingCommand &pending, CommandState state,
+                RxBufferRef response, Clock::time_point now);
+  void notifyComplete(const PendingCommand &pending,
+                      const CommandCallback *global_callback);
+  static bool validateFrame(std::string_view frame);
+  void handleAttitude(std::string_view frame, Clock::time_point now);
+  void estimateCommand(std::string_view frame, Clock::time_point now);
+  void logCommand(std::string_view frame, Clock::time_point now);
+
+  // 链路健康
+  bool admitCommand(Clock::time_point now, bool &probe);
+  // handle 为产生该结果的指令，0 表示非指令结果 (如姿态推送)
+  void updateLink(bool alive, Clock::time_point now, CommandHandle handle = 0);
+  void heartbeat(Clock::time_point now);
+
+  // 状态缓存
+  void cacheFrame(std::string_view frame, bool confirmed,
+                  Clock::time_point now);
+  CachedValue loadCached(const std::atomic<uint64_t> &slot);
+  void publishState();
+
+  // 规划运动
+  bool motionTick(Clock::time_point deadline, uint32_t generation);
+  bool cancelMotion(); // 取消定时任务，返回运动是否仍在进行
+
+  // 速率模式
+  bool speedTick(Clock::time_point deadline, uint32_t generation);
+  bool cancelSpeed(); // 返回速率模式是否仍在进行
+
+  // 扫描
+  bool scanTick(Clock::time_point deadline, uint32_t generation);
+  bool scanCapture(Clock::time_point deadline, uint32_t generation,
+                   size_t leg);
+  void scheduleCapture(uint32_t generation, size_t from);
+  bool cancelScan(); // 返回扫描是否仍在进行
+
+  // 连拍
+  bool burstTick(uint32_t generation);
+  void burstCompleted(uint32_t generation, uint64_t index,
+                      const CommandRecord &record);
+
+  // 启动探测
+  struct ProbeState;
+  std::vector<CommandHandle> startProbe(std::shared_ptr<ProbeState> state);
+
   // 网络通信成员
-  UDPSocket sock_;
+  std::unique_ptr<GimbalTransport> transport_;
   std::string target_ip_;
   uint16_t port_;
+  std::string group_ip_;
   std::mutex socket_mutex_;
   ErrorCallback error_callback_;
+
+  // 回包关联成员
+  std::mutex pending_mutex_;
+  std::condition_variable pending_cv_;
+  std::map<CommandHandle, PendingCommand> pending_;
+  // 最近完成的指令，按句柄取模定位，预先分配
+  std::vector<CommandRecord> completed_;
+  // waitCommand 等待中的指令，完成记录保留到最后一个等待者取走
+  struct Awaited {
+    size_t waiters = 0;
+    bool done = false;
+    CommandRecord record;
+  };
+  std::map<CommandHandle, Awaited> awaited_;
+  CommandHandle next_handle_ = 1;
+  // 回调以 shared_ptr 持有，接收线程取用时不复制 std::function
+  std::shared_ptr<const CommandCallback> command_callback_;
+  RxBufferPool *rx_pool_;
+  int async_timeout_ms_ = 500;
+  int async_retries_ = 2;
+
+  // 读 socket 的互斥与接收序号，发送前清队列与登记指令在同一临界区内完成
+  std::mutex rx_mutex_;
+  uint64_t rx_seq_ = 0;
+  // 分发权：同一时刻只有一个线程调用 dispatch，帧按接收序号依次分发。
+  // 分发者之外读出的帧按序号排入 backlog_，由分发者取空后交出分发权
+  bool dispatching_ = false;             // rx_mutex_ 保护
+  std::vector<RxFrame> backlog_;         // rx_mutex_ 保护
+  std::vector<RxFrame> dispatch_frames_; // 仅分发者访问
+
+  // 时延统计成员，tx_stamps_ 与 tx_stamps_epoch_ 仅由分发者访问
+  // 时间戳每次由关到开，内核发送序号从 0 重新计数，tx_epoch_ 加一；
+  // 分发者见到新的轮次时清空 tx_stamps_
+  bool timestamping_ = false; // socket_mutex_ 保护
+  std::atomic<uint32_t> tx_epoch_{0};
+  uint32_t tx_stamps_epoch_ = 0;
+  std::map<uint32_t, timespec> tx_stamps_;
+  std::mutex stats_mutex_;
+  LinkStats stats_;
+
+  // 链路健康成员，link_mutex_ 内不再获取其他锁
+  std::mutex link_mutex_;
+  LinkState link_state_ = LinkState::UNKNOWN;
+  LinkStateCallback link_callback_;
+  int consecutive_failures_ = 0;
+  int down_after_failures_ = 3;
+  int probe_interval_ms_ = 1000;
+  int heartbeat_ms_ = 0;
+  bool probe_in_flight_ = false;
+  CommandHandle probe_handle_ = 0; // 在途探测指令，登记后填写
+  Clock::time_point next_probe_{};
+  Clock::time_point next_heartbeat_{};
+  Clock::time_point last_alive_{};
+
+  // 状态缓存：每个字段一个原子字，高 24 位为值，低 40 位为距 cache_epoch_
+  // 的毫秒数 + 1 (0 表示从未记录)，读写均无锁
+  static constexpr size_t kStateFields =
+      static_cast<size_t>(StateField::COUNT);
+  std::array<std::atomic<uint64_t>, kStateFields> commanded_state_{};
+  std::array<std::atomic<uint64_t>, kStateFields> confirmed_state_{};
+  const Clock::time_point cache_epoch_ = Clock::now();
+
+  std::mutex unit_mutex_;
+  UnitInfo unit_info_;
+
+  // 共享内存发布成员，shm_mutex_ 只保护写端；持有时只会再取
+  // attitude_mutex_ 与 link_mutex_
+  std::mutex shm_mutex_;
+  std::atomic<bool> shm_enabled_{false};
+  GimbalShmSegment *shm_segment_ = nullptr;
+  std::string shm_name_;
+  uint64_t shm_publish_count_ = 0;
+
+  // 遥测记录成员，telemetry_mutex_ 内不再获取其他锁
+  std::mutex telemetry_mutex_;
+  std::atomic<bool> telemetry_enabled_{false};
+  TelemetryWriter telemetry_;
+
+  std::mutex attitude_mutex_;
+  Attitude attitude_;
+  AttitudeEstimator estimator_;
+  std::shared_ptr<const AttitudeCallback> attitude_callback_;
+  // 姿态历史，读端无锁；替换下来的缓冲保留在 histories_ 中直至析构
+  std::atomic<AttitudeHistory *> history_{nullptr};
+  std::vector<std::unique_ptr<AttitudeHistory>> histories_;
+
+  // 规划运动成员，motion_mutex_ 内只调用 timer_->schedule (定时器执行任务时
+  // 不持有自身的锁)，不再获取其他锁；timer_->cancel 会等待任务结束，须在锁外
+  struct MotionRun {
+    MotionProfile yaw;
+    MotionProfile pitch;
+    float yaw_start = 0.0f;
+    float pitch_start = 0.0f;
+    Clock::time_point lock_sent_at{};
+    uint32_t generation = 0;
+  };
+  std::mutex motion_mutex_;
+  std::condition_variable motion_cv_;
+  MotionParams motion_params_;
+  MotionGuard motion_guard_;
+  // motion_guard_.command_deadline_ms 的副本，发送路径无锁读取
+  std::atomic<int> command_deadline_ms_{MotionGuard().command_deadline_ms};
+  MotionRun motion_run_;
+  MotionStatus motion_status_;
+  GimbalTimer::TaskId motion_task_ = 0;
+  // 规划运动、速率模式与扫描共用的代号，每次启动递增；启动在同一临界区内
+  // 登记定时任务，被并发启动取代的任务在下一拍见到代号变化后自行结束
+  uint32_t motion_generation_ = 0;
+
+  // 速率模式成员，同由 motion_mutex_ 保护
+  struct SpeedRun {
+    std::array<RateModulator, 2> modulator{}; // 航向、俯仰
+    std::array<Clock::time_point, 2> sent_at{};
+    bool resend = false; // 上一拍的帧未发出，本拍无论是否变化都重发
+    Clock::time_point last_tick{};
+    uint32_t generation = 0;
+  };
+  SpeedRun speed_run_;
+  SpeedStatus speed_status_;
+  GimbalTimer::TaskId speed_task_ = 0;
+
+  // 扫描成员，同由 motion_mutex_ 保护；拍照任务逐个登记，只有一个在排队
+  struct ScanRun {
+    ScanSchedule schedule;
+    size_t leg = 0;
+    bool locked = false; // 当前航点已下发角度锁定
+    uint32_t generation = 0; // 丢弃过期的拍照任务与回调
+  };
+  ScanRun scan_run_;
+  ScanStatus scan_status_;
+  GimbalTimer::TaskId scan_task_ = 0;
+  GimbalTimer::TaskId capture_task_ = 0;
+
+  // 连拍成员，burst_mutex_ 内不再获取其他锁
+  static constexpr size_t kBurstHistory = 1024;
+  std::mutex burst_mutex_;
+  std::condition_variable burst_cv_;
+  BurstParams burst_params_;
+  BurstStatus burst_status_;
+  std::deque<Shot> burst_shots_; // 序号连续，front 为最早保留的一张
+  std::shared_ptr<const ShotCallback> burst_callback_;
+  uint32_t burst_generation_ = 0;
+  GimbalTimer::TaskId burst_task_ = 0;
+
+  std::atomic<bool> running_{false};
+  std::thread rx_thread_;
+  // 周期任务线程，析构时最先停止
+  std::unique_ptr<GimbalTimer> timer_;
 };
 
 #endif
\ No newline at end of file
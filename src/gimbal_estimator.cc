@@ -0,0 +1,145 @@
+#include "gimbal_estimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// 未生效指令的上限，姿态长时间中断时丢弃最早的指令
+constexpr size_t kMaxCommands = 64;
+} // namespace
+
+void AttitudeEstimator::reset() {
+  state_ = State{};
+  at_ = Clock::time_point{};
+  valid_ = false;
+  commands_.clear();
+}
+
+void AttitudeEstimator::addMeasurement(const std::array<float, AXES> &angle,
+                                       Clock::time_point received) {
+  Clock::time_point sampled =
+      received - std::chrono::milliseconds(params_.telemetry_latency_ms);
+  const double r = params_.angle_noise * params_.angle_noise;
+
+  if (!valid_) {
+    const double v0 = params_.release_rate_std * params_.release_rate_std;
+    for (size_t i = 0; i < AXES; i++)
+      state_[i] = AxisState{angle[i], 0.0, r, 0.0, v0};
+    at_ = sampled;
+    valid_ = true;
+    return;
+  }
+
+  // 先应用采样时刻之前已生效的指令
+  while (!commands_.empty() && commands_.front().effective <= sampled) {
+    propagate(state_, at_, commands_.front().effective);
+    apply(state_, commands_.front());
+    commands_.pop_front();
+  }
+  propagate(state_, at_, sampled);
+
+  for (size_t i = 0; i < AXES; i++) {
+    AxisState &s = state_[i];
+    double innovation = angle[i] - s.angle;
+    double gain_s = s.p00 + r;
+    double k0 = s.p00 / gain_s;
+    double k1 = s.p01 / gain_s;
+    s.angle += k0 * innovation;
+    s.rate += k1 * innovation;
+    double p00 = (1.0 - k0) * s.p00;
+    double p01 = (1.0 - k0) * s.p01;
+    double p11 = s.p11 - k1 * s.p01;
+    s.p00 = p00;
+    s.p01 = p01;
+    s.p11 = p11;
+  }
+}
+
+void AttitudeEstimator::addRateCommand(Axis axis, float rate,
+                                       Clock::time_point sent) {
+  enqueue(Command{sent + std::chrono::milliseconds(params_.command_latency_ms),
+                  axis, false, rate});
+}
+
+void AttitudeEstimator::addAngleCommand(Axis axis, Clock::time_point sent) {
+  enqueue(Command{sent + std::chrono::milliseconds(params_.command_latency_ms),
+                  axis, true, 0.0f});
+}
+
+void AttitudeEstimator::enqueue(const Command &command) {
+  auto it = std::upper_bound(
+      commands_.begin(), commands_.end(), command.effective,
+      [](Clock::time_point t, const Command &c) { return t < c.effective; });
+  commands_.insert(it, command);
+  if (commands_.size() > kMaxCommands)
+    commands_.pop_front();
+}
+
+AttitudeEstimator::Estimate
+AttitudeEstimator::predict(Clock::time_point t) const {
+  Estimate estimate;
+  if (!valid_)
+    return estimate;
+
+  State state = state_;
+  Clock::time_point at = at_;
+  for (const Command &command : commands_) {
+    if (command.effective > t)
+      break;
+    propagate(state, at, command.effective);
+    apply(state, command);
+  }
+  propagate(state, at, t);
+
+  for (size_t i = 0; i < AXES; i++) {
+    estimate.angle[i] = static_cast<float>(state[i].angle);
+    estimate.rate[i] = static_cast<float>(state[i].rate);
+    estimate.angle_std[i] =
+        static_cast<float>(std::sqrt(std::max(0.0, state[i].p00)));
+  }
+  estimate.valid = true;
+  return estimate;
+}
+
+// 匀速模型外推，t 早于状态时刻时不回退
+void AttitudeEstimator::propagate(State &state, Clock::time_point &at,
+                                  Clock::time_point to) const {
+  if (to <= at)
+    return;
+  double dt = std::chrono::duration<double>(to - at).count();
+  at = to;
+  const double q = params_.accel_noise;
+  for (AxisState &s : state) {
+    s.angle += s.rate * dt;
+    double p00 = s.p00 + 2.0 * dt * s.p01 + dt * dt * s.p11 +
+                 q * dt * dt * dt / 3.0;
+    double p01 = s.p01 + dt * s.p11 + q * dt * dt / 2.0;
+    double p11 = s.p11 + q * dt;
+    s.p00 = p00;
+    s.p01 = p01;
+    s.p11 = p11;
+  }
+}
+
+// 速率指令作为角速度的伪观测；角度指令放大角速度方差
+void AttitudeEstimator::apply(State &state, const Command &command) const {
+  AxisState &s = state[command.axis];
+  if (command.release) {
+    s.p11 += params_.release_rate_std * params_.release_rate_std;
+    return;
+  }
+
+  const double r = params_.rate_noise * params_.rate_noise;
+  double innovation = command.rate - s.rate;
+  double gain_s = s.p11 + r;
+  double k0 = s.p01 / gain_s;
+  double k1 = s.p11 / gain_s;
+  s.angle += k0 * innovation;
+  s.rate += k1 * innovation;
+  double p00 = s.p00 - k0 * s.p01;
+  double p01 = (1.0 - k1) * s.p01;
+  double p11 = (1.0 - k1) * s.p11;
+  s.p00 = p00;
+  s.p01 = p01;
+  s.p11 = p11;
+}
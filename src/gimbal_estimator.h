@@ -0,0 +1,90 @@
+#ifndef __GIMBAL_ESTIMATOR_H__
+#define __GIMBAL_ESTIMATOR_H__
+
+#include "gimbal_export.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+
+/**
+ * @brief 姿态估计器：逐轴匀速模型 Kalman 滤波，补偿遥测与指令时延
+ *
+ * 状态为 [角度, 角速度]。GAC 姿态按 "接收时间 - 遥测时延" 作为采样时刻
+ * 做位置更新；下发的 GSY/GSP 速率指令在 "发送时间 + 指令时延" 生效，
+ * 作为角速度的伪观测。预测时先应用已下发、尚未生效的速率指令，
+ * 因而能在姿态反映之前给出指令造成的运动。角度指令 (固件位置环) 不可
+ * 预知速度变化，只在生效时放大角速度方差。
+ *
+ * 非线程安全，由调用方加锁。
+ */
+class GIMBAL_EXPORT AttitudeEstimator {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  enum Axis : size_t { YAW = 0, PITCH = 1, ROLL = 2, AXES = 3 };
+
+  struct Params {
+    float accel_noise = 2000.0f; // 加速度白噪声谱密度 (deg^2/s^3)
+    float angle_noise = 0.05f;   // 姿态测量标准差 (deg)
+    float rate_noise = 2.0f;     // 速率指令执行误差标准差 (deg/s)
+    float release_rate_std = 30.0f; // 角度指令生效时角速度的不确定度 (deg/s)
+    int telemetry_latency_ms = 5;   // 采样到接收的时延
+    int command_latency_ms = 20;    // 发送到云台执行的时延
+  };
+
+  struct Estimate {
+    std::array<float, AXES> angle{}; // deg
+    std::array<float, AXES> rate{};  // deg/s
+    std::array<float, AXES> angle_std{};
+    bool valid = false; // 尚未收到姿态时为 false
+  };
+
+  void setParams(const Params &params) { params_ = params; }
+  const Params &params() const { return params_; }
+
+  void reset();
+
+  // GAC 姿态，received 为接收时间
+  void addMeasurement(const std::array<float, AXES> &angle,
+                      Clock::time_point received);
+
+  // 下发速率指令 (deg/s)
+  void addRateCommand(Axis axis, float rate, Clock::time_point sent);
+
+  // 下发角度指令，此后该轴速度由固件决定
+  void addAngleCommand(Axis axis, Clock::time_point sent);
+
+  // 预测 t 时刻的姿态，不改变滤波器状态
+  Estimate predict(Clock::time_point t) const;
+
+private:
+  struct AxisState {
+    double angle = 0.0;
+    double rate = 0.0;
+    double p00 = 0.0, p01 = 0.0, p11 = 0.0; // 协方差 (对称)
+  };
+
+  struct Command {
+    Clock::time_point effective;
+    Axis axis;
+    bool release; // 角度指令
+    float rate;
+  };
+
+  using State = std::array<AxisState, AXES>;
+
+  void enqueue(const Command &command);
+  void propagate(State &state, Clock::time_point &at,
+                 Clock::time_point to) const;
+  void apply(State &state, const Command &command) const;
+
+  Params params_;
+  State state_{};
+  Clock::time_point at_{}; // 状态对应的时刻
+  bool valid_ = false;
+  std::deque<Command> commands_; // 尚未生效的指令，按生效时间排序
+};
+
+#endif
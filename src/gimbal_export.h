@@ -0,0 +1,14 @@
+#ifndef __GIMBAL_EXPORT_H__
+#define __GIMBAL_EXPORT_H__
+
+// 单库构建 (GIMBAL_SINGLE_LIBRARY) 以 -fvisibility=hidden 编译，
+// 对外接口需显式导出，其余符号保持库内可见
+#ifndef GIMBAL_EXPORT
+#if defined(__GNUC__) || defined(__clang__)
+#define GIMBAL_EXPORT __attribute__((visibility("default")))
+#else
+#define GIMBAL_EXPORT
+#endif
+#endif
+
+#endif
@@ -0,0 +1,135 @@
+#include "gimbal_history.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+int64_t toNs(AttitudeHistory::Clock::time_point t) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             t.time_since_epoch())
+      .count();
+}
+
+AttitudeHistory::Clock::time_point fromNs(int64_t ns) {
+  return AttitudeHistory::Clock::time_point(
+      std::chrono::duration_cast<AttitudeHistory::Clock::duration>(
+          std::chrono::nanoseconds(ns)));
+}
+
+uint64_t packAngles(const std::array<float, 3> &angle) {
+  uint64_t packed = 0;
+  for (size_t i = 0; i < 3; i++) {
+    long centi = std::lround(angle[i] * 100.0f);
+    centi = std::max(-32768L, std::min(32767L, centi));
+    packed |= static_cast<uint64_t>(static_cast<uint16_t>(centi)) << (16 * i);
+  }
+  return packed;
+}
+
+std::array<float, 3> unpackAngles(uint64_t packed) {
+  std::array<float, 3> angle;
+  for (size_t i = 0; i < 3; i++)
+    angle[i] = static_cast<int16_t>(packed >> (16 * i)) / 100.0f;
+  return angle;
+}
+} // namespace
+
+AttitudeHistory::AttitudeHistory(size_t budget_bytes) {
+  size_t slots = std::max<size_t>(budget_bytes / sizeof(Slot), 2);
+  size_t capacity = 2;
+  while (capacity * 2 <= slots)
+    capacity *= 2;
+  slots_.reset(new Slot[capacity]);
+  mask_ = capacity - 1;
+}
+
+size_t AttitudeHistory::size() const {
+  return static_cast<size_t>(
+      std::min<uint64_t>(head_.load(std::memory_order_acquire), capacity()));
+}
+
+bool AttitudeHistory::push(Clock::time_point stamp,
+                           const std::array<float, 3> &angle) {
+  int64_t ns = toNs(stamp);
+  if (ns <= last_stamp_)
+    return false;
+  last_stamp_ = ns;
+
+  uint64_t index = head_.load(std::memory_order_relaxed);
+  Slot &slot = slots_[index & mask_];
+  slot.seq.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.stamp.store(ns, std::memory_order_relaxed);
+  slot.angles.store(packAngles(angle), std::memory_order_relaxed);
+  slot.seq.store(index + 1, std::memory_order_release);
+  head_.store(index + 1, std::memory_order_release);
+  return true;
+}
+
+// 读取第 index 个样本，槽位已被覆盖或正在写入时返回 false
+bool AttitudeHistory::read(uint64_t index, Sample &sample) const {
+  const Slot &slot = slots_[index & mask_];
+  uint64_t before = slot.seq.load(std::memory_order_acquire);
+  int64_t ns = slot.stamp.load(std::memory_order_relaxed);
+  uint64_t angles = slot.angles.load(std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  uint64_t after = slot.seq.load(std::memory_order_relaxed);
+  if (before != index + 1 || after != before)
+    return false;
+  sample.stamp = fromNs(ns);
+  sample.angle = unpackAngles(angles);
+  return true;
+}
+
+bool AttitudeHistory::newest(Sample &sample) const {
+  uint64_t head = head_.load(std::memory_order_acquire);
+  return head > 0 && read(head - 1, sample);
+}
+
+bool AttitudeHistory::oldest(Sample &sample) const {
+  // 最早的槽位可能正被覆盖，向新的方向重试
+  uint64_t head = head_.load(std::memory_order_acquire);
+  for (uint64_t index = head > capacity() ? head - capacity() : 0;
+       index < head; index++)
+    if (read(index, sample))
+      return true;
+  return false;
+}
+
+bool AttitudeHistory::at(Clock::time_point t, Sample &sample) const {
+  uint64_t head = head_.load(std::memory_order_acquire);
+  if (head == 0)
+    return false;
+
+  Sample upper;
+  uint64_t hi = head - 1;
+  if (!read(hi, upper) || t > upper.stamp)
+    return false;
+  if (t == upper.stamp) {
+    sample = upper;
+    return true;
+  }
+
+  // 不变式：hi 的时间戳晚于 t；lo 为候选下界，其槽位被覆盖时继续向新的方向收缩
+  uint64_t lo = head > capacity() ? head - capacity() : 0;
+  Sample probe;
+  while (hi - lo > 1) {
+    uint64_t mid = lo + (hi - lo) / 2;
+    if (!read(mid, probe) || probe.stamp <= t)
+      lo = mid;
+    else
+      hi = mid;
+  }
+
+  Sample lower;
+  if (!read(lo, lower) || lower.stamp > t || !read(hi, upper))
+    return false;
+
+  double span = std::chrono::duration<double>(upper.stamp - lower.stamp).count();
+  double w = std::chrono::duration<double>(t - lower.stamp).count() / span;
+  sample.stamp = t;
+  for (size_t i = 0; i < 3; i++)
+    sample.angle[i] = static_cast<float>(
+        lower.angle[i] + (upper.angle[i] - lower.angle[i]) * w);
+  return true;
+}
@@ -0,0 +1,64 @@
+#ifndef __GIMBAL_HISTORY_H__
+#define __GIMBAL_HISTORY_H__
+
+#include "gimbal_export.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief 按时间索引的姿态历史环形缓冲，读端无锁
+ *
+ * 槽位 32 字节、连续存放，容量为内存预算内最大的 2 的幂。每个槽位以
+ * 序号做顺序锁：写端先清零序号再写数据，最后写入 "下标 + 1"；读端前后
+ * 两次读到相同的期望序号才接受，被覆盖的槽位读取失败而不是返回错位数据。
+ * 查询按时间戳二分，O(log n)。
+ *
+ * 写端同一时刻只能有一个 (由调用方保证)；读端可在任意线程并发调用。
+ */
+class GIMBAL_EXPORT AttitudeHistory {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  // 姿态样本，角度为 yaw、pitch、roll (deg)，精度 0.01 度
+  struct Sample {
+    Clock::time_point stamp{};
+    std::array<float, 3> angle{};
+  };
+
+  explicit AttitudeHistory(size_t budget_bytes);
+  AttitudeHistory(const AttitudeHistory &) = delete;
+  AttitudeHistory &operator=(const AttitudeHistory &) = delete;
+
+  size_t capacity() const { return mask_ + 1; }
+  size_t size() const;
+
+  // 追加一个样本；时间戳不晚于最新样本时丢弃并返回 false
+  bool push(Clock::time_point stamp, const std::array<float, 3> &angle);
+
+  // t 时刻的姿态，在相邻两个样本间线性插值；t 超出保留范围返回 false
+  bool at(Clock::time_point t, Sample &sample) const;
+
+  bool newest(Sample &sample) const;
+  bool oldest(Sample &sample) const;
+
+private:
+  struct alignas(32) Slot {
+    std::atomic<uint64_t> seq{0}; // 下标 + 1，写入中为 0
+    std::atomic<int64_t> stamp{0}; // ns
+    std::atomic<uint64_t> angles{0}; // 3 x int16，单位 0.01 度
+  };
+
+  bool read(uint64_t index, Sample &sample) const;
+
+  std::unique_ptr<Slot[]> slots_;
+  size_t mask_;
+  std::atomic<uint64_t> head_{0}; // 已写入的样本数
+  int64_t last_stamp_ = INT64_MIN; // 仅写端访问
+};
+
+#endif
@@ -0,0 +1,106 @@
+#include "gimbal_motion.h"
+
+#include <algorithm>
+#include <cmath>
+
+MotionProfile MotionProfile::plan(double distance, double max_rate,
+                                  double max_accel, double max_jerk) {
+  MotionProfile profile;
+  profile.distance_ = distance;
+  const double d = std::fabs(distance);
+  if (d <= 0.0 || max_rate <= 0.0 || max_accel <= 0.0 || max_jerk <= 0.0)
+    return profile;
+
+  const double v = max_rate;
+  const double a = max_accel;
+  const double j = max_jerk;
+
+  // 先假设达到速度上限：tj 为加加速段时长，ta 为加速段总时长
+  double tj, ta;
+  if (v * j < a * a) {
+    tj = std::sqrt(v / j); // 达不到加速度上限
+    ta = 2.0 * tj;
+  } else {
+    tj = a / j;
+    ta = tj + v / a;
+  }
+  double tv = d / v - ta;
+
+  if (tv < 0.0) {
+    // 行程不足以达到速度上限，去掉匀速段
+    tv = 0.0;
+    tj = a / j;
+    ta = (a * tj + std::sqrt(a * a * tj * tj + 4.0 * a * d)) / (2.0 * a);
+    if (ta < 2.0 * tj) {
+      // 也达不到加速度上限
+      tj = std::cbrt(d / (2.0 * j));
+      ta = 2.0 * tj;
+    }
+  }
+
+  const double peak_accel = j * tj;
+  const double sign = distance < 0.0 ? -1.0 : 1.0;
+  const double jerk = sign * j;
+  profile.peak_rate_ = peak_accel * (ta - tj);
+  profile.length_ = {tj, ta - 2.0 * tj, tj, tv, tj, ta - 2.0 * tj, tj};
+  profile.jerk_ = {jerk, 0.0, -jerk, 0.0, -jerk, 0.0, jerk};
+
+  double p = 0.0, vel = 0.0, acc = 0.0;
+  for (size_t i = 0; i < kSegments; i++) {
+    profile.p0_[i] = p;
+    profile.v0_[i] = vel;
+    profile.a0_[i] = acc;
+    double t = profile.length_[i];
+    double jk = profile.jerk_[i];
+    p += vel * t + acc * t * t / 2.0 + jk * t * t * t / 6.0;
+    vel += acc * t + jk * t * t / 2.0;
+    acc += jk * t;
+    profile.duration_ += t;
+  }
+  return profile;
+}
+
+void MotionProfile::sample(double t, double &position, double &rate) const {
+  if (duration_ <= 0.0) {
+    position = distance_;
+    rate = 0.0;
+    return;
+  }
+  if (t >= duration_) {
+    position = distance_;
+    rate = 0.0;
+    return;
+  }
+
+  double u = std::max(0.0, t) / scale_;
+  size_t i = 0;
+  while (i + 1 < kSegments && u >= length_[i]) {
+    u -= length_[i];
+    i++;
+  }
+  u = std::min(u, length_[i]);
+  position = p0_[i] + v0_[i] * u + a0_[i] * u * u / 2.0 +
+             jerk_[i] * u * u * u / 6.0;
+  rate = (v0_[i] + a0_[i] * u + jerk_[i] * u * u / 2.0) / scale_;
+}
+
+void MotionProfile::stretch(double duration) {
+  double base = duration_ / scale_;
+  if (base <= 0.0 || duration <= duration_)
+    return;
+  scale_ = duration / base;
+  duration_ = duration;
+}
+
+RateModulator::RateModulator(double quantum, double period, int max_code)
+    : quantum_(quantum), period_(period), max_code_(max_code) {}
+
+int RateModulator::step(double rate, double dt) {
+  const double limit = quantum_ * period_;
+  error_ += (rate - code_ * quantum_) * dt;
+  error_ = std::max(-limit, std::min(limit, error_));
+  long code = std::lround((rate + error_ / period_) / quantum_);
+  code_ = static_cast<int>(
+      std::max<long>(-max_code_, std::min<long>(max_code_, code)));
+  return code_;
+}
@@ -0,0 +1,101 @@
+#ifndef __GIMBAL_MOTION_H__
+#define __GIMBAL_MOTION_H__
+
+#include "gimbal_export.h"
+
+#include <array>
+#include <cstddef>
+
+/**
+ * @brief 单轴限加加速度 (jerk) 的时间最优运动曲线 (S 形曲线)
+ *
+ * 起止速度、加速度均为 0，在速度、加速度、加加速度限制下求最短时间。
+ * 曲线分 7 段：加加速、匀加速、减加速、匀速、加减速、匀减速、减减速，
+ * 行程不足时匀速段与匀加速段依次消失。
+ */
+class GIMBAL_EXPORT MotionProfile {
+public:
+  MotionProfile() = default;
+
+  /**
+   * @brief 规划一段运动
+   *
+   * @param distance 位移 (deg)，可为负
+   * @param max_rate 速度上限 (deg/s)
+   * @param max_accel 加速度上限 (deg/s^2)
+   * @param max_jerk 加加速度上限 (deg/s^3)
+   */
+  static MotionProfile plan(double distance, double max_rate,
+                            double max_accel, double max_jerk);
+
+  double duration() const { return duration_; }
+  double distance() const { return distance_; }
+  double peakRate() const { return peak_rate_ / scale_; }
+
+  // 在 [0, duration] 内采样 t 时刻的位移与速度，超出范围时取端点
+  void sample(double t, double &position, double &rate) const;
+
+  /**
+   * @brief 时间缩放到更长的时长，形状不变，速度/加速度/加加速度随之减小
+   *
+   * 用于多轴同时到达：各轴按最慢轴的时长缩放
+   */
+  void stretch(double duration);
+
+private:
+  static constexpr size_t kSegments = 7;
+
+  double distance_ = 0.0;
+  double duration_ = 0.0;
+  double peak_rate_ = 0.0; // 未缩放的峰值速度
+  double scale_ = 1.0; // 时间缩放系数，>= 1
+  // 未缩放的各段时长、加加速度及段首状态
+  std::array<double, kSegments> length_{};
+  std::array<double, kSegments> jerk_{};
+  std::array<double, kSegments> p0_{};
+  std::array<double, kSegments> v0_{};
+  std::array<double, kSegments> a0_{};
+};
+
+/**
+ * @brief 单轴速率量化调制器 (一阶 sigma-delta)
+ *
+ * 云台速率指令只能取 quantum 的整数倍。每拍累计上一拍下发速率与设定速率
+ * 之差的积分 (位置误差 e)，本拍下发 round((设定速率 + e / 周期) / quantum)，
+ * 按周期等间隔调用且 |设定速率| <= max_code x quantum 时
+ * |e| <= quantum x 周期 / 2。
+ */
+class GIMBAL_EXPORT RateModulator {
+public:
+  RateModulator() = default;
+
+  /**
+   * @param quantum 速率量化单位 (deg/s)
+   * @param period 调制周期 (s)
+   * @param max_code 指令码绝对值上限
+   */
+  RateModulator(double quantum, double period, int max_code);
+
+  /**
+   * @brief 推进一拍
+   *
+   * @param rate 设定速率 (deg/s)
+   * @param dt 距上一拍的时间 (s)，期间按上一拍的指令码运动；首拍为 0。
+   *           误差限制在 +/-quantum x 周期，定时器长时间停顿后不追赶
+   * @return 本拍下发的指令码
+   */
+  int step(double rate, double dt);
+
+  int code() const { return code_; }
+  double error() const { return error_; } // 本拍之前累计的位置误差 (deg)
+  double bound() const { return 0.5 * quantum_ * period_; } // 稳态 |e| 上限
+
+private:
+  double quantum_ = 1.0;
+  double period_ = 1.0;
+  int max_code_ = 0;
+  int code_ = 0;
+  double error_ = 0.0;
+};
+
+#endif
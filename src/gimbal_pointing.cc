@@ -0,0 +1,141 @@
+#include "gimbal_pointing.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// WGS-84
+constexpr double kSemiMajor = 6378137.0;
+constexpr double kFlattening = 1.0 / 298.257223563;
+constexpr double kEccSq = kFlattening * (2.0 - kFlattening);
+
+constexpr double kDegToRad = 3.14159265358979323846 / 180.0;
+constexpr float kRadToDegF = 57.2957795130823208768f;
+constexpr float kHalfPiF = 1.57079632679489661923f;
+constexpr float kPiF = 3.14159265358979323846f;
+
+void llaToEcef(double lat_deg, double lon_deg, double alt_m, double &x,
+               double &y, double &z) {
+  double lat = lat_deg * kDegToRad;
+  double lon = lon_deg * kDegToRad;
+  double sin_lat = std::sin(lat), cos_lat = std::cos(lat);
+  double n = kSemiMajor / std::sqrt(1.0 - kEccSq * sin_lat * sin_lat);
+  x = (n + alt_m) * cos_lat * std::cos(lon);
+  y = (n + alt_m) * cos_lat * std::sin(lon);
+  z = (n * (1.0 - kEccSq) + alt_m) * sin_lat;
+}
+
+/**
+ * @brief 单精度 atan2 多项式近似，最大误差约 1e-5 rad
+ *
+ * 只用比较选择与乘加，可被向量化；x、y 同为 0 时返回 0
+ */
+inline float fastAtan2(float y, float x) {
+  float ax = std::fabs(x), ay = std::fabs(y);
+  float lo = std::min(ax, ay);
+  float hi = std::max(ax, ay) + 1e-30f; // 不引入分支，避免 0/0
+  float a = lo / hi;
+  float s = a * a;
+  float r =
+      a * (0.99997726f +
+           s * (-0.33262347f +
+                s * (0.19354346f +
+                     s * (-0.11643287f + s * (0.05265332f - s * 0.01172120f)))));
+  r = ay > ax ? kHalfPiF - r : r;
+  r = x < 0.0f ? kPiF - r : r;
+  return y < 0.0f ? -r : r;
+}
+} // namespace
+
+void PointingTargets::reserve(size_t count) {
+  x_.reserve(count);
+  y_.reserve(count);
+  z_.reserve(count);
+}
+
+void PointingTargets::clear() {
+  x_.clear();
+  y_.clear();
+  z_.clear();
+}
+
+size_t PointingTargets::add(double lat_deg, double lon_deg, double alt_m) {
+  double x, y, z;
+  llaToEcef(lat_deg, lon_deg, alt_m, x, y, z);
+  x_.push_back(x);
+  y_.push_back(y);
+  z_.push_back(z);
+  return x_.size() - 1;
+}
+
+size_t solvePointing(const VehiclePose &pose, const PointingTargets &targets,
+                     PointingSolution &solution) {
+  const size_t count = targets.size();
+  solution.yaw.resize(count);
+  solution.pitch.resize(count);
+  solution.range_m.resize(count);
+  solution.clamped.resize(count);
+  if (count == 0)
+    return 0;
+
+  // 载机 ECEF 与 ECEF -> NED 旋转
+  double vx, vy, vz;
+  llaToEcef(pose.lat_deg, pose.lon_deg, pose.alt_m, vx, vy, vz);
+  double lat = pose.lat_deg * kDegToRad, lon = pose.lon_deg * kDegToRad;
+  double sp = std::sin(lat), cp = std::cos(lat);
+  double sl = std::sin(lon), cl = std::cos(lon);
+  const double ned[3][3] = {{-sp * cl, -sp * sl, cp},
+                            {-sl, cl, 0.0},
+                            {-cp * cl, -cp * sl, -sp}};
+
+  // NED -> 机体 (ZYX)
+  double sy = std::sin(pose.yaw_deg * kDegToRad);
+  double cy = std::cos(pose.yaw_deg * kDegToRad);
+  double st = std::sin(pose.pitch_deg * kDegToRad);
+  double ct = std::cos(pose.pitch_deg * kDegToRad);
+  double sr = std::sin(pose.roll_deg * kDegToRad);
+  double cr = std::cos(pose.roll_deg * kDegToRad);
+  const double body[3][3] = {
+      {ct * cy, ct * sy, -st},
+      {sr * st * cy - cr * sy, sr * st * sy + cr * cy, sr * ct},
+      {cr * st * cy + sr * sy, cr * st * sy - sr * cy, cr * ct}};
+
+  // 合并为 ECEF -> 机体，逐目标只做一次 3x3 乘法
+  float m[3][3];
+  for (int r = 0; r < 3; r++)
+    for (int c = 0; c < 3; c++)
+      m[r][c] = static_cast<float>(body[r][0] * ned[0][c] +
+                                   body[r][1] * ned[1][c] +
+                                   body[r][2] * ned[2][c]);
+
+  const double *tx = targets.x();
+  const double *ty = targets.y();
+  const double *tz = targets.z();
+  float *__restrict yaw = solution.yaw.data();
+  float *__restrict pitch = solution.pitch.data();
+  float *__restrict range = solution.range_m.data();
+  uint8_t *__restrict clamped = solution.clamped.data();
+  const float m00 = m[0][0], m01 = m[0][1], m02 = m[0][2];
+  const float m10 = m[1][0], m11 = m[1][1], m12 = m[1][2];
+  const float m20 = m[2][0], m21 = m[2][1], m22 = m[2][2];
+  const float limit = kGimbalAngleLimit;
+
+  for (size_t i = 0; i < count; i++) {
+    // 差分在双精度下完成，相对位置再转单精度 (20 km 内误差约 1 mm)
+    float dx = static_cast<float>(tx[i] - vx);
+    float dy = static_cast<float>(ty[i] - vy);
+    float dz = static_cast<float>(tz[i] - vz);
+    float bx = m00 * dx + m01 * dy + m02 * dz;
+    float by = m10 * dx + m11 * dy + m12 * dz;
+    float bz = m20 * dx + m21 * dy + m22 * dz;
+    float horizontal = std::sqrt(bx * bx + by * by);
+    float y = fastAtan2(by, bx) * kRadToDegF;
+    float p = fastAtan2(-bz, horizontal) * kRadToDegF;
+    bool out = std::fabs(y) > limit || std::fabs(p) > limit;
+    yaw[i] = std::max(-limit, std::min(limit, y));
+    pitch[i] = std::max(-limit, std::min(limit, p));
+    range[i] = std::sqrt(horizontal * horizontal + bz * bz);
+    clamped[i] = out ? 1 : 0;
+  }
+  return static_cast<size_t>(std::count(clamped, clamped + count, 1));
+}
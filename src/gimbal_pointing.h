@@ -0,0 +1,71 @@
+#ifndef __GIMBAL_POINTING_H__
+#define __GIMBAL_POINTING_H__
+
+#include "gimbal_export.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 云台角度限幅 (deg)，与 GimbalCtrl::setGimbalAngle 一致
+constexpr float kGimbalAngleLimit = 90.0f;
+
+// 载机位姿：WGS-84 位置与机体相对 NED 的姿态 (ZYX 欧拉角)
+struct VehiclePose {
+  double lat_deg = 0.0;
+  double lon_deg = 0.0;
+  double alt_m = 0.0; // 椭球高
+  float yaw_deg = 0.0f;   // 航向，北为 0，顺时针为正
+  float pitch_deg = 0.0f; // 抬头为正
+  float roll_deg = 0.0f;  // 右滚为正
+};
+
+/**
+ * @brief 一批地面目标，结构数组 (SoA) 存储
+ *
+ * 添加时即换算为 ECEF，逐帧解算只做差分、旋转与求角，
+ * 目标不变而载机运动时无需重复三角函数运算。
+ */
+class GIMBAL_EXPORT PointingTargets {
+public:
+  void reserve(size_t count);
+  void clear();
+  size_t size() const { return x_.size(); }
+
+  // 添加一个目标，返回其下标
+  size_t add(double lat_deg, double lon_deg, double alt_m);
+
+  const double *x() const { return x_.data(); }
+  const double *y() const { return y_.data(); }
+  const double *z() const { return z_.data(); }
+
+private:
+  std::vector<double> x_, y_, z_; // ECEF (m)
+};
+
+// 解算结果，与 PointingTargets 下标一一对应
+struct PointingSolution {
+  std::vector<float> yaw;     // deg，机体系，右为正
+  std::vector<float> pitch;   // deg，抬头为正
+  std::vector<float> range_m; // 斜距
+  std::vector<uint8_t> clamped; // 1 表示超出 ±kGimbalAngleLimit 被限幅
+};
+
+/**
+ * @brief 批量指向解算：LLA -> ECEF -> NED -> 机体系 -> 云台角度
+ *
+ * 载机位姿每帧换算一次 (双精度)；逐目标以双精度求 ECEF 差分后转为单精度，
+ * 经合并后的 ECEF->机体旋转矩阵与多项式 atan2 求角。各循环无分支、
+ * 按数组顺序访问，便于编译器向量化。角度误差小于 0.001 度，
+ * 远小于协议的 0.01 度分辨率。
+ *
+ * @param pose 载机位姿
+ * @param targets 目标
+ * @param solution 输出，按目标数调整大小
+ * @return size_t 被限幅的目标数
+ */
+GIMBAL_EXPORT size_t solvePointing(const VehiclePose &pose,
+                                   const PointingTargets &targets,
+                                   PointingSolution &solution);
+
+#endif
@@ -0,0 +1,304 @@
+#ifndef __GIMBAL_PROTOCOL_H__
+#define __GIMBAL_PROTOCOL_H__
+
+/**
+ * @brief C12 #TP 协议描述表
+ *
+ * 每个标识位的地址对、读写能力、载荷格式、应答方式、同步等待时间与
+ * 状态缓存字段集中在 kDescriptors 中声明。编码器按表在编译期确定帧头，
+ * 接收侧以编译期求出的完美哈希把标识位映射为 Id。新增指令只需在
+ * Id 与 kDescriptors 中各加一项。
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace tp {
+
+// 标识位，顺序与 kDescriptors 一致
+enum class Id : uint8_t {
+  GAY, // 航向角
+  GAP, // 俯仰角
+  GAR, // 横滚角
+  GSY, // 航向速度
+  GSP, // 俯仰速度
+  GAA, // 姿态主动送出频率
+  GAC, // 姿态 (云台主动送出)
+  PTZ, // 云台动作 / 安装模式
+  DZM, // 变焦
+  REC, // 录像
+  CAP, // 拍照
+  IMG, // 伪彩模式
+  VER, // 固件版本
+  IPV, // IP 地址
+  GTW, // 网关
+  UID, // 设备编号
+  VID, // 视频参数
+  EXT, // 扩展能力
+  TAS, // 任务状态
+  ERE, // 错误应答
+  COUNT
+};
+
+// 写指令载荷
+enum class Payload : uint8_t {
+  NONE,  // 不可写
+  BYTE,  // #TP 定长帧，1 字节两位十六进制
+  ANGLE, // #TP 变长帧，16 位有符号角度 (0.01 度) + 1 字节速度
+  TEXT,  // #tp 帧，ASCII 数据，长度位为字符数
+};
+
+// 应答方式
+enum class Reply : uint8_t {
+  ECHO,  // 写指令原样回显 (地址互换)，读指令应答携带数据
+  PUSH,  // 云台主动送出，无对应指令
+  ERROR, // 错误应答，不携带原标识位，按地址关联到最早的待确认指令
+};
+
+// 不缓存
+constexpr int8_t kNoCache = -1;
+// 同步写指令不等待应答
+constexpr int16_t kNoWait = -1;
+
+struct Descriptor {
+  char name[4];
+  char source; // 源地址
+  char dest;   // 目的地址
+  bool readable;
+  Payload payload;
+  Reply reply;
+  int16_t timeout_ms; // 同步写指令等待应答的时间，kNoWait 为只发不等
+  int8_t cache_field; // GimbalCtrl::StateField 下标
+  bool latest_wins;   // 排队中的同类写指令可被更新的值覆盖
+};
+
+// 与 GimbalCtrl::StateField 的下标一致
+namespace field {
+constexpr int8_t RECORDING = 0;
+constexpr int8_t ZOOM = 1;
+constexpr int8_t COLOR_MODE = 2;
+constexpr int8_t INSTALL_MODE = 3;
+constexpr int8_t YAW_TARGET = 4;
+constexpr int8_t PITCH_TARGET = 5;
+constexpr int8_t ROLL_TARGET = 6;
+} // namespace field
+
+// clang-format off
+constexpr Descriptor kDescriptors[] = {
+  // name   src  dst  read   payload           reply         timeout  cache                 latest
+  {"GAY",  'U', 'G', false, Payload::ANGLE, Reply::ECHO,  kNoWait, field::YAW_TARGET,   true},
+  {"GAP",  'U', 'G', false, Payload::ANGLE, Reply::ECHO,  kNoWait, field::PITCH_TARGET, true},
+  {"GAR",  'U', 'G', false, Payload::ANGLE, Reply::ECHO,  kNoWait, field::ROLL_TARGET,  true},
+  {"GSY",  'U', 'G', false, Payload::BYTE,  Reply::ECHO,  kNoWait, kNoCache,            true},
+  {"GSP",  'U', 'G', false, Payload::BYTE,  Reply::ECHO,  kNoWait, kNoCache,            true},
+  {"GAA",  'U', 'G', false, Payload::BYTE,  Reply::ECHO,  999,     kNoCache,            false},
+  {"GAC",  'U', 'G', false, Payload::NONE,  Reply::PUSH,  kNoWait, kNoCache,            false},
+  {"PTZ",  'U', 'G', false, Payload::BYTE,  Reply::ECHO,  1000,    field::INSTALL_MODE, false},
+  {"DZM",  'U', 'G', false, Payload::BYTE,  Reply::ECHO,  999,     field::ZOOM,         false},
+  {"REC",  'U', 'D', true,  Payload::BYTE,  Reply::ECHO,  999,     field::RECORDING,    false},
+  {"CAP",  'U', 'D', false, Payload::BYTE,  Reply::ECHO,  999,     kNoCache,            false},
+  {"IMG",  'U', 'D', false, Payload::BYTE,  Reply::ECHO,  999,     field::COLOR_MODE,   true},
+  {"VER",  'U', 'D', true,  Payload::NONE,  Reply::ECHO,  999,     kNoCache,            false},
+  {"IPV",  'U', 'D', true,  Payload::TEXT,  Reply::ECHO,  999,     kNoCache,            false},
+  {"GTW",  'U', 'D', true,  Payload::TEXT,  Reply::ECHO,  999,     kNoCache,            false},
+  {"UID",  'U', 'D', true,  Payload::NONE,  Reply::ECHO,  999,     kNoCache,            false},
+  {"VID",  'U', 'D', true,  Payload::NONE,  Reply::ECHO,  999,     kNoCache,            false},
+  {"EXT",  'U', 'D', true,  Payload::NONE,  Reply::ECHO,  999,     kNoCache,            false},
+  {"TAS",  'U', 'D', true,  Payload::NONE,  Reply::ECHO,  999,     kNoCache,            false},
+  {"ERE",  'D', 'U', false, Payload::NONE,  Reply::ERROR, kNoWait, kNoCache,            false},
+};
+// clang-format on
+
+static_assert(sizeof(kDescriptors) / sizeof(kDescriptors[0]) ==
+                  static_cast<size_t>(Id::COUNT),
+              "kDescriptors must have one entry per tp::Id");
+
+constexpr const Descriptor &describe(Id id) {
+  return kDescriptors[static_cast<size_t>(id)];
+}
+
+// ---------------------------------------------------------------------------
+// 接收侧：标识位 -> Id 的完美哈希，乘数在编译期搜索
+// ---------------------------------------------------------------------------
+
+constexpr uint32_t nameKey(const char *name) {
+  return static_cast<uint32_t>(static_cast<uint8_t>(name[0])) << 16 |
+         static_cast<uint32_t>(static_cast<uint8_t>(name[1])) << 8 |
+         static_cast<uint32_t>(static_cast<uint8_t>(name[2]));
+}
+
+constexpr int kHashBits = 6;
+constexpr size_t kHashSlots = size_t{1} << kHashBits;
+
+constexpr uint32_t hashSlot(uint32_t key, uint32_t multiplier) {
+  return (key * multiplier) >> (32 - kHashBits);
+}
+
+// 搜索使所有标识位落入不同槽位的乘数
+constexpr uint32_t findMultiplier() {
+  for (uint32_t multiplier = 0x9E3779B1u;; multiplier += 2) {
+    bool used[kHashSlots] = {};
+    bool collision = false;
+    for (const Descriptor &d : kDescriptors) {
+      uint32_t slot = hashSlot(nameKey(d.name), multiplier);
+      if (used[slot]) {
+        collision = true;
+        break;
+      }
+      used[slot] = true;
+    }
+    if (!collision)
+      return multiplier;
+  }
+}
+
+constexpr uint32_t kHashMultiplier = findMultiplier();
+
+constexpr std::array<Id, kHashSlots> buildHashTable() {
+  std::array<Id, kHashSlots> table{};
+  for (auto &slot : table)
+    slot = Id::COUNT;
+  for (size_t i = 0; i < static_cast<size_t>(Id::COUNT); i++)
+    table[hashSlot(nameKey(kDescriptors[i].name), kHashMultiplier)] =
+        static_cast<Id>(i);
+  return table;
+}
+
+constexpr std::array<Id, kHashSlots> kHashTable = buildHashTable();
+
+// 标识位查表，未知标识位返回 Id::COUNT
+constexpr Id lookup(std::string_view name) {
+  if (name.size() < 3)
+    return Id::COUNT;
+  uint32_t key = static_cast<uint32_t>(static_cast<uint8_t>(name[0])) << 16 |
+                 static_cast<uint32_t>(static_cast<uint8_t>(name[1])) << 8 |
+                 static_cast<uint32_t>(static_cast<uint8_t>(name[2]));
+  Id id = kHashTable[hashSlot(key, kHashMultiplier)];
+  if (id == Id::COUNT || nameKey(describe(id).name) != key)
+    return Id::COUNT;
+  return id;
+}
+
+static_assert(lookup("GAC") == Id::GAC && lookup("ERE") == Id::ERE &&
+                  lookup("XYZ") == Id::COUNT,
+              "perfect hash must round-trip every identifier");
+
+// 帧的标识位 Id，帧过短返回 Id::COUNT
+inline Id frameId(std::string_view frame) {
+  return frame.size() < 10 ? Id::COUNT : lookup(frame.substr(7, 3));
+}
+
+// ---------------------------------------------------------------------------
+// 发送侧：按表编码，帧头在编译期确定，运行时只写载荷与校验
+// ---------------------------------------------------------------------------
+
+// 数据长度位只有一位十六进制数
+constexpr size_t kMaxDataLen = 0x0F;
+// 帧头 (#TP、地址位、长度位、控制位、标识位) + 数据 + 校验
+constexpr size_t kMaxFrameLen = 10 + kMaxDataLen + 2;
+
+namespace detail {
+constexpr char kHexDigits[] = "0123456789ABCDEF";
+
+// 写满或数据长度超出长度位时 finish() 返回空帧
+class FrameWriter {
+public:
+  FrameWriter(const Descriptor &d, bool text, char control, size_t data_len) {
+    overflow_ = data_len > kMaxDataLen;
+    put('#');
+    put(text ? 't' : 'T');
+    put(text ? 'p' : 'P');
+    put(d.source);
+    put(d.dest);
+    put(kHexDigits[data_len & 0x0F]);
+    put(control);
+    put(d.name[0]);
+    put(d.name[1]);
+    put(d.name[2]);
+  }
+
+  void hex(uint8_t byte) {
+    put(kHexDigits[byte >> 4]);
+    put(kHexDigits[byte & 0x0F]);
+  }
+
+  void text(std::string_view data) {
+    for (char c : data)
+      put(c);
+  }
+
+  std::string finish() {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < len_; i++)
+      crc += static_cast<uint8_t>(buf_[i]);
+    hex(crc);
+    return overflow_ ? std::string() : std::string(buf_, len_);
+  }
+
+private:
+  void put(char c) {
+    if (len_ < sizeof(buf_))
+      buf_[len_++] = c;
+    else
+      overflow_ = true;
+  }
+
+  char buf_[kMaxFrameLen];
+  size_t len_ = 0;
+  bool overflow_ = false;
+};
+} // namespace detail
+
+// 读指令：#TP<src><dst>2r<ID>00
+template <Id I> std::string encodeRead() {
+  static_assert(describe(I).readable, "identifier is not readable");
+  detail::FrameWriter writer(describe(I), false, 'r', 2);
+  writer.hex(0x00);
+  return writer.finish();
+}
+
+// 定长写指令：#TP<src><dst>2w<ID><XX>
+template <Id I> std::string encodeWrite(uint8_t value) {
+  static_assert(describe(I).payload == Payload::BYTE,
+                "identifier does not take a one-byte payload");
+  detail::FrameWriter writer(describe(I), false, 'w', 2);
+  writer.hex(value);
+  return writer.finish();
+}
+
+// 角度写指令：#TP<src><dst>6w<ID><AAAA><SS>
+template <Id I> std::string encodeWrite(int16_t angle, uint8_t speed) {
+  static_assert(describe(I).payload == Payload::ANGLE,
+                "identifier does not take an angle payload");
+  detail::FrameWriter writer(describe(I), false, 'w', 6);
+  writer.hex(static_cast<uint8_t>((angle >> 8) & 0xFF));
+  writer.hex(static_cast<uint8_t>(angle & 0xFF));
+  writer.hex(speed);
+  return writer.finish();
+}
+
+// 文本写指令：#tp<src><dst><N>w<ID><text>，N 仅一位，
+// 文本超过 kMaxDataLen 字节时返回空帧
+template <Id I> std::string encodeWrite(std::string_view text) {
+  static_assert(describe(I).payload == Payload::TEXT,
+                "identifier does not take a text payload");
+  if (text.size() > kMaxDataLen)
+    return std::string();
+  detail::FrameWriter writer(describe(I), true, 'w', text.size());
+  writer.text(text);
+  return writer.finish();
+}
+
+// 运行时按 Id 编码读指令，用于遍历标识位列表 (如启动探测)
+inline std::string encodeRead(Id id) {
+  detail::FrameWriter writer(describe(id), false, 'r', 2);
+  writer.hex(0x00);
+  return writer.finish();
+}
+
+} // namespace tp
+
+#endif
@@ -0,0 +1,100 @@
+#include "gimbal_rx_buffer.h"
+
+#include <cstring>
+
+RxBufferRef::RxBufferRef(const RxBufferRef &other) : slot_(other.slot_) {
+  if (slot_ != nullptr)
+    slot_->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+RxBufferRef &RxBufferRef::operator=(const RxBufferRef &other) {
+  if (other.slot_ != nullptr)
+    other.slot_->refs.fetch_add(1, std::memory_order_relaxed);
+  reset();
+  slot_ = other.slot_;
+  return *this;
+}
+
+RxBufferRef &RxBufferRef::operator=(RxBufferRef &&other) noexcept {
+  if (this != &other) {
+    reset();
+    slot_ = other.slot_;
+    other.slot_ = nullptr;
+  }
+  return *this;
+}
+
+void RxBufferRef::reset() {
+  RxBufferSlot *slot = slot_;
+  slot_ = nullptr;
+  if (slot == nullptr ||
+      slot->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+    return;
+
+  if (slot->pool != nullptr) {
+    slot->pool->recycle(slot);
+    return;
+  }
+  delete[] slot->heap;
+  delete slot;
+}
+
+RxBufferPool *RxBufferPool::create(size_t slots) {
+  return new RxBufferPool(slots);
+}
+
+RxBufferPool::RxBufferPool(size_t slots)
+    : slots_(new RxBufferSlot[slots]) {
+  free_.reserve(slots);
+  for (size_t i = 0; i < slots; i++) {
+    slots_[i].pool = this;
+    free_.push_back(&slots_[i]);
+  }
+}
+
+void RxBufferPool::release() { unref(); }
+
+void RxBufferPool::unref() {
+  if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    delete this;
+}
+
+RxBufferRef RxBufferPool::copy(std::string_view data) {
+  RxBufferSlot *slot = nullptr;
+  if (data.size() <= kRxSlotCapacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!free_.empty()) {
+      slot = free_.back();
+      free_.pop_back();
+    }
+  }
+
+  if (slot != nullptr) {
+    refs_.fetch_add(1, std::memory_order_relaxed);
+    memcpy(slot->inline_data, data.data(), data.size());
+    slot->inline_data[data.size()] = '\0';
+  } else {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    slot = new RxBufferSlot;
+    if (data.size() > kRxSlotCapacity) {
+      slot->heap = new char[data.size() + 1];
+      memcpy(slot->heap, data.data(), data.size());
+      slot->heap[data.size()] = '\0';
+    } else {
+      memcpy(slot->inline_data, data.data(), data.size());
+      slot->inline_data[data.size()] = '\0';
+    }
+  }
+
+  slot->size = static_cast<uint32_t>(data.size());
+  slot->refs.store(1, std::memory_order_relaxed);
+  return RxBufferRef(slot);
+}
+
+void RxBufferPool::recycle(RxBufferSlot *slot) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_.push_back(slot);
+  }
+  unref();
+}
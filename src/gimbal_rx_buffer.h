@@ -0,0 +1,99 @@
+#ifndef __GIMBAL_RX_BUFFER_H__
+#define __GIMBAL_RX_BUFFER_H__
+
+#include "gimbal_export.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class RxBufferPool;
+
+// 槽位内联容量，#TP 帧最长 27 字节
+constexpr size_t kRxSlotCapacity = 63;
+
+// 接收缓冲槽位，pool 为空表示池耗尽时在堆上分配的槽位
+struct RxBufferSlot {
+  std::atomic<uint32_t> refs{0};
+  uint32_t size = 0;
+  RxBufferPool *pool = nullptr;
+  char *heap = nullptr; // 超出内联容量的帧
+  char inline_data[kRxSlotCapacity + 1];
+
+  const char *data() const { return heap != nullptr ? heap : inline_data; }
+};
+
+/**
+ * @brief 接收缓冲引用：以 string_view 访问池中的一帧回包
+ *
+ * 可复制，复制只增加引用计数；最后一个引用释放时槽位归还缓冲池。
+ * 内容以 '\0' 结尾，可直接作为 C 字符串使用。
+ */
+class GIMBAL_EXPORT RxBufferRef {
+public:
+  RxBufferRef() = default;
+  RxBufferRef(const RxBufferRef &other);
+  RxBufferRef(RxBufferRef &&other) noexcept : slot_(other.slot_) {
+    other.slot_ = nullptr;
+  }
+  RxBufferRef &operator=(const RxBufferRef &other);
+  RxBufferRef &operator=(RxBufferRef &&other) noexcept;
+  ~RxBufferRef() { reset(); }
+
+  void reset();
+
+  std::string_view view() const {
+    return slot_ != nullptr ? std::string_view(slot_->data(), slot_->size)
+                            : std::string_view();
+  }
+  operator std::string_view() const { return view(); }
+
+  const char *data() const { return slot_ != nullptr ? slot_->data() : ""; }
+  const char *c_str() const { return data(); }
+  size_t size() const { return slot_ != nullptr ? slot_->size : 0; }
+  bool empty() const { return size() == 0; }
+  std::string str() const { return std::string(view()); }
+
+private:
+  friend class RxBufferPool;
+  explicit RxBufferRef(RxBufferSlot *slot) : slot_(slot) {}
+
+  RxBufferSlot *slot_ = nullptr;
+};
+
+/**
+ * @brief 固定槽位的接收缓冲池
+ *
+ * 槽位一次性分配，取用与归还不再分配内存；池耗尽或帧超出内联容量时
+ * 退化为堆分配并计入 misses()。缓冲池在所有者调用 release() 且所有
+ * 引用释放后销毁，因此回包可在 GimbalCtrl 析构后继续持有。
+ */
+class GIMBAL_EXPORT RxBufferPool {
+public:
+  static RxBufferPool *create(size_t slots);
+  void release(); // 所有者释放
+
+  // 把一帧拷入空闲槽位
+  RxBufferRef copy(std::string_view data);
+
+  uint64_t misses() const { return misses_.load(std::memory_order_relaxed); }
+
+private:
+  friend class RxBufferRef;
+  explicit RxBufferPool(size_t slots);
+  void recycle(RxBufferSlot *slot);
+  void unref();
+
+  std::unique_ptr<RxBufferSlot[]> slots_;
+  std::vector<RxBufferSlot *> free_;
+  std::mutex mutex_;
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<size_t> refs_{1}; // 所有者 + 已借出的槽位
+};
+
+#endif
@@ -0,0 +1,140 @@
+#include "gimbal_scan.h"
+#include "gimbal_pointing.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr float kTwoPi = 6.28318530717958647692f;
+
+// 按步长均分 [from, to] 的区间数，from == to 时为 0
+int divisions(float from, float to, float step) {
+  if (from == to)
+    return 0;
+  if (step <= 0.0f)
+    return 1;
+  return std::max(1, static_cast<int>(std::ceil(std::fabs(to - from) / step -
+                                                1e-3f)));
+}
+
+// 第 k / n 个等分点
+float lerp(float from, float to, int k, int n) {
+  return n == 0 ? from : from + (to - from) * k / n;
+}
+
+float clampAngle(float angle) {
+  return std::max(-kGimbalAngleLimit, std::min(kGimbalAngleLimit, angle));
+}
+} // namespace
+
+void ScanPattern::add(float yaw, float pitch, int dwell_ms, bool capture) {
+  ScanPoint point;
+  point.yaw = clampAngle(yaw);
+  point.pitch = clampAngle(pitch);
+  point.dwell_ms = std::max(0, dwell_ms);
+  point.capture_ms = capture ? point.dwell_ms / 2 : -1;
+  points_.push_back(point);
+}
+
+ScanPattern ScanPattern::raster(float yaw_from, float yaw_to, float pitch_from,
+                                float pitch_to, float yaw_step,
+                                float pitch_step, int dwell_ms, bool capture) {
+  ScanPattern pattern;
+  int columns = divisions(yaw_from, yaw_to, yaw_step);
+  int rows = divisions(pitch_from, pitch_to, pitch_step);
+  for (int r = 0; r <= rows; r++) {
+    float pitch = lerp(pitch_from, pitch_to, r, rows);
+    for (int c = 0; c <= columns; c++) {
+      int k = r % 2 == 0 ? c : columns - c;
+      pattern.add(lerp(yaw_from, yaw_to, k, columns), pitch, dwell_ms,
+                  capture);
+    }
+  }
+  return pattern;
+}
+
+ScanPattern ScanPattern::sector(float yaw_from, float yaw_to, float pitch,
+                                float yaw_step, int dwell_ms, int sweeps,
+                                bool capture) {
+  ScanPattern pattern;
+  int columns = divisions(yaw_from, yaw_to, yaw_step);
+  for (int s = 0; s < std::max(1, sweeps); s++) {
+    // 折返点不重复
+    for (int c = s == 0 ? 0 : 1; c <= columns; c++) {
+      int k = s % 2 == 0 ? c : columns - c;
+      pattern.add(lerp(yaw_from, yaw_to, k, columns), pitch, dwell_ms,
+                  capture);
+    }
+  }
+  return pattern;
+}
+
+ScanPattern ScanPattern::spiral(float yaw, float pitch, float radius,
+                                float step, int dwell_ms, bool capture) {
+  ScanPattern pattern;
+  pattern.add(yaw, pitch, dwell_ms, capture);
+  if (step <= 0.0f || radius <= 0.0f)
+    return pattern;
+
+  // r = b * theta，每圈外扩 step；按弧长 step 取点
+  const float b = step / kTwoPi;
+  float theta = kTwoPi * 0.5f;
+  for (float r = b * theta; r <= radius + 1e-3f; r = b * theta) {
+    pattern.add(yaw + r * std::cos(theta), pitch + r * std::sin(theta),
+                dwell_ms, capture);
+    theta += step / r;
+  }
+  return pattern;
+}
+
+ScanPattern ScanPattern::waypoints(std::vector<ScanPoint> points) {
+  ScanPattern pattern;
+  pattern.points_ = std::move(points);
+  for (ScanPoint &point : pattern.points_) {
+    point.yaw = clampAngle(point.yaw);
+    point.pitch = clampAngle(point.pitch);
+    point.dwell_ms = std::max(0, point.dwell_ms);
+  }
+  return pattern;
+}
+
+ScanSchedule ScanSchedule::plan(const ScanPattern &pattern, float yaw,
+                                float pitch, double max_rate,
+                                double max_accel, double max_jerk) {
+  ScanSchedule schedule;
+  schedule.legs_.reserve(pattern.size());
+  double t = 0.0;
+  for (const ScanPoint &point : pattern.points()) {
+    ScanLeg leg;
+    leg.yaw_from = yaw;
+    leg.pitch_from = pitch;
+    leg.point = point;
+    leg.yaw = MotionProfile::plan(point.yaw - yaw, max_rate, max_accel,
+                                  max_jerk);
+    leg.pitch = MotionProfile::plan(point.pitch - pitch, max_rate, max_accel,
+                                    max_jerk);
+    double duration = std::max(leg.yaw.duration(), leg.pitch.duration());
+    leg.yaw.stretch(duration);
+    leg.pitch.stretch(duration);
+
+    leg.start_s = t;
+    leg.arrive_s = t + duration;
+    leg.leave_s = leg.arrive_s + point.dwell_ms / 1000.0;
+    if (point.capture_ms >= 0) {
+      leg.capture_s =
+          leg.arrive_s + std::min(point.capture_ms, point.dwell_ms) / 1000.0;
+      schedule.captures_++;
+    }
+    t = leg.leave_s;
+    yaw = point.yaw;
+    pitch = point.pitch;
+    schedule.legs_.push_back(leg);
+  }
+  return schedule;
+}
+
+size_t ScanSchedule::nextCapture(size_t from) const {
+  while (from < legs_.size() && legs_[from].capture_s < 0.0)
+    from++;
+  return from;
+}
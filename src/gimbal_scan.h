@@ -0,0 +1,90 @@
+#ifndef __GIMBAL_SCAN_H__
+#define __GIMBAL_SCAN_H__
+
+#include "gimbal_export.h"
+#include "gimbal_motion.h"
+
+#include <cstddef>
+#include <vector>
+
+// 扫描航点
+struct ScanPoint {
+  float yaw = 0.0f;   // deg
+  float pitch = 0.0f; // deg
+  int dwell_ms = 0;   // 到位后驻留时长，0 为不停留直接驶向下一点
+  int capture_ms = -1; // 到位后第 capture_ms 毫秒拍照，负数不拍
+};
+
+/**
+ * @brief 扫描图样：按执行顺序排列的航点
+ *
+ * 工厂函数生成的图样在驻留中点拍照，角度限幅到 ±kGimbalAngleLimit。
+ */
+class GIMBAL_EXPORT ScanPattern {
+public:
+  /**
+   * @brief 栅格扫描，逐行往返 (蛇形)，行内沿航向步进
+   *
+   * 步长按范围均分，保证端点落在栅格上
+   */
+  static ScanPattern raster(float yaw_from, float yaw_to, float pitch_from,
+                            float pitch_to, float yaw_step, float pitch_step,
+                            int dwell_ms, bool capture = true);
+
+  // 扇扫：固定俯仰，沿航向往返 sweeps 趟
+  static ScanPattern sector(float yaw_from, float yaw_to, float pitch,
+                            float yaw_step, int dwell_ms, int sweeps = 1,
+                            bool capture = true);
+
+  // 阿基米德螺线，由中心向外，圈距与点距均约为 step
+  static ScanPattern spiral(float yaw, float pitch, float radius, float step,
+                            int dwell_ms, bool capture = true);
+
+  static ScanPattern waypoints(std::vector<ScanPoint> points);
+
+  const std::vector<ScanPoint> &points() const { return points_; }
+  size_t size() const { return points_.size(); }
+
+private:
+  void add(float yaw, float pitch, int dwell_ms, bool capture);
+
+  std::vector<ScanPoint> points_;
+};
+
+// 扫描计划中的一段：由上一点运动到本点并驻留，时刻均相对扫描开始 (s)
+struct ScanLeg {
+  MotionProfile yaw;
+  MotionProfile pitch;
+  float yaw_from = 0.0f;
+  float pitch_from = 0.0f;
+  ScanPoint point;
+  double start_s = 0.0;    // 开始运动
+  double arrive_s = 0.0;   // 曲线结束，下发角度锁定
+  double leave_s = 0.0;    // 驻留结束，即下一段的 start_s
+  double capture_s = -1.0; // 拍照时刻，负数不拍
+};
+
+/**
+ * @brief 扫描时间表：启动前由起始姿态逐段规划限加加速度曲线
+ *
+ * 每段两轴按较慢轴同时到达，拍照时刻限制在驻留期内。
+ */
+class GIMBAL_EXPORT ScanSchedule {
+public:
+  static ScanSchedule plan(const ScanPattern &pattern, float yaw, float pitch,
+                           double max_rate, double max_accel,
+                           double max_jerk);
+
+  const std::vector<ScanLeg> &legs() const { return legs_; }
+  double duration() const { return legs_.empty() ? 0.0 : legs_.back().leave_s; }
+  size_t captures() const { return captures_; }
+
+  // 第 from 段起 (含) 的第一个拍照段，没有时返回 legs().size()
+  size_t nextCapture(size_t from) const;
+
+private:
+  std::vector<ScanLeg> legs_;
+  size_t captures_ = 0;
+};
+
+#endif
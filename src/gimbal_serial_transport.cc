@@ -0,0 +1,267 @@
+#include "gimbal_serial_transport.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+// 帧头到长度位 (含) 的字节数
+constexpr size_t kHeaderSize = 6;
+// 除数据位外的固定长度：帧头 3 + 地址 2 + 长度 1 + 控制 1 + 标识 3 + 校验 2
+constexpr size_t kFrameOverhead = 12;
+// 接收线程每次最多交出的帧数
+constexpr size_t kMaxBatch = 32;
+// 写缓冲满时等待可写的时间
+constexpr int kWriteTimeoutMs = 100;
+
+int hexDigit(char c) {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  return -1;
+}
+
+speed_t baudConstant(int baud) {
+  switch (baud) {
+  case 9600:
+    return B9600;
+  case 19200:
+    return B19200;
+  case 38400:
+    return B38400;
+  case 57600:
+    return B57600;
+  case 115200:
+    return B115200;
+  case 230400:
+    return B230400;
+  case 460800:
+    return B460800;
+  case 921600:
+    return B921600;
+  default:
+    return B0;
+  }
+}
+} // namespace
+
+void FrameAssembler::append(const char *data, size_t len) {
+  buffer_.append(data, len);
+}
+
+bool FrameAssembler::next(std::string &frame) {
+  size_t pos = 0;
+  while (true) {
+    pos = buffer_.find('#', pos);
+    if (pos == std::string::npos) {
+      dropped_ += buffer_.size();
+      buffer_.clear();
+      return false;
+    }
+    if (buffer_.size() - pos < kHeaderSize)
+      break;
+
+    bool head_ok = (buffer_.compare(pos + 1, 2, "TP") == 0 ||
+                    buffer_.compare(pos + 1, 2, "tp") == 0);
+    int len = hexDigit(buffer_[pos + 5]);
+    if (!head_ok || len < 0) {
+      pos++;
+      continue;
+    }
+
+    size_t frame_size = kFrameOverhead + static_cast<size_t>(len);
+    if (buffer_.size() - pos < frame_size)
+      break;
+
+    uint8_t crc = 0;
+    for (size_t i = pos; i < pos + frame_size - 2; i++)
+      crc += static_cast<uint8_t>(buffer_[i]);
+    int hi = hexDigit(buffer_[pos + frame_size - 2]);
+    int lo = hexDigit(buffer_[pos + frame_size - 1]);
+    if (hi < 0 || lo < 0 || ((hi << 4) | lo) != crc) {
+      pos++;
+      continue;
+    }
+
+    dropped_ += pos;
+    frame.assign(buffer_, pos, frame_size);
+    buffer_.erase(0, pos + frame_size);
+    return true;
+  }
+
+  // 保留可能的半帧，丢弃之前的噪声
+  dropped_ += pos;
+  buffer_.erase(0, pos);
+  return false;
+}
+
+SerialTransport::SerialTransport(const std::string &device, int baud) {
+  speed_t speed = baudConstant(baud);
+  if (speed == B0)
+    throw SocketException("Unsupported baud rate " + std::to_string(baud));
+
+  fd_ = open(device.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+  if (fd_ < 0)
+    throw SocketException("Open serial " + device + " failed (open())", true);
+
+  termios tio;
+  if (tcgetattr(fd_, &tio) < 0) {
+    close(fd_);
+    throw SocketException("Serial setup failed (tcgetattr())", true);
+  }
+  cfmakeraw(&tio);
+  tio.c_cflag |= CLOCAL | CREAD;
+  tio.c_cflag &= ~(CSTOPB | CRTSCTS);
+  tio.c_cc[VMIN] = 0;
+  tio.c_cc[VTIME] = 0;
+  cfsetispeed(&tio, speed);
+  cfsetospeed(&tio, speed);
+  if (tcsetattr(fd_, TCSANOW, &tio) < 0) {
+    close(fd_);
+    throw SocketException("Serial setup failed (tcsetattr())", true);
+  }
+  tcflush(fd_, TCIOFLUSH);
+
+  frames_.reserve(kMaxBatch);
+  views_.resize(kMaxBatch);
+  scratch_.resize(4096);
+}
+
+SerialTransport::~SerialTransport() {
+  if (fd_ >= 0)
+    close(fd_);
+}
+
+void SerialTransport::sendTo(std::string_view frame, const std::string &,
+                             uint16_t) {
+  if (hung_up_)
+    throw SocketException("Serial device hung up");
+
+  // 只锁写端，等待可写期间不阻塞接收
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  size_t written = 0;
+  while (written < frame.size()) {
+    ssize_t n = write(fd_, frame.data() + written, frame.size() - written);
+    if (n > 0) {
+      written += static_cast<size_t>(n);
+      continue;
+    }
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n < 0 && errno != EAGAIN)
+      throw SocketException("Serial write failed (write())", true);
+
+    // 发送缓冲满，等待可写
+    pollfd pfd{fd_, POLLOUT, 0};
+    if (::poll(&pfd, 1, kWriteTimeoutMs) <= 0)
+      throw SocketException("Serial write timeout");
+  }
+}
+
+/**
+ * @brief 等待可读
+ *
+ * 设备挂断 (POLLHUP，或读返回 EIO) 后描述符持续可读，继续 poll 会空转。
+ * 已到达的帧取完后抛出一次 SocketException，此后不再 poll 该描述符，
+ * 只等待 timeout_ms 并返回 false。
+ */
+bool SerialTransport::poll(int timeout_ms) {
+  if (backlog_)
+    return true;
+  if (hung_up_) {
+    if (!hangup_reported_.exchange(true))
+      throw SocketException("Serial device hung up");
+    std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+    return false;
+  }
+
+  pollfd pfd{fd_, POLLIN, 0};
+  int ret = ::poll(&pfd, 1, timeout_ms);
+  if (ret < 0 && errno != EINTR)
+    throw SocketException("Serial poll failed (poll())", true);
+  if (ret <= 0)
+    return false;
+  // 挂断时仍有未读数据则先交给 receive 读出，下一次 poll 再报告
+  if (pfd.revents & POLLHUP)
+    hung_up_ = true;
+  if (pfd.revents & POLLIN)
+    return true;
+  if (hung_up_) {
+    hangup_reported_ = true;
+    throw SocketException("Serial device hung up");
+  }
+  if (pfd.revents & (POLLERR | POLLNVAL))
+    throw SocketException("Serial device error");
+  return false;
+}
+
+// 读出所有已到达的字节，调用方需持有 mutex_
+void SerialTransport::readAvailable() {
+  while (true) {
+    ssize_t n = read(fd_, &scratch_[0], scratch_.size());
+    if (n > 0) {
+      assembler_.append(scratch_.data(), static_cast<size_t>(n));
+      continue;
+    }
+    if (n < 0 && errno == EINTR)
+      continue;
+    // VMIN = VTIME = 0 时无数据读返回 0
+    if (n == 0 || errno == EAGAIN)
+      return;
+    // pty 主端关闭时读返回 EIO
+    if (errno == EIO) {
+      hung_up_ = true;
+      return;
+    }
+    throw SocketException("Serial read failed (read())", true);
+  }
+}
+
+int SerialTransport::receive() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  readAvailable();
+
+  size_t count = 0;
+  frames_.resize(kMaxBatch);
+  while (count < kMaxBatch && assembler_.next(frames_[count]))
+    count++;
+  backlog_ = (count == kMaxBatch);
+
+  timespec stamp{};
+  for (size_t i = 0; i < count; i++) {
+    views_[i].data = frames_[i];
+    views_[i].source = sockaddr_in{};
+    views_[i].rx_stamp = stamp;
+  }
+  return static_cast<int>(count);
+}
+
+RxDatagram SerialTransport::datagram(int i) const { return views_[i]; }
+
+int SerialTransport::drain(const DrainHandler &handler) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  readAvailable();
+
+  int count = 0;
+  std::string frame;
+  sockaddr_in source{};
+  while (assembler_.next(frame)) {
+    if (handler)
+      handler(frame, source);
+    count++;
+  }
+  return count;
+}
+
+uint64_t SerialTransport::droppedBytes() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return assembler_.droppedBytes();
+}
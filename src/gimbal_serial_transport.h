@@ -0,0 +1,77 @@
+#ifndef __GIMBAL_SERIAL_TRANSPORT_H__
+#define __GIMBAL_SERIAL_TRANSPORT_H__
+
+#include "gimbal_transport.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 字节流分帧：从串口字节流中切出完整的 #TP/#tp 帧
+ *
+ * 帧长由长度位决定：帧头 3 + 地址 2 + 长度 1 + 控制 1 + 标识 3 + 数据 + 校验 2。
+ * 校验失败或帧头不完整时丢弃一个字节并向后寻找下一个 '#'，实现失步后的重同步。
+ */
+class GIMBAL_EXPORT FrameAssembler {
+public:
+  void append(const char *data, size_t len);
+
+  // 取出下一帧，无完整帧时返回 false
+  bool next(std::string &frame);
+
+  uint64_t droppedBytes() const { return dropped_; }
+  void clear() { buffer_.clear(); }
+
+private:
+  std::string buffer_;
+  uint64_t dropped_ = 0;
+};
+
+/**
+ * @brief 串口 (TTL UART) 后端：非阻塞 termios 8N1 原始模式
+ *
+ * 串口为点对点链路，发送时忽略目的地址；收到的帧源地址为空。
+ * 不支持内核收发时间戳。设备挂断后 poll 抛出一次 SocketException，
+ * 之后不再读取该设备，发送抛出 SocketException。
+ */
+class GIMBAL_EXPORT SerialTransport : public GimbalTransport {
+public:
+  /**
+   * @param device 串口设备，如 /dev/ttyS1 或 pty 从端
+   * @param baud 波特率，如 115200
+   */
+  explicit SerialTransport(const std::string &device, int baud = 115200);
+  ~SerialTransport() override;
+
+  void sendTo(std::string_view frame, const std::string &ip,
+              uint16_t port) override;
+  bool poll(int timeout_ms) override;
+  int receive() override;
+  RxDatagram datagram(int i) const override;
+  int drain(const DrainHandler &handler) override;
+
+  const char *name() const override { return "serial"; }
+
+  // 重同步时丢弃的字节数
+  uint64_t droppedBytes();
+
+private:
+  void readAvailable();
+
+  int fd_ = -1;
+  std::mutex mutex_;       // 保护分帧缓冲
+  std::mutex write_mutex_; // 串行化写端，避免帧交错
+  FrameAssembler assembler_;
+  std::vector<std::string> frames_; // 本批交给接收线程的帧
+  std::vector<RxDatagram> views_;
+  std::string scratch_;
+  std::atomic<bool> backlog_{false}; // 分帧缓冲中仍有未取走的完整帧
+  std::atomic<bool> hung_up_{false}; // 设备已挂断
+  std::atomic<bool> hangup_reported_{false};
+};
+
+#endif
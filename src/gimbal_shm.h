@@ -0,0 +1,142 @@
+#ifndef __GIMBAL_SHM_H__
+#define __GIMBAL_SHM_H__
+
+/**
+ * @brief 云台状态共享内存布局与读端 (仅头文件，不依赖 gimbal_control 库)
+ *
+ * GimbalCtrl::enableSharedState() 把姿态、缓存的确认状态与链路状态发布到
+ * POSIX 共享内存，以顺序锁 (seqlock) 保护。读端无系统调用、无锁，
+ * 写端正在更新时重读。时间戳为 CLOCK_MONOTONIC 纳秒，与
+ * std::chrono::steady_clock 一致，可直接与本机其他进程的时间比较。
+ *
+ * 旧版 glibc (< 2.34) 需链接 -lrt。
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static constexpr const char *kGimbalShmDefaultName = "/gimbal_state";
+static constexpr uint32_t kGimbalShmMagic = 0x47534D31; // "GSM1"
+static constexpr uint32_t kGimbalShmVersion = 1;
+
+// 一个缓存状态值，valid 为 0 表示从未确认
+struct GimbalShmValue {
+  int32_t value;
+  int32_t valid;
+  int64_t stamp_ns;
+};
+
+// 状态快照，字段含义同 GimbalCtrl::Attitude / StateField / LinkState
+struct GimbalShmSnapshot {
+  float yaw;   // 航向角 (deg)
+  float pitch; // 俯仰角 (deg)
+  float roll;  // 横滚角 (deg)
+  uint32_t link_state;        // 0 UNKNOWN, 1 ALIVE, 2 DEGRADED, 3 DOWN
+  int64_t attitude_stamp_ns;  // 0 为未收到过姿态
+  GimbalShmValue recording;   // 1 录像中
+  GimbalShmValue zoom;        // ZoomMode 枚举值，0x00-0x03 为 1-4 倍
+  GimbalShmValue color_mode;  // 伪彩模式
+  GimbalShmValue install_mode;
+  GimbalShmValue yaw_target;   // 0.01 度
+  GimbalShmValue pitch_target; // 0.01 度
+  GimbalShmValue roll_target;  // 0.01 度
+  uint64_t publish_count;
+  int64_t publish_stamp_ns;
+};
+
+struct GimbalShmSegment {
+  uint32_t magic;
+  uint32_t version;
+  std::atomic<uint32_t> seq; // 奇数表示写端正在更新
+  uint32_t writer_pid;
+  GimbalShmSnapshot snapshot;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "seqlock needs a lock-free 32-bit atomic in shared memory");
+
+// 写端：调用方保证同一时刻只有一个写者
+inline void gimbalShmPublish(GimbalShmSegment *segment,
+                             const GimbalShmSnapshot &snapshot) {
+  uint32_t seq = segment->seq.load(std::memory_order_relaxed);
+  segment->seq.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  memcpy(&segment->snapshot, &snapshot, sizeof(snapshot));
+  segment->seq.store(seq + 2, std::memory_order_release);
+}
+
+class GimbalShmReader {
+public:
+  GimbalShmReader() = default;
+  GimbalShmReader(const GimbalShmReader &) = delete;
+  GimbalShmReader &operator=(const GimbalShmReader &) = delete;
+  ~GimbalShmReader() { close(); }
+
+  // 以只读方式映射，段不存在或版本不符返回 false
+  bool open(const std::string &name = kGimbalShmDefaultName) {
+    close();
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0)
+      return false;
+    void *addr = mmap(nullptr, sizeof(GimbalShmSegment), PROT_READ,
+                      MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED)
+      return false;
+
+    segment_ = static_cast<const GimbalShmSegment *>(addr);
+    if (segment_->magic != kGimbalShmMagic ||
+        segment_->version != kGimbalShmVersion) {
+      close();
+      return false;
+    }
+    return true;
+  }
+
+  void close() {
+    if (segment_ != nullptr)
+      munmap(const_cast<GimbalShmSegment *>(segment_),
+             sizeof(GimbalShmSegment));
+    segment_ = nullptr;
+  }
+
+  bool isOpen() const { return segment_ != nullptr; }
+
+  /**
+   * @brief 读取一致的快照
+   *
+   * @param snapshot 输出
+   * @param max_retries 写端持续更新时的最大重读次数
+   * @return true 读到一致快照
+   * @return false 未打开或重读次数用尽
+   */
+  bool read(GimbalShmSnapshot &snapshot, int max_retries = 1000) const {
+    if (segment_ == nullptr)
+      return false;
+    for (int i = 0; i <= max_retries; i++) {
+      uint32_t begin = segment_->seq.load(std::memory_order_acquire);
+      if (begin & 1)
+        continue;
+      memcpy(&snapshot, &segment_->snapshot, sizeof(snapshot));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (segment_->seq.load(std::memory_order_relaxed) == begin)
+        return true;
+    }
+    return false;
+  }
+
+  // 写端进程号，可用于判断发布者是否仍在运行
+  uint32_t writerPid() const {
+    return segment_ != nullptr ? segment_->writer_pid : 0;
+  }
+
+private:
+  const GimbalShmSegment *segment_ = nullptr;
+};
+
+#endif
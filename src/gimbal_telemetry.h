@@ -0,0 +1,320 @@
+#ifndef __GIMBAL_TELEMETRY_H__
+#define __GIMBAL_TELEMETRY_H__
+
+/**
+ * @brief 列式遥测存储的文件布局与离线读端 (仅头文件，不依赖 gimbal_control 库)
+ *
+ * 写端 (TelemetryWriter，见 gimbal_telemetry_writer.h) 把姿态、下发指令与
+ * 往返时延按通道写入预分配的文件 <prefix>-NNNN.gtl，写满后换下一个文件。
+ * 文件布局：
+ *   - 文件头 TelemetryFileHeader
+ *   - 块索引：每个数据块一项，记录通道、行数与时间范围，写端周期性更新
+ *   - 数据块：大小为页的整数倍，块内按列存放，
+ *     先是 capacity 个 int64 时间戳，再是三列各 capacity 个 32 位字
+ *
+ * 时间戳为 CLOCK_MONOTONIC 纳秒，与 std::chrono::steady_clock 一致；
+ * 文件头同时记录创建时的 CLOCK_REALTIME，用于与飞行日志对时。
+ * 读端只读取文件头与索引，查询时只映射时间范围相交的数据块。
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <vector>
+
+static constexpr uint32_t kTelemetryMagic = 0x47544C31; // "GTL1"
+static constexpr uint32_t kTelemetryVersion = 1;
+static constexpr uint32_t kTelemetryRowBytes = 8 + 3 * 4;
+
+enum class TelemetryChannel : uint32_t {
+  NONE = 0,     // 未使用的块
+  ATTITUDE = 1, // yaw, pitch, roll (float, deg)，时间为接收时间
+  COMMAND = 2,  // 标识符, 物理量 (float), 帧内原始值 (int32)，时间为发送时间
+  RTT = 3,      // 标识符, 往返时延 (float, us), 是否内核时间戳，时间为确认时间
+};
+
+struct TelemetryFileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t block_bytes;
+  uint32_t block_count; // 预分配的数据块数
+  uint64_t data_offset; // 第一个数据块的偏移，页对齐
+  uint32_t file_index;  // 文件序号，即文件名中的 NNNN
+  uint32_t writer_pid;
+  int64_t created_ns;          // CLOCK_MONOTONIC
+  int64_t created_realtime_ns; // CLOCK_REALTIME
+  std::atomic<uint32_t> blocks_used;
+  uint32_t reserved[3];
+};
+
+struct TelemetryBlockIndex {
+  uint32_t channel;           // TelemetryChannel
+  std::atomic<uint32_t> rows; // 已提交的行数，先写数据后发布
+  int64_t t_min_ns;
+  int64_t t_max_ns;
+  uint32_t capacity; // 块内最大行数
+  uint32_t sealed;   // 1 表示已写满或文件已关闭
+};
+
+static_assert(sizeof(TelemetryFileHeader) == 64, "file header layout");
+static_assert(sizeof(TelemetryBlockIndex) == 32, "block index layout");
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "index needs a lock-free 32-bit atomic in a mapped file");
+
+// 第 index 个文件的路径
+inline std::string telemetryFilePath(const std::string &prefix,
+                                     uint32_t index) {
+  char suffix[16];
+  snprintf(suffix, sizeof(suffix), "-%04u.gtl", index);
+  return prefix + suffix;
+}
+
+// 块内第 column 列 (0 为时间戳) 的字节偏移
+inline size_t telemetryColumnOffset(uint32_t capacity, uint32_t column) {
+  return column == 0 ? 0 : capacity * 8ul + (column - 1) * capacity * 4ul;
+}
+
+// 标识符 (如 "GSY") 与列中 32 位字的转换
+inline uint32_t telemetryPackId(const char *id) {
+  uint32_t packed = 0;
+  memcpy(&packed, id, strnlen(id, 3));
+  return packed;
+}
+
+inline std::string telemetryUnpackId(uint32_t packed) {
+  char id[4] = {};
+  memcpy(id, &packed, 3);
+  return id;
+}
+
+// 一个已映射数据块的列视图，仅在 TelemetryReader::forEachBlock 回调内有效
+struct TelemetryBlockView {
+  TelemetryChannel channel;
+  uint32_t rows;
+  const int64_t *t_ns;
+  const uint32_t *column[3];
+
+  float floatAt(uint32_t c, uint32_t row) const {
+    float value;
+    memcpy(&value, &column[c][row], sizeof(value));
+    return value;
+  }
+};
+
+struct TelemetryAttitudeRow {
+  int64_t t_ns;
+  float yaw;
+  float pitch;
+  float roll;
+};
+
+struct TelemetryCommandRow {
+  int64_t t_ns;
+  std::string identifier;
+  float value; // GSY/GSP 为 deg/s，GAY/GAP/GAR 为 deg，其余同 raw
+  int32_t raw;
+};
+
+struct TelemetryRttRow {
+  int64_t t_ns;
+  std::string identifier;
+  float rtt_us;
+  bool kernel;
+};
+
+class TelemetryReader {
+public:
+  TelemetryReader() = default;
+  TelemetryReader(const TelemetryReader &) = delete;
+  TelemetryReader &operator=(const TelemetryReader &) = delete;
+  ~TelemetryReader() { close(); }
+
+  /**
+   * @brief 打开 prefix 下从 0 开始连续编号的全部文件，只读入文件头与块索引
+   *
+   * @return false 第一个文件不存在或版本不符
+   */
+  bool open(const std::string &prefix) {
+    close();
+    for (uint32_t index = 0;; index++) {
+      int fd = ::open(telemetryFilePath(prefix, index).c_str(), O_RDONLY);
+      if (fd < 0)
+        break;
+      File file;
+      file.fd = fd;
+      if (!readIndex(file)) {
+        ::close(fd);
+        break;
+      }
+      files_.push_back(std::move(file));
+    }
+    return !files_.empty();
+  }
+
+  void close() {
+    for (File &file : files_)
+      ::close(file.fd);
+    files_.clear();
+    mapped_bytes_ = 0;
+  }
+
+  bool isOpen() const { return !files_.empty(); }
+  size_t files() const { return files_.size(); }
+
+  // 查询累计映射的数据块字节数
+  uint64_t mappedBytes() const { return mapped_bytes_; }
+
+  // 通道内全部数据的时间范围，无数据返回 false
+  bool timeRange(TelemetryChannel channel, int64_t &first_ns,
+                 int64_t &last_ns) const {
+    bool found = false;
+    for (const File &file : files_)
+      for (const Block &block : file.blocks) {
+        if (block.channel != channel || block.rows == 0)
+          continue;
+        first_ns = found ? std::min(first_ns, block.t_min_ns) : block.t_min_ns;
+        last_ns = found ? std::max(last_ns, block.t_max_ns) : block.t_max_ns;
+        found = true;
+      }
+    return found;
+  }
+
+  /**
+   * @brief 依次映射 channel 中时间范围与 [from_ns, to_ns] 相交的数据块
+   * 块内的行不保证落在查询范围内，由回调按时间戳过滤
+   *
+   * @return size_t 映射的块数
+   */
+  size_t forEachBlock(TelemetryChannel channel, int64_t from_ns, int64_t to_ns,
+                      const std::function<void(const TelemetryBlockView &)>
+                          &callback) {
+    size_t mapped = 0;
+    for (const File &file : files_) {
+      for (const Block &block : file.blocks) {
+        if (block.channel != channel || block.rows == 0 ||
+            block.t_max_ns < from_ns || block.t_min_ns > to_ns)
+          continue;
+        void *addr = mmap(nullptr, file.block_bytes, PROT_READ, MAP_SHARED,
+                          file.fd, block.offset);
+        if (addr == MAP_FAILED)
+          continue;
+        mapped_bytes_ += file.block_bytes;
+        mapped++;
+
+        const char *data = static_cast<const char *>(addr);
+        TelemetryBlockView view;
+        view.channel = channel;
+        view.rows = block.rows;
+        view.t_ns = reinterpret_cast<const int64_t *>(data);
+        for (uint32_t c = 0; c < 3; c++)
+          view.column[c] = reinterpret_cast<const uint32_t *>(
+              data + telemetryColumnOffset(block.capacity, c + 1));
+        callback(view);
+        munmap(addr, file.block_bytes);
+      }
+    }
+    return mapped;
+  }
+
+  size_t attitude(int64_t from_ns, int64_t to_ns,
+                  std::vector<TelemetryAttitudeRow> &rows) {
+    return query(TelemetryChannel::ATTITUDE, from_ns, to_ns, rows,
+                 [](const TelemetryBlockView &v, uint32_t i) {
+                   return TelemetryAttitudeRow{v.t_ns[i], v.floatAt(0, i),
+                                               v.floatAt(1, i),
+                                               v.floatAt(2, i)};
+                 });
+  }
+
+  size_t commands(int64_t from_ns, int64_t to_ns,
+                  std::vector<TelemetryCommandRow> &rows) {
+    return query(TelemetryChannel::COMMAND, from_ns, to_ns, rows,
+                 [](const TelemetryBlockView &v, uint32_t i) {
+                   return TelemetryCommandRow{
+                       v.t_ns[i], telemetryUnpackId(v.column[0][i]),
+                       v.floatAt(1, i), static_cast<int32_t>(v.column[2][i])};
+                 });
+  }
+
+  size_t rtts(int64_t from_ns, int64_t to_ns,
+              std::vector<TelemetryRttRow> &rows) {
+    return query(TelemetryChannel::RTT, from_ns, to_ns, rows,
+                 [](const TelemetryBlockView &v, uint32_t i) {
+                   return TelemetryRttRow{v.t_ns[i],
+                                          telemetryUnpackId(v.column[0][i]),
+                                          v.floatAt(1, i),
+                                          v.column[2][i] != 0};
+                 });
+  }
+
+private:
+  struct Block {
+    TelemetryChannel channel;
+    uint32_t rows;
+    uint32_t capacity;
+    int64_t t_min_ns;
+    int64_t t_max_ns;
+    off_t offset;
+  };
+
+  struct File {
+    int fd = -1;
+    uint32_t block_bytes = 0;
+    std::vector<Block> blocks;
+  };
+
+  bool readIndex(File &file) {
+    TelemetryFileHeader header;
+    if (pread(file.fd, &header, sizeof(header), 0) != sizeof(header) ||
+        header.magic != kTelemetryMagic || header.version != kTelemetryVersion)
+      return false;
+
+    std::vector<TelemetryBlockIndex> index(header.block_count);
+    ssize_t bytes = sizeof(TelemetryBlockIndex) * index.size();
+    if (pread(file.fd, index.data(), bytes, sizeof(header)) != bytes)
+      return false;
+
+    file.block_bytes = header.block_bytes;
+    uint32_t used = std::min(header.blocks_used.load(), header.block_count);
+    for (uint32_t i = 0; i < used; i++) {
+      const TelemetryBlockIndex &entry = index[i];
+      uint32_t rows = std::min(entry.rows.load(), entry.capacity);
+      if (entry.capacity * kTelemetryRowBytes > header.block_bytes)
+        continue;
+      file.blocks.push_back(
+          {static_cast<TelemetryChannel>(entry.channel), rows, entry.capacity,
+           entry.t_min_ns, entry.t_max_ns,
+           static_cast<off_t>(header.data_offset +
+                              uint64_t(i) * header.block_bytes)});
+    }
+    return true;
+  }
+
+  template <typename Row, typename Decode>
+  size_t query(TelemetryChannel channel, int64_t from_ns, int64_t to_ns,
+               std::vector<Row> &rows, Decode decode) {
+    size_t before = rows.size();
+    forEachBlock(channel, from_ns, to_ns, [&](const TelemetryBlockView &v) {
+      for (uint32_t i = 0; i < v.rows; i++)
+        if (v.t_ns[i] >= from_ns && v.t_ns[i] <= to_ns)
+          rows.push_back(decode(v, i));
+    });
+    // 多线程写入时块内时间戳可能有微小乱序
+    std::stable_sort(
+        rows.begin() + before, rows.end(),
+        [](const Row &a, const Row &b) { return a.t_ns < b.t_ns; });
+    return rows.size() - before;
+  }
+
+  std::vector<File> files_;
+  uint64_t mapped_bytes_ = 0;
+};
+
+#endif
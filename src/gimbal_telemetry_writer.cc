@@ -0,0 +1,256 @@
+#include "gimbal_telemetry_writer.h"
+#include "loguru/loguru.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+int64_t clockNs(clockid_t clock) {
+  timespec ts;
+  clock_gettime(clock, &ts);
+  return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+uint32_t floatBits(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+} // namespace
+
+bool TelemetryWriter::open(const std::string &prefix, const Params &params) {
+  close();
+
+  size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  if (params.block_bytes < page || params.block_bytes % page != 0) {
+    LOG_F(ERROR, "TelemetryWriter: block size %zu is not a multiple of %zu",
+          params.block_bytes, page);
+    return false;
+  }
+
+  // 文件头与块索引之后按页对齐放置数据块
+  auto headerBytes = [&](size_t blocks) {
+    size_t bytes = sizeof(TelemetryFileHeader) +
+                   blocks * sizeof(TelemetryBlockIndex);
+    return (bytes + page - 1) / page * page;
+  };
+  size_t blocks = params.file_bytes / params.block_bytes;
+  while (blocks > 0 &&
+         headerBytes(blocks) + blocks * params.block_bytes > params.file_bytes)
+    blocks--;
+  if (blocks == 0) {
+    LOG_F(ERROR, "TelemetryWriter: file size %zu holds no %zu-byte block",
+          params.file_bytes, params.block_bytes);
+    return false;
+  }
+
+  params_ = params;
+  prefix_ = prefix;
+  header_bytes_ = headerBytes(blocks);
+  capacity_ = static_cast<uint32_t>(params.block_bytes / kTelemetryRowBytes);
+  stats_ = Stats();
+  next_publish_ns_ = 0;
+  // 读端按编号连续打开文件，删除同一前缀上次留下的后续文件
+  for (uint32_t index = 1;; index++)
+    if (unlink(telemetryFilePath(prefix, index).c_str()) != 0)
+      break;
+  if (!openFile(0))
+    return false;
+  LOG_F(INFO, "Telemetry log %s: %zu blocks of %u rows per file",
+        prefix.c_str(), blocks, capacity_);
+  return true;
+}
+
+void TelemetryWriter::close() { closeFile(); }
+
+/**
+ * @brief 创建并预分配第 file_index 个文件，映射文件头与块索引
+ */
+bool TelemetryWriter::openFile(uint32_t file_index) {
+  std::string path = telemetryFilePath(prefix_, file_index);
+  int fd = ::open(path.c_str(), O_CREAT | O_RDWR | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    LOG_F(ERROR, "TelemetryWriter: open %s failed: %s", path.c_str(),
+          strerror(errno));
+    return false;
+  }
+
+  uint32_t block_count = static_cast<uint32_t>(
+      (params_.file_bytes - header_bytes_) / params_.block_bytes);
+  off_t size = header_bytes_ + off_t(block_count) * params_.block_bytes;
+  // 一次性分配磁盘空间，磁盘满时在这里失败，而不是写映射内存时收到 SIGBUS
+  int err = posix_fallocate(fd, 0, size);
+  void *addr = MAP_FAILED;
+  if (err == 0)
+    addr = mmap(nullptr, header_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                0);
+  else
+    errno = err;
+  if (addr == MAP_FAILED) {
+    LOG_F(ERROR, "TelemetryWriter: allocate %s (%ld bytes) failed: %s",
+          path.c_str(), static_cast<long>(size), strerror(errno));
+    ::close(fd);
+    unlink(path.c_str());
+    return false;
+  }
+
+  // 读端以 magic 判断文件头是否有效，最后写入
+  auto *header = static_cast<TelemetryFileHeader *>(addr);
+  header->version = kTelemetryVersion;
+  header->block_bytes = static_cast<uint32_t>(params_.block_bytes);
+  header->block_count = block_count;
+  header->data_offset = header_bytes_;
+  header->file_index = file_index;
+  header->writer_pid = static_cast<uint32_t>(getpid());
+  header->created_ns = clockNs(CLOCK_MONOTONIC);
+  header->created_realtime_ns = clockNs(CLOCK_REALTIME);
+  header->blocks_used.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  header->magic = kTelemetryMagic;
+
+  fd_ = fd;
+  header_ = header;
+  file_index_ = file_index;
+  stats_.files++;
+  return true;
+}
+
+/**
+ * @brief 封存全部活动块，截掉未使用的块后关闭当前文件
+ */
+void TelemetryWriter::closeFile() {
+  if (header_ == nullptr)
+    return;
+
+  for (Active &active : active_) {
+    if (active.data == nullptr)
+      continue;
+    publish(active, true);
+    munmap(active.data, params_.block_bytes);
+    active = Active();
+  }
+
+  off_t used = header_->data_offset +
+               off_t(header_->blocks_used.load(std::memory_order_relaxed)) *
+                   params_.block_bytes;
+  munmap(header_, header_bytes_);
+  if (ftruncate(fd_, used) != 0)
+    LOG_F(WARNING, "TelemetryWriter: truncate %s failed: %s",
+          telemetryFilePath(prefix_, file_index_).c_str(), strerror(errno));
+  ::close(fd_);
+  header_ = nullptr;
+  fd_ = -1;
+}
+
+/**
+ * @brief 封存通道的活动块并映射下一个空闲块，文件用尽时换下一个文件
+ *
+ * @param channel 通道下标 (TelemetryChannel - 1)
+ * @return false 文件数达到上限或映射失败
+ */
+bool TelemetryWriter::nextBlock(size_t channel) {
+  Active &active = active_[channel];
+  if (active.data != nullptr) {
+    publish(active, true);
+    munmap(active.data, params_.block_bytes);
+    active = Active();
+  }
+
+  uint32_t block = header_->blocks_used.load(std::memory_order_relaxed);
+  if (block == header_->block_count) {
+    if (params_.max_files != 0 && file_index_ + 1 >= params_.max_files)
+      return false;
+    closeFile();
+    if (!openFile(file_index_ + 1))
+      return false;
+    block = 0;
+  }
+
+  void *addr = mmap(nullptr, params_.block_bytes, PROT_READ | PROT_WRITE,
+                    MAP_SHARED, fd_,
+                    header_->data_offset + off_t(block) * params_.block_bytes);
+  if (addr == MAP_FAILED) {
+    LOG_F(ERROR, "TelemetryWriter: map block %u failed: %s", block,
+          strerror(errno));
+    return false;
+  }
+
+  auto *index = reinterpret_cast<TelemetryBlockIndex *>(header_ + 1);
+  TelemetryBlockIndex &entry = index[block];
+  entry.channel = static_cast<uint32_t>(channel + 1);
+  entry.capacity = capacity_;
+  header_->blocks_used.store(block + 1, std::memory_order_release);
+
+  active.data = static_cast<char *>(addr);
+  active.index = &entry;
+  stats_.blocks++;
+  return true;
+}
+
+// 行数最后以 release 写入，读端看到的行数之内的数据均已写完
+void TelemetryWriter::publish(Active &active, bool seal) {
+  TelemetryBlockIndex &entry = *active.index;
+  entry.t_min_ns = active.t_min_ns;
+  entry.t_max_ns = active.t_max_ns;
+  entry.sealed = seal ? 1 : 0;
+  entry.rows.store(active.rows, std::memory_order_release);
+}
+
+void TelemetryWriter::publishAll(int64_t t_ns) {
+  for (Active &active : active_)
+    if (active.data != nullptr)
+      publish(active, false);
+  next_publish_ns_ = t_ns + params_.index_interval_ms * 1000000LL;
+}
+
+void TelemetryWriter::append(TelemetryChannel channel, int64_t t_ns,
+                             uint32_t c1, uint32_t c2, uint32_t c3) {
+  size_t c = static_cast<size_t>(channel) - 1;
+  if (c >= active_.size())
+    return;
+  Active &active = active_[c];
+  if (header_ == nullptr ||
+      ((active.data == nullptr || active.rows == capacity_) && !nextBlock(c))) {
+    stats_.dropped++;
+    return;
+  }
+
+  uint32_t row = active.rows;
+  reinterpret_cast<int64_t *>(active.data)[row] = t_ns;
+  auto *columns = reinterpret_cast<uint32_t *>(
+      active.data + telemetryColumnOffset(capacity_, 1));
+  columns[row] = c1;
+  columns[capacity_ + row] = c2;
+  columns[2 * capacity_ + row] = c3;
+
+  active.t_min_ns = row == 0 ? t_ns : std::min(active.t_min_ns, t_ns);
+  active.t_max_ns = row == 0 ? t_ns : std::max(active.t_max_ns, t_ns);
+  active.rows = row + 1;
+  stats_.rows[c]++;
+
+  if (t_ns >= next_publish_ns_)
+    publishAll(t_ns);
+}
+
+void TelemetryWriter::attitude(int64_t t_ns, float yaw, float pitch,
+                               float roll) {
+  append(TelemetryChannel::ATTITUDE, t_ns, floatBits(yaw), floatBits(pitch),
+         floatBits(roll));
+}
+
+void TelemetryWriter::command(int64_t t_ns, const char *identifier,
+                              float value, int32_t raw) {
+  append(TelemetryChannel::COMMAND, t_ns, telemetryPackId(identifier),
+         floatBits(value), static_cast<uint32_t>(raw));
+}
+
+void TelemetryWriter::rtt(int64_t t_ns, const char *identifier, float rtt_us,
+                          bool kernel) {
+  append(TelemetryChannel::RTT, t_ns, telemetryPackId(identifier),
+         floatBits(rtt_us), kernel ? 1 : 0);
+}
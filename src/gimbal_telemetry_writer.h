@@ -0,0 +1,86 @@
+#ifndef __GIMBAL_TELEMETRY_WRITER_H__
+#define __GIMBAL_TELEMETRY_WRITER_H__
+
+#include "gimbal_export.h"
+#include "gimbal_telemetry.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief 列式遥测存储的写端 (文件布局与读端见 gimbal_telemetry.h)
+ *
+ * 文件在打开时按 file_bytes 一次性分配磁盘空间，写入只是对映射内存的
+ * 存储，不经过格式化与 write 系统调用。每个通道同时只有一个活动块被映射，
+ * 写满后记入索引、解除映射并取下一个空闲块；文件用尽时换下一个文件，
+ * 超过 max_files 后丢弃新数据并计数。活动块的行数与时间范围按
+ * index_interval_ms (以行时间戳计) 周期性写入索引，进程异常退出时
+ * 最多丢失一个周期的索引，数据本身已在页缓存中。
+ *
+ * 非线程安全，由调用方串行。
+ */
+class GIMBAL_EXPORT TelemetryWriter {
+public:
+  struct Params {
+    size_t file_bytes = 64 << 20;  // 单个文件大小
+    size_t block_bytes = 64 << 10; // 数据块大小，页的整数倍
+    int index_interval_ms = 1000;  // 活动块索引的更新周期
+    uint32_t max_files = 16;       // 0 不限
+  };
+
+  struct Stats {
+    std::array<uint64_t, 3> rows{}; // 按通道 ATTITUDE, COMMAND, RTT
+    uint64_t blocks = 0;            // 已使用的数据块
+    uint32_t files = 0;
+    uint64_t dropped = 0; // 文件数达到上限后丢弃的行
+  };
+
+  TelemetryWriter() = default;
+  TelemetryWriter(const TelemetryWriter &) = delete;
+  TelemetryWriter &operator=(const TelemetryWriter &) = delete;
+  ~TelemetryWriter() { close(); }
+
+  // 创建 <prefix>-0000.gtl 并预分配空间，同一前缀已有的文件被覆盖或删除
+  bool open(const std::string &prefix, const Params &params);
+  void close();
+  bool isOpen() const { return header_ != nullptr; }
+
+  void append(TelemetryChannel channel, int64_t t_ns, uint32_t c1,
+              uint32_t c2, uint32_t c3);
+  void attitude(int64_t t_ns, float yaw, float pitch, float roll);
+  void command(int64_t t_ns, const char *identifier, float value,
+               int32_t raw);
+  void rtt(int64_t t_ns, const char *identifier, float rtt_us, bool kernel);
+
+  Stats stats() const { return stats_; }
+
+private:
+  struct Active {
+    char *data = nullptr; // 映射的活动块，nullptr 表示尚未分配
+    TelemetryBlockIndex *index = nullptr;
+    uint32_t rows = 0;
+    int64_t t_min_ns = 0;
+    int64_t t_max_ns = 0;
+  };
+
+  bool openFile(uint32_t file_index);
+  void closeFile();
+  bool nextBlock(size_t channel);
+  void publish(Active &active, bool seal);
+  void publishAll(int64_t t_ns);
+
+  Params params_;
+  std::string prefix_;
+  int fd_ = -1;
+  TelemetryFileHeader *header_ = nullptr; // 映射的文件头与块索引
+  size_t header_bytes_ = 0;
+  uint32_t capacity_ = 0; // 块内行数
+  uint32_t file_index_ = 0;
+  std::array<Active, 3> active_;
+  int64_t next_publish_ns_ = 0;
+  Stats stats_;
+};
+
+#endif
@@ -0,0 +1,99 @@
+#include "gimbal_timer.h"
+
+#include <algorithm>
+
+GimbalTimer::GimbalTimer() { thread_ = std::thread(&GimbalTimer::loop, this); }
+
+GimbalTimer::~GimbalTimer() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  if (thread_.joinable())
+    thread_.join();
+}
+
+GimbalTimer::TaskId GimbalTimer::schedule(Clock::time_point first,
+                                          Clock::duration period, Task task) {
+  TaskId id;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    id = next_id_++;
+    if (next_id_ == 0)
+      next_id_ = 1;
+    tasks_[id] = Entry{first, std::max(period, Clock::duration::zero()),
+                       std::make_shared<Task>(std::move(task))};
+  }
+  cv_.notify_all();
+  return id;
+}
+
+bool GimbalTimer::cancel(TaskId id) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  bool found = tasks_.erase(id) > 0;
+  if (running_id_ != id)
+    return found;
+
+  // 任务正在执行，等待其返回；任务取消自身时不能等待
+  if (std::this_thread::get_id() != thread_.get_id())
+    idle_cv_.wait(lock, [&] { return running_id_ != id; });
+  return true;
+}
+
+GimbalTimer::Stats GimbalTimer::getStats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void GimbalTimer::loop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_) {
+    if (tasks_.empty()) {
+      cv_.wait(lock);
+      continue;
+    }
+
+    auto next = std::min_element(tasks_.begin(), tasks_.end(),
+                                 [](const auto &a, const auto &b) {
+                                   return a.second.deadline <
+                                          b.second.deadline;
+                                 });
+    Clock::time_point now = Clock::now();
+    if (next->second.deadline > now) {
+      cv_.wait_until(lock, next->second.deadline);
+      continue;
+    }
+
+    TaskId id = next->first;
+    Entry &entry = next->second;
+    Clock::time_point deadline = entry.deadline;
+    std::shared_ptr<Task> task = entry.task;
+
+    double late_us =
+        std::chrono::duration<double, std::micro>(now - deadline).count();
+    stats_.fired++;
+    stats_.late_sum_us += late_us;
+    stats_.late_max_us = std::max(stats_.late_max_us, late_us);
+
+    if (entry.period > Clock::duration::zero()) {
+      entry.deadline += entry.period;
+      if (entry.deadline <= now) {
+        auto skipped = (now - entry.deadline) / entry.period + 1;
+        entry.deadline += skipped * entry.period;
+        stats_.overruns += static_cast<uint64_t>(skipped);
+      }
+    } else {
+      tasks_.erase(next);
+    }
+
+    running_id_ = id;
+    lock.unlock();
+    bool keep = (*task)(deadline);
+    lock.lock();
+    running_id_ = 0;
+    idle_cv_.notify_all();
+    if (!keep)
+      tasks_.erase(id);
+  }
+}
@@ -0,0 +1,76 @@
+#ifndef __GIMBAL_TIMER_H__
+#define __GIMBAL_TIMER_H__
+
+#include "gimbal_export.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+/**
+ * @brief 单线程定时器：按绝对时刻触发一次性或周期任务
+ *
+ * 周期任务的下一时刻由上一计划时刻加周期得到，不随执行耗时漂移；
+ * 落后超过一个周期时跳过错过的时刻并计入 overruns。任务在定时器线程中
+ * 执行，执行期间不持有定时器的锁，可在任务中再次 schedule/cancel。
+ */
+class GIMBAL_EXPORT GimbalTimer {
+public:
+  using Clock = std::chrono::steady_clock;
+  using TaskId = uint32_t;
+  // 参数为本次的计划时刻，返回 false 结束周期任务
+  using Task = std::function<bool(Clock::time_point deadline)>;
+
+  struct Stats {
+    uint64_t fired = 0;
+    uint64_t overruns = 0;   // 跳过的周期数
+    double late_max_us = 0;  // 实际触发晚于计划时刻的最大值
+    double late_sum_us = 0;
+  };
+
+  GimbalTimer();
+  GimbalTimer(const GimbalTimer &) = delete;
+  GimbalTimer &operator=(const GimbalTimer &) = delete;
+  ~GimbalTimer();
+
+  /**
+   * @brief 登记任务
+   *
+   * @param first 首次触发时刻
+   * @param period 周期，为 0 时只触发一次
+   * @param task
+   * @return TaskId 非 0
+   */
+  TaskId schedule(Clock::time_point first, Clock::duration period, Task task);
+
+  // 取消任务；返回时该任务不在执行且不会再执行 (在任务自身中调用时除外)
+  bool cancel(TaskId id);
+
+  Stats getStats();
+
+private:
+  struct Entry {
+    Clock::time_point deadline;
+    Clock::duration period;
+    std::shared_ptr<Task> task;
+  };
+
+  void loop();
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::condition_variable idle_cv_;
+  std::map<TaskId, Entry> tasks_;
+  TaskId next_id_ = 1;
+  TaskId running_id_ = 0; // 正在执行的任务
+  Stats stats_;
+  bool stop_ = false;
+  std::thread thread_;
+};
+
+#endif
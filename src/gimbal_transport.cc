@@ -0,0 +1,47 @@
+#include "gimbal_transport.h"
+
+void GimbalTransport::setTimestamping(bool enable) {
+  if (enable)
+    throw SocketException(std::string("Kernel timestamping not supported by ") +
+                          name() + " transport");
+}
+
+UdpTransport::UdpTransport(unsigned int batch_size) : batch_(batch_size) {}
+
+void UdpTransport::sendTo(std::string_view frame, const std::string &ip,
+                          uint16_t port) {
+  sock_.sendTo(frame.data(), static_cast<int>(frame.size()), ip, port);
+}
+
+bool UdpTransport::poll(int timeout_ms) { return sock_.poll(timeout_ms); }
+
+int UdpTransport::receive() { return sock_.recvBatch(batch_, 0); }
+
+RxDatagram UdpTransport::datagram(int i) const {
+  RxDatagram dgram;
+  dgram.data = std::string_view(batch_.data(i), batch_.length(i));
+  dgram.source = batch_.source(i);
+  dgram.rx_stamp = batch_.rxStamp(i);
+  return dgram;
+}
+
+int UdpTransport::drain(const DrainHandler &handler) {
+  return sock_.drain([&](const char *data, int len, const sockaddr_in &source) {
+    if (handler)
+      handler(std::string_view(data, len), source);
+  });
+}
+
+void UdpTransport::setTimestamping(bool enable) {
+  sock_.setTimestamping(enable);
+}
+
+uint32_t UdpTransport::txCount() const { return sock_.txCount(); }
+
+bool UdpTransport::readTxTimestamp(uint32_t &tx_id, timespec &tx_stamp) {
+  return sock_.readTxTimestamp(tx_id, tx_stamp);
+}
+
+void UdpTransport::setMulticastTTL(unsigned char ttl) {
+  sock_.setMulticastTTL(ttl);
+}
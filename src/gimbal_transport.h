@@ -0,0 +1,92 @@
+#ifndef __GIMBAL_TRANSPORT_H__
+#define __GIMBAL_TRANSPORT_H__
+
+#include "gimbal_export.h"
+#include "practical_socket/PracticalSocket.h"
+
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <netinet/in.h>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief 接收到的一个数据报视图
+ * data 指向传输层内部缓冲，在下一次 receive() 前有效
+ */
+struct RxDatagram {
+  std::string_view data;
+  sockaddr_in source{};
+  timespec rx_stamp{}; // 内核接收时间戳，未开启时为零
+};
+
+/**
+ * @brief 云台链路传输层接口
+ *
+ * 接收分两条路径：接收线程通过 poll/receive/datagram 原地读取，
+ * 发送线程通过 drain 在登记指令前清出已到达的数据报。两者不共用缓冲。
+ * 出错时抛出 SocketException。
+ */
+class GIMBAL_EXPORT GimbalTransport {
+public:
+  using DrainHandler =
+      std::function<void(std::string_view data, const sockaddr_in &source)>;
+
+  virtual ~GimbalTransport() = default;
+
+  // 发送一帧
+  virtual void sendTo(std::string_view frame, const std::string &ip,
+                      uint16_t port) = 0;
+
+  // 等待可读，超时返回 false
+  virtual bool poll(int timeout_ms) = 0;
+
+  // 非阻塞批量接收，返回数据报数，仅接收线程调用
+  virtual int receive() = 0;
+  virtual RxDatagram datagram(int i) const = 0;
+
+  // 非阻塞清出所有已到达的数据报，返回条数
+  virtual int drain(const DrainHandler &handler) = 0;
+
+  // 内核收发时间戳，不支持的后端开启时抛出 SocketException
+  virtual void setTimestamping(bool enable);
+  virtual uint32_t txCount() const { return 0; }
+  virtual bool readTxTimestamp(uint32_t & /*tx_id*/,
+                               timespec & /*tx_stamp*/) {
+    return false;
+  }
+
+  virtual void setMulticastTTL(unsigned char /*ttl*/) {}
+
+  // 后端名称，用于日志
+  virtual const char *name() const = 0;
+};
+
+/**
+ * @brief 经典 socket 后端：sendto + select + recvmmsg
+ */
+class GIMBAL_EXPORT UdpTransport : public GimbalTransport {
+public:
+  explicit UdpTransport(unsigned int batch_size = 32);
+
+  void sendTo(std::string_view frame, const std::string &ip,
+              uint16_t port) override;
+  bool poll(int timeout_ms) override;
+  int receive() override;
+  RxDatagram datagram(int i) const override;
+  int drain(const DrainHandler &handler) override;
+
+  void setTimestamping(bool enable) override;
+  uint32_t txCount() const override;
+  bool readTxTimestamp(uint32_t &tx_id, timespec &tx_stamp) override;
+  void setMulticastTTL(unsigned char ttl) override;
+
+  const char *name() const override { return "udp"; }
+
+private:
+  UDPSocket sock_;
+  UDPRecvBatch batch_;
+};
+
+#endif
@@ -0,0 +1,471 @@
+#include "gimbal_uring_transport.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <linux/io_uring.h>
+#include <netdb.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+// 接收请求的 user_data，发送请求使用槽位下标
+constexpr uint64_t kRecvTag = ~0ull;
+constexpr uint16_t kBufferGroup = 0;
+// 接收缓冲中为地址与控制信息预留的长度
+constexpr unsigned int kNameSize = sizeof(sockaddr_in);
+constexpr unsigned int kControlSize = 64;
+
+int uringSetup(unsigned int entries, io_uring_params *params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int uringEnter(int fd, unsigned int to_submit, unsigned int min_complete,
+               unsigned int flags, const void *arg, size_t arg_size) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit,
+                                  min_complete, flags, arg, arg_size));
+}
+
+int uringRegister(int fd, unsigned int opcode, void *arg, unsigned int nr) {
+  return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nr));
+}
+
+template <typename T> T loadAcquire(const T *p) {
+  return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+template <typename T> void storeRelease(T *p, T v) {
+  __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+unsigned int roundUpPow2(unsigned int v) {
+  unsigned int n = 1;
+  while (n < v)
+    n <<= 1;
+  return n;
+}
+} // namespace
+
+// 映射到用户态的 SQ/CQ 与 provided buffer ring
+struct IoUringTransport::Ring {
+  int fd = -1;
+
+  void *sq_ptr = MAP_FAILED;
+  size_t sq_size = 0;
+  unsigned int *sq_head = nullptr;
+  unsigned int *sq_tail = nullptr;
+  unsigned int *sq_array = nullptr;
+  unsigned int sq_mask = 0;
+  unsigned int sq_entries = 0;
+  unsigned int sq_local_tail = 0;
+  io_uring_sqe *sqes = static_cast<io_uring_sqe *>(MAP_FAILED);
+  size_t sqes_size = 0;
+
+  void *cq_ptr = MAP_FAILED;
+  size_t cq_size = 0;
+  unsigned int *cq_head = nullptr;
+  unsigned int *cq_tail = nullptr;
+  unsigned int cq_mask = 0;
+  io_uring_cqe *cqes = nullptr;
+
+  io_uring_buf_ring *buf_ring = static_cast<io_uring_buf_ring *>(MAP_FAILED);
+  size_t buf_ring_size = 0;
+  char *buffers = static_cast<char *>(MAP_FAILED);
+  size_t buffers_size = 0;
+  unsigned int buf_count = 0;
+  unsigned int buf_size = 0;
+  uint16_t buf_tail = 0;
+
+  io_uring_sqe *nextSqe() {
+    unsigned int head = loadAcquire(sq_head);
+    if (sq_local_tail - head >= sq_entries)
+      return nullptr;
+    unsigned int idx = sq_local_tail & sq_mask;
+    sq_array[idx] = idx;
+    sq_local_tail++;
+    io_uring_sqe *sqe = &sqes[idx];
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+  }
+
+  bool cqReady() const { return loadAcquire(cq_tail) != *cq_head; }
+
+  ~Ring() {
+    if (buffers != MAP_FAILED)
+      munmap(buffers, buffers_size);
+    if (buf_ring != MAP_FAILED)
+      munmap(buf_ring, buf_ring_size);
+    if (sqes != MAP_FAILED)
+      munmap(sqes, sqes_size);
+    if (cq_ptr != MAP_FAILED && cq_ptr != sq_ptr)
+      munmap(cq_ptr, cq_size);
+    if (sq_ptr != MAP_FAILED)
+      munmap(sq_ptr, sq_size);
+    if (fd >= 0)
+      close(fd);
+  }
+};
+
+IoUringTransport::IoUringTransport(unsigned int entries, unsigned int buffers,
+                                   unsigned int buffer_size)
+    : ring_(new Ring) {
+  Ring &r = *ring_;
+  try {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    // 多发接收会连续产生 CQE，CQ 比 SQ 深
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = roundUpPow2(buffers) * 4;
+    r.fd = uringSetup(entries, &params);
+    if (r.fd < 0)
+      throw SocketException("io_uring setup failed (io_uring_setup())", true);
+
+    r.sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    r.cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap)
+      r.sq_size = r.cq_size = std::max(r.sq_size, r.cq_size);
+
+    r.sq_ptr = mmap(nullptr, r.sq_size, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, r.fd, IORING_OFF_SQ_RING);
+    if (r.sq_ptr == MAP_FAILED)
+      throw SocketException("io_uring SQ mmap failed", true);
+    r.cq_ptr = single_mmap ? r.sq_ptr
+                           : mmap(nullptr, r.cq_size, PROT_READ | PROT_WRITE,
+                                  MAP_SHARED | MAP_POPULATE, r.fd,
+                                  IORING_OFF_CQ_RING);
+    if (r.cq_ptr == MAP_FAILED)
+      throw SocketException("io_uring CQ mmap failed", true);
+
+    r.sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    r.sqes = static_cast<io_uring_sqe *>(
+        mmap(nullptr, r.sqes_size, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE, r.fd, IORING_OFF_SQES));
+    if (r.sqes == MAP_FAILED)
+      throw SocketException("io_uring SQE mmap failed", true);
+
+    char *sq = static_cast<char *>(r.sq_ptr);
+    r.sq_head = reinterpret_cast<unsigned int *>(sq + params.sq_off.head);
+    r.sq_tail = reinterpret_cast<unsigned int *>(sq + params.sq_off.tail);
+    r.sq_array = reinterpret_cast<unsigned int *>(sq + params.sq_off.array);
+    r.sq_mask = *reinterpret_cast<unsigned int *>(sq + params.sq_off.ring_mask);
+    r.sq_entries = params.sq_entries;
+    r.sq_local_tail = *r.sq_tail;
+
+    char *cq = static_cast<char *>(r.cq_ptr);
+    r.cq_head = reinterpret_cast<unsigned int *>(cq + params.cq_off.head);
+    r.cq_tail = reinterpret_cast<unsigned int *>(cq + params.cq_off.tail);
+    r.cq_mask = *reinterpret_cast<unsigned int *>(cq + params.cq_off.ring_mask);
+    r.cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+
+    // 注册 provided buffer ring，接收数据直接写入这些缓冲
+    r.buf_count = roundUpPow2(buffers);
+    r.buf_size = buffer_size;
+    r.buf_ring_size = r.buf_count * sizeof(io_uring_buf);
+    r.buf_ring = static_cast<io_uring_buf_ring *>(
+        mmap(nullptr, r.buf_ring_size, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (r.buf_ring == MAP_FAILED)
+      throw SocketException("io_uring buffer ring mmap failed", true);
+    r.buffers_size = static_cast<size_t>(r.buf_count) * r.buf_size;
+    r.buffers = static_cast<char *>(mmap(nullptr, r.buffers_size,
+                                         PROT_READ | PROT_WRITE,
+                                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (r.buffers == MAP_FAILED)
+      throw SocketException("io_uring buffer mmap failed", true);
+
+    io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<uint64_t>(r.buf_ring);
+    reg.ring_entries = r.buf_count;
+    reg.bgid = kBufferGroup;
+    if (uringRegister(r.fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0)
+      throw SocketException("io_uring buffer registration failed", true);
+
+    for (unsigned int i = 0; i < r.buf_count; i++)
+      recycleLocked(static_cast<uint16_t>(i));
+  } catch (...) {
+    delete ring_;
+    throw;
+  }
+
+  recv_msg_.msg_namelen = kNameSize;
+  recv_msg_.msg_controllen = kControlSize;
+
+  ready_.reserve(r.buf_count);
+  current_.reserve(r.buf_count);
+  views_.resize(r.buf_count);
+  max_batch_ = r.buf_count / 2;
+
+  slots_.resize(std::min(entries, 64u));
+  for (unsigned int i = 0; i < slots_.size(); i++)
+    free_slots_.push_back(i);
+
+  std::lock_guard<std::mutex> lock(ring_mutex_);
+  armRecvLocked();
+}
+
+IoUringTransport::~IoUringTransport() { delete ring_; }
+
+void IoUringTransport::recycleLocked(uint16_t bid) {
+  Ring &r = *ring_;
+  // C++ 下 bufs 柔性数组前的空结构体占 1 字节，偏移与内核不一致，
+  // 按 io_uring_buf 数组从 ring 起始地址直接索引
+  io_uring_buf *bufs = reinterpret_cast<io_uring_buf *>(r.buf_ring);
+  io_uring_buf &buf = bufs[r.buf_tail & (r.buf_count - 1)];
+  buf.addr = reinterpret_cast<uint64_t>(r.buffers +
+                                        static_cast<size_t>(bid) * r.buf_size);
+  buf.len = r.buf_size;
+  buf.bid = bid;
+  r.buf_tail++;
+  storeRelease(&r.buf_ring->tail, r.buf_tail);
+}
+
+void IoUringTransport::submitLocked(unsigned int count) {
+  Ring &r = *ring_;
+  storeRelease(r.sq_tail, r.sq_local_tail);
+  while (count > 0) {
+    int ret = uringEnter(r.fd, count, 0, 0, nullptr, 0);
+    if (ret < 0) {
+      if (errno == EINTR)
+        continue;
+      throw SocketException("io_uring submit failed (io_uring_enter())", true);
+    }
+    count -= std::min<unsigned int>(count, ret);
+  }
+}
+
+void IoUringTransport::armRecvLocked() {
+  io_uring_sqe *sqe = ring_->nextSqe();
+  if (sqe == nullptr)
+    return; // SQ 满，下次收割后重试
+
+  sqe->opcode = IORING_OP_RECVMSG;
+  sqe->fd = sock_.getDescriptor();
+  sqe->addr = reinterpret_cast<uint64_t>(&recv_msg_);
+  sqe->len = 1;
+  sqe->ioprio = IORING_RECV_MULTISHOT;
+  sqe->flags = IOSQE_BUFFER_SELECT;
+  sqe->buf_group = kBufferGroup;
+  sqe->user_data = kRecvTag;
+  submitLocked(1);
+  recv_armed_ = true;
+}
+
+void IoUringTransport::reapLocked() {
+  Ring &r = *ring_;
+  unsigned int head = *r.cq_head;
+  unsigned int tail = loadAcquire(r.cq_tail);
+
+  for (; head != tail; head++) {
+    const io_uring_cqe &cqe = r.cqes[head & r.cq_mask];
+    if (cqe.user_data == kRecvTag) {
+      if (!(cqe.flags & IORING_CQE_F_MORE))
+        recv_armed_ = false; // 多发请求结束 (如缓冲耗尽)，需要重新提交
+      if (cqe.res >= 0 && (cqe.flags & IORING_CQE_F_BUFFER))
+        ready_.push_back(
+            static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT));
+    } else if (cqe.user_data < slots_.size()) {
+      if (cqe.res < 0)
+        send_error_ = -cqe.res;
+      free_slots_.push_back(static_cast<unsigned int>(cqe.user_data));
+    }
+  }
+  storeRelease(r.cq_head, head);
+
+  if (!recv_armed_)
+    armRecvLocked();
+}
+
+bool IoUringTransport::parseLocked(uint16_t bid, RxDatagram &dgram) {
+  Ring &r = *ring_;
+  char *buf = r.buffers + static_cast<size_t>(bid) * r.buf_size;
+  const io_uring_recvmsg_out *out =
+      reinterpret_cast<const io_uring_recvmsg_out *>(buf);
+
+  // 缓冲布局：recvmsg 头 | 地址 (kNameSize) | 控制信息 (kControlSize) | 数据
+  char *name = buf + sizeof(io_uring_recvmsg_out);
+  char *control = name + kNameSize;
+  char *payload = control + kControlSize;
+  size_t room = r.buf_size - (payload - buf);
+  if (out->flags & MSG_TRUNC || out->payloadlen > room)
+    return false;
+
+  memcpy(&dgram.source, name, std::min<size_t>(out->namelen, kNameSize));
+  dgram.data = std::string_view(payload, out->payloadlen);
+  dgram.rx_stamp = timespec{};
+
+  msghdr hdr{};
+  hdr.msg_control = control;
+  hdr.msg_controllen = std::min<size_t>(out->controllen, kControlSize);
+  for (cmsghdr *cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr;
+       cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS)
+      memcpy(&dgram.rx_stamp, CMSG_DATA(cmsg), sizeof(timespec));
+  }
+  return true;
+}
+
+void IoUringTransport::resolve(const std::string &ip, uint16_t port,
+                               sockaddr_in &addr) {
+  if (ip == last_ip_ && port == last_port_) {
+    addr = last_addr_;
+    return;
+  }
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  if (inet_pton(AF_INET, ip.c_str(), &addr.sin_addr) != 1) {
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo *res = nullptr;
+    if (getaddrinfo(ip.c_str(), nullptr, &hints, &res) != 0 || res == nullptr)
+      throw SocketException("Failed to resolve name (getaddrinfo())");
+    addr.sin_addr = reinterpret_cast<sockaddr_in *>(res->ai_addr)->sin_addr;
+    freeaddrinfo(res);
+  }
+
+  last_ip_ = ip;
+  last_port_ = port;
+  last_addr_ = addr;
+}
+
+void IoUringTransport::sendTo(std::string_view frame, const std::string &ip,
+                              uint16_t port) {
+  if (frame.size() > sizeof(SendSlot::data))
+    throw SocketException("Send failed: frame too long");
+
+  std::lock_guard<std::mutex> lock(ring_mutex_);
+  if (send_error_ != 0) {
+    errno = send_error_;
+    send_error_ = 0;
+    throw SocketException("Send failed (IORING_OP_SENDMSG)", true);
+  }
+
+  // 槽位耗尽时收割完成事件，必要时等待
+  reapLocked();
+  while (free_slots_.empty()) {
+    if (uringEnter(ring_->fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 &&
+        errno != EINTR)
+      throw SocketException("io_uring wait failed (io_uring_enter())", true);
+    reapLocked();
+  }
+
+  io_uring_sqe *sqe = ring_->nextSqe();
+  if (sqe == nullptr)
+    throw SocketException("Send failed: io_uring SQ full");
+
+  unsigned int index = free_slots_.back();
+  free_slots_.pop_back();
+  SendSlot &slot = slots_[index];
+  memcpy(slot.data, frame.data(), frame.size());
+  resolve(ip, port, slot.addr);
+  slot.iov.iov_base = slot.data;
+  slot.iov.iov_len = frame.size();
+  memset(&slot.msg, 0, sizeof(slot.msg));
+  slot.msg.msg_name = &slot.addr;
+  slot.msg.msg_namelen = sizeof(slot.addr);
+  slot.msg.msg_iov = &slot.iov;
+  slot.msg.msg_iovlen = 1;
+
+  sqe->opcode = IORING_OP_SENDMSG;
+  sqe->fd = sock_.getDescriptor();
+  sqe->addr = reinterpret_cast<uint64_t>(&slot.msg);
+  sqe->len = 1;
+  sqe->user_data = index;
+  submitLocked(1);
+
+  if (timestamping_)
+    tx_count_++;
+}
+
+bool IoUringTransport::poll(int timeout_ms) {
+  {
+    std::lock_guard<std::mutex> lock(ring_mutex_);
+    if (!ready_.empty() || ring_->cqReady())
+      return true;
+  }
+
+  // 等待不持锁，其他线程可以继续提交发送
+  __kernel_timespec ts;
+  ts.tv_sec = timeout_ms / 1000;
+  ts.tv_nsec = static_cast<long long>(timeout_ms % 1000) * 1000000;
+  io_uring_getevents_arg arg;
+  memset(&arg, 0, sizeof(arg));
+  arg.sigmask_sz = _NSIG / 8;
+  arg.ts = reinterpret_cast<uint64_t>(&ts);
+
+  int ret = uringEnter(ring_->fd, 0, 1,
+                       IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg,
+                       sizeof(arg));
+  if (ret < 0 && errno != ETIME && errno != EINTR)
+    throw SocketException("io_uring wait failed (io_uring_enter())", true);
+
+  return ring_->cqReady();
+}
+
+int IoUringTransport::receive() {
+  std::lock_guard<std::mutex> lock(ring_mutex_);
+
+  // 上一批的视图到此失效，归还缓冲
+  for (uint16_t bid : current_)
+    recycleLocked(bid);
+  current_.clear();
+
+  reapLocked();
+
+  unsigned int count = 0;
+  size_t taken = 0;
+  for (; taken < ready_.size() && count < max_batch_; taken++) {
+    uint16_t bid = ready_[taken];
+    current_.push_back(bid);
+    if (parseLocked(bid, views_[count]))
+      count++;
+  }
+  ready_.erase(ready_.begin(), ready_.begin() + taken);
+
+  return static_cast<int>(count);
+}
+
+RxDatagram IoUringTransport::datagram(int i) const { return views_[i]; }
+
+int IoUringTransport::drain(const DrainHandler &handler) {
+  std::lock_guard<std::mutex> lock(ring_mutex_);
+  reapLocked();
+
+  int count = 0;
+  RxDatagram dgram;
+  for (uint16_t bid : ready_) {
+    if (parseLocked(bid, dgram)) {
+      if (handler)
+        handler(dgram.data, dgram.source);
+      count++;
+    }
+    recycleLocked(bid);
+  }
+  ready_.clear();
+  return count;
+}
+
+void IoUringTransport::setTimestamping(bool enable) {
+  std::lock_guard<std::mutex> lock(ring_mutex_);
+  sock_.setTimestamping(enable);
+  // 与内核 OPT_ID 编号一致：仅在由关到开时清零
+  if (enable && !timestamping_)
+    tx_count_ = 0;
+  timestamping_ = enable;
+}
+
+bool IoUringTransport::readTxTimestamp(uint32_t &tx_id, timespec &tx_stamp) {
+  return sock_.readTxTimestamp(tx_id, tx_stamp);
+}
+
+void IoUringTransport::setMulticastTTL(unsigned char ttl) {
+  sock_.setMulticastTTL(ttl);
+}
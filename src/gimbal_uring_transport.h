@@ -0,0 +1,88 @@
+#ifndef __GIMBAL_URING_TRANSPORT_H__
+#define __GIMBAL_URING_TRANSPORT_H__
+
+#include "gimbal_transport.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <vector>
+
+/**
+ * @brief io_uring 后端 (Linux 6.0+，需以 GIMBAL_ENABLE_IO_URING 构建)
+ *
+ * 接收：一次提交多发 (multishot) recvmsg，内核持续把数据报写入注册的
+ * provided buffer ring，接收线程只需收割 CQE，缓冲在下一次 receive() 时归还。
+ * 发送：帧拷入预分配的发送槽位后提交 IORING_OP_SENDMSG，槽位在 CQE 到达后回收。
+ */
+class GIMBAL_EXPORT IoUringTransport : public GimbalTransport {
+public:
+  /**
+   * @param entries SQ 深度
+   * @param buffers 注册接收缓冲数，取整到 2 的幂
+   * @param buffer_size 单个接收缓冲大小，含 recvmsg 头、地址与控制信息
+   */
+  explicit IoUringTransport(unsigned int entries = 256,
+                            unsigned int buffers = 64,
+                            unsigned int buffer_size = 512);
+  ~IoUringTransport() override;
+
+  void sendTo(std::string_view frame, const std::string &ip,
+              uint16_t port) override;
+  bool poll(int timeout_ms) override;
+  int receive() override;
+  RxDatagram datagram(int i) const override;
+  int drain(const DrainHandler &handler) override;
+
+  void setTimestamping(bool enable) override;
+  uint32_t txCount() const override { return tx_count_; }
+  bool readTxTimestamp(uint32_t &tx_id, timespec &tx_stamp) override;
+  void setMulticastTTL(unsigned char ttl) override;
+
+  const char *name() const override { return "io_uring"; }
+
+private:
+  struct Ring;
+
+  // 发送槽位，在 SENDMSG 完成前保持有效
+  struct SendSlot {
+    char data[256];
+    sockaddr_in addr;
+    iovec iov;
+    msghdr msg;
+  };
+
+  void armRecvLocked();
+  void reapLocked();
+  void submitLocked(unsigned int count);
+  void recycleLocked(uint16_t bid);
+  bool parseLocked(uint16_t bid, RxDatagram &dgram);
+  void resolve(const std::string &ip, uint16_t port, sockaddr_in &addr);
+
+  UDPSocket sock_;
+  Ring *ring_;
+  std::mutex ring_mutex_;
+
+  msghdr recv_msg_{}; // 多发 recvmsg 的地址/控制信息长度模板
+  bool recv_armed_ = false;
+  std::vector<uint16_t> ready_;   // 已收到、尚未取走的缓冲
+  std::vector<uint16_t> current_; // 本批交给接收线程的缓冲
+  std::vector<RxDatagram> views_;
+  unsigned int max_batch_;
+
+  std::vector<SendSlot> slots_;
+  std::vector<unsigned int> free_slots_;
+  int send_error_ = 0; // 最近一次异步发送失败的 errno
+
+  std::string last_ip_;
+  uint16_t last_port_ = 0;
+  sockaddr_in last_addr_{};
+
+  bool timestamping_ = false;
+  std::atomic<uint32_t> tx_count_{0};
+};
+
+#endif
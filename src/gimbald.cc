@@ -0,0 +1,684 @@
+#include "gimbal_ctrl.h"
+#include "gimbal_protocol.h"
+#include "gimbal_serial_transport.h"
+#include "gimbald_client.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <poll.h>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * gimbald：独占云台链路，经 Unix 域套接字为多个进程提供服务。
+ *
+ * - 指令按优先级排队，同时在途的指令数受限，避免冲击云台
+ * - 排队中的同类运动/设置写指令只保留最新一条，被覆盖者回复 MERGED
+ * - 相同的读指令在排队或在途期间合并为一次请求，结果分发给所有请求者
+ * - 姿态与链路状态推送给所有订阅者，慢客户端丢弃遥测而不阻塞守护进程
+ * - 按客户端统计排队时延与总时延
+ *
+ * - 可选把状态发布到共享内存 (-m)，帧率读取的进程无需经过守护进程
+ *
+ * 用法：gimbald [-t ip|/dev/ttyX] [-p port] [-s socket] [-a attitude_hz]
+ *               [-m shm_name] [-v]
+ */
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr int kPriorities = 4;
+constexpr size_t kMaxInFlight = 4;  // 同时在途的指令数
+constexpr size_t kMaxOutbox = 256;  // 每个客户端待发消息上限
+constexpr size_t kMaxClients = 64;
+
+// 最新值覆盖旧值的写指令 (速度、角度与伪彩模式) 由协议描述表的 latest_wins 标出
+bool mergeable(const std::string &identifier) {
+  tp::Id id = tp::lookup(identifier);
+  return id != tp::Id::COUNT && tp::describe(id).latest_wins;
+}
+
+std::atomic<bool> g_running{true};
+
+void onSignal(int) { g_running = false; }
+
+double elapsedUs(Clock::time_point from, Clock::time_point to) {
+  return std::chrono::duration<double, std::micro>(to - from).count();
+}
+
+// 客户端指令的结果，仅在格式化 ACK 行时转为文本
+enum class AckState { OK, FAIL, MERGED };
+
+const char *ackStateName(AckState state) {
+  switch (state) {
+  case AckState::OK:
+    return "OK";
+  case AckState::MERGED:
+    return "MERGED";
+  default:
+    return "FAIL";
+  }
+}
+
+const char *linkStateName(GimbalCtrl::LinkState state) {
+  switch (state) {
+  case GimbalCtrl::LinkState::ALIVE:
+    return "ALIVE";
+  case GimbalCtrl::LinkState::DEGRADED:
+    return "DEGRADED";
+  case GimbalCtrl::LinkState::DOWN:
+    return "DOWN";
+  default:
+    return "UNKNOWN";
+  }
+}
+
+class Daemon {
+public:
+  Daemon(GimbalCtrl &gimbal, int listen_fd)
+      : gimbal_(gimbal), listen_fd_(listen_fd) {
+    if (pipe2(wake_pipe_, O_NONBLOCK | O_CLOEXEC) < 0)
+      throw std::runtime_error("pipe2 failed");
+
+    // 回调在接收线程中执行，只登记事件并唤醒主循环
+    gimbal_.setAttitudeCallback([this](const GimbalCtrl::Attitude &att) {
+      {
+        std::lock_guard<std::mutex> lock(event_mutex_);
+        attitude_ = att;
+        attitude_dirty_ = true;
+      }
+      wake();
+    });
+    gimbal_.setLinkStateCallback(
+        [this](GimbalCtrl::LinkState, GimbalCtrl::LinkState to) {
+          {
+            std::lock_guard<std::mutex> lock(event_mutex_);
+            link_events_.push_back(to);
+          }
+          wake();
+        });
+  }
+
+  // 须在 GimbalCtrl 析构之后析构，保证回调不再访问本对象
+  ~Daemon() {
+    for (auto &item : clients_)
+      close(item.second.fd);
+    close(wake_pipe_[0]);
+    close(wake_pipe_[1]);
+  }
+
+  void run() {
+    std::vector<pollfd> fds;
+    std::vector<uint64_t> ids;
+    while (g_running) {
+      fds.clear();
+      ids.clear();
+      fds.push_back({listen_fd_, POLLIN, 0});
+      fds.push_back({wake_pipe_[0], POLLIN, 0});
+      for (auto &item : clients_) {
+        short events = POLLIN;
+        if (!item.second.outbox.empty())
+          events |= POLLOUT;
+        fds.push_back({item.second.fd, events, 0});
+        ids.push_back(item.first);
+      }
+
+      if (::poll(fds.data(), fds.size(), 200) < 0 && errno != EINTR) {
+        LOG_F(ERROR, "gimbald poll failed: %s", strerror(errno));
+        break;
+      }
+
+      if (fds[0].revents & POLLIN)
+        acceptClient();
+      if (fds[1].revents & POLLIN) {
+        char buf[64];
+        while (read(wake_pipe_[0], buf, sizeof(buf)) > 0) {
+        }
+      }
+      for (size_t i = 0; i < ids.size(); i++) {
+        short revents = fds[i + 2].revents;
+        if (revents & POLLOUT)
+          flush(ids[i]);
+        if (revents & (POLLIN | POLLHUP | POLLERR))
+          readClient(ids[i]);
+      }
+
+      processEvents();
+      dispatch();
+    }
+  }
+
+private:
+  // 每个客户端的时延统计
+  struct ClientStats {
+    uint64_t submitted = 0;
+    uint64_t confirmed = 0;
+    uint64_t failed = 0;
+    uint64_t merged = 0;
+    double queue_sum_us = 0;
+    double total_sum_us = 0;
+    double total_max_us = 0;
+    uint64_t telemetry_dropped = 0;
+  };
+
+  struct Client {
+    int fd = -1;
+    std::string name = "anonymous";
+    bool subscribed = false;
+    std::deque<std::string> outbox; // 套接字缓冲满时暂存的消息
+    ClientStats stats;
+  };
+
+  // 等待同一请求结果的客户端指令
+  struct Waiter {
+    uint64_t client = 0;
+    std::string tag;
+    Clock::time_point enqueued{};
+  };
+
+  struct Request {
+    std::string frame;
+    std::string merge_key; // 可合并写指令的键，为空表示不合并
+    int priority = 0;
+    bool in_flight = false;
+    Clock::time_point enqueued{}; // 客户端指令到达时刻，运动指令的期限由此起算
+    Clock::time_point submitted{};
+    std::vector<Waiter> waiters;
+  };
+
+  struct Completion {
+    uint64_t request = 0;
+    bool ok = false;
+    RxBufferRef response; // 引用 GimbalCtrl 接收缓冲池，不复制
+    Clock::time_point at{};
+  };
+
+  void wake() {
+    char c = 1;
+    (void)!write(wake_pipe_[1], &c, 1);
+  }
+
+  void acceptClient() {
+    int fd = accept4(listen_fd_, nullptr, nullptr,
+                     SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0)
+      return;
+    if (clients_.size() >= kMaxClients) {
+      LOG_F(WARNING, "gimbald: too many clients, rejecting");
+      close(fd);
+      return;
+    }
+    uint64_t id = next_client_++;
+    clients_[id].fd = fd;
+  }
+
+  void readClient(uint64_t id) {
+    auto it = clients_.find(id);
+    if (it == clients_.end())
+      return;
+
+    char buf[GimbaldClient::kMaxMessage + 1];
+    while (true) {
+      ssize_t n = recv(it->second.fd, buf, GimbaldClient::kMaxMessage,
+                       MSG_DONTWAIT);
+      if (n > 0) {
+        buf[n] = '\0';
+        handleMessage(id, it->second, buf);
+        continue;
+      }
+      if (n < 0 && (errno == EAGAIN || errno == EINTR))
+        return;
+      dropClient(id);
+      return;
+    }
+  }
+
+  void handleMessage(uint64_t id, Client &client, const char *msg) {
+    if (strncmp(msg, "HELLO ", 6) == 0) {
+      client.name = msg + 6;
+      LOG_F(INFO, "gimbald: client %s connected", client.name.c_str());
+    } else if (strcmp(msg, "SUB") == 0) {
+      client.subscribed = true;
+      post(client, std::string("LNK ") + linkStateName(gimbal_.getLinkState()),
+           false);
+    } else if (strcmp(msg, "STATS") == 0) {
+      post(client, formatStats(client), true);
+    } else if (strncmp(msg, "CMD ", 4) == 0) {
+      char tag[32] = {0};
+      char frame[GimbaldClient::kMaxMessage] = {0};
+      int priority = 0;
+      if (sscanf(msg + 4, "%31s %d %511s", tag, &priority, frame) != 3) {
+        LOG_F(WARNING, "gimbald: malformed command from %s",
+              client.name.c_str());
+        return;
+      }
+      if (priority < 0)
+        priority = 0;
+      if (priority >= kPriorities)
+        priority = kPriorities - 1;
+      enqueue(id, client, tag, priority, frame);
+    }
+  }
+
+  void enqueue(uint64_t id, Client &client, const std::string &tag,
+               int priority, const std::string &frame) {
+    Clock::time_point now = Clock::now();
+    client.stats.submitted++;
+    Waiter waiter{id, tag, now};
+
+    if (frame.size() < 12) {
+      finish(waiter, AckState::FAIL, now, now, "");
+      return;
+    }
+    char control = frame[6];
+    std::string identifier = frame.substr(7, 3);
+
+    // 相同的读指令合并为一次请求
+    if (control == 'r') {
+      auto it = reads_.find(frame);
+      if (it != reads_.end()) {
+        Request &request = requests_[it->second];
+        request.waiters.push_back(waiter);
+        if (priority > request.priority && !request.in_flight)
+          requeue(it->second, priority);
+        return;
+      }
+    }
+
+    // 排队中的同类写指令被新指令覆盖
+    std::string merge_key;
+    if (control == 'w' && mergeable(identifier))
+      merge_key = frame.substr(3, 2) + identifier;
+    if (!merge_key.empty()) {
+      auto it = merges_.find(merge_key);
+      if (it != merges_.end()) {
+        Request &old = requests_[it->second];
+        for (const auto &w : old.waiters)
+          finish(w, AckState::MERGED, now, now, "");
+        priority = std::max(priority, old.priority);
+        requests_.erase(it->second);
+        merges_.erase(it);
+      }
+    }
+
+    uint64_t request_id = next_request_++;
+    Request &request = requests_[request_id];
+    request.frame = frame;
+    request.merge_key = merge_key;
+    request.priority = priority;
+    request.enqueued = now;
+    request.waiters.push_back(waiter);
+    queues_[priority].push_back(request_id);
+    if (control == 'r')
+      reads_[frame] = request_id;
+    if (!merge_key.empty())
+      merges_[merge_key] = request_id;
+  }
+
+  // 提高排队中请求的优先级，旧队列中的条目在出队时跳过
+  void requeue(uint64_t request_id, int priority) {
+    requests_[request_id].priority = priority;
+    queues_[priority].push_back(request_id);
+  }
+
+  // 回包匹配键：地址位 + 控制位 + 标识位，与 GimbalCtrl 的关联方式一致
+  static std::string replyKey(const std::string &frame) {
+    return frame.substr(3, 2) + frame.substr(6, 4);
+  }
+
+  // 按优先级出队，直到在途指令数达到上限
+  // 回包无法区分的指令 (匹配键相同) 不同时在途，避免应答错配与重发
+  void dispatch() {
+    while (in_flight_ < kMaxInFlight) {
+      uint64_t request_id = 0;
+      for (int p = kPriorities - 1; p >= 0 && request_id == 0; p--) {
+        auto &queue = queues_[p];
+        for (auto it = queue.begin(); it != queue.end();) {
+          auto req = requests_.find(*it);
+          // 已被合并、已发送或已移入更高优先级队列
+          if (req == requests_.end() || req->second.in_flight ||
+              req->second.priority != p) {
+            it = queue.erase(it);
+            continue;
+          }
+          if (busy_keys_.count(replyKey(req->second.frame))) {
+            ++it;
+            continue;
+          }
+          request_id = *it;
+          queue.erase(it);
+          break;
+        }
+      }
+      if (request_id == 0)
+        return;
+
+      Request &request = requests_[request_id];
+      if (!request.merge_key.empty())
+        merges_.erase(request.merge_key);
+      request.in_flight = true;
+      request.submitted = Clock::now();
+      busy_keys_.insert(replyKey(request.frame));
+      in_flight_++;
+
+      auto on_done = [this, request_id](const GimbalCtrl::CommandRecord &r) {
+        Completion done;
+        done.request = request_id;
+        done.ok = r.state == GimbalCtrl::CommandState::CONFIRMED;
+        done.response = r.response;
+        done.at = Clock::now();
+        {
+          std::lock_guard<std::mutex> lock(event_mutex_);
+          completions_.push_back(std::move(done));
+        }
+        wake();
+      };
+      // 期限从客户端指令到达算起，在队列中等待的时间同样计入
+      auto handle =
+          gimbal_.sendFrameAsync(request.frame, on_done, request.enqueued);
+      if (handle == 0) {
+        // 帧无效、指令过期、链路断开或发送失败，回调不会被调用
+        Completion done;
+        done.request = request_id;
+        done.at = Clock::now();
+        complete(done);
+      }
+    }
+  }
+
+  void processEvents() {
+    std::vector<Completion> completions;
+    std::vector<GimbalCtrl::LinkState> links;
+    GimbalCtrl::Attitude attitude;
+    bool attitude_dirty;
+    {
+      std::lock_guard<std::mutex> lock(event_mutex_);
+      completions.swap(completions_);
+      links.swap(link_events_);
+      attitude = attitude_;
+      attitude_dirty = attitude_dirty_;
+      attitude_dirty_ = false;
+    }
+
+    for (const auto &done : completions)
+      complete(done);
+
+    for (auto state : links)
+      broadcast(std::string("LNK ") + linkStateName(state), false);
+
+    // 只推送最新姿态，主循环落后时旧姿态直接丢弃
+    if (attitude_dirty) {
+      char msg[96];
+      snprintf(msg, sizeof(msg), "ATT %.2f %.2f %.2f", attitude.yaw,
+               attitude.pitch, attitude.roll);
+      broadcast(msg, false);
+    }
+  }
+
+  void complete(const Completion &done) {
+    auto it = requests_.find(done.request);
+    if (it == requests_.end())
+      return;
+    Request &request = it->second;
+    if (request.in_flight) {
+      in_flight_--;
+      busy_keys_.erase(replyKey(request.frame));
+    }
+    if (request.frame.size() > 6 && request.frame[6] == 'r') {
+      auto read = reads_.find(request.frame);
+      if (read != reads_.end() && read->second == done.request)
+        reads_.erase(read);
+    }
+    for (const auto &waiter : request.waiters)
+      finish(waiter, done.ok ? AckState::OK : AckState::FAIL,
+             request.submitted, done.at, done.response);
+    requests_.erase(it);
+  }
+
+  // 回复一条客户端指令并记入该客户端的统计
+  void finish(const Waiter &waiter, AckState state,
+              Clock::time_point submitted, Clock::time_point completed,
+              std::string_view response) {
+    auto it = clients_.find(waiter.client);
+    if (it == clients_.end())
+      return;
+    Client &client = it->second;
+
+    // 合并进已在途读请求的指令，排队时间计为 0
+    Clock::time_point dequeued = std::max(submitted, waiter.enqueued);
+    double queue_us = elapsedUs(waiter.enqueued, dequeued);
+    double total_us = elapsedUs(waiter.enqueued, completed);
+
+    ClientStats &stats = client.stats;
+    if (state == AckState::OK)
+      stats.confirmed++;
+    else if (state == AckState::MERGED)
+      stats.merged++;
+    else
+      stats.failed++;
+    if (state != AckState::MERGED) {
+      stats.queue_sum_us += queue_us;
+      stats.total_sum_us += total_us;
+      stats.total_max_us = std::max(stats.total_max_us, total_us);
+    }
+
+    char msg[GimbaldClient::kMaxMessage];
+    snprintf(msg, sizeof(msg), "ACK %s %s %.1f %.1f %.*s", waiter.tag.c_str(),
+             ackStateName(state), queue_us, total_us,
+             static_cast<int>(response.size()), response.data());
+    post(client, msg, true);
+  }
+
+  std::string formatStats(const Client &client) const {
+    const ClientStats &s = client.stats;
+    uint64_t done = s.confirmed + s.failed;
+    char msg[GimbaldClient::kMaxMessage];
+    snprintf(msg, sizeof(msg),
+             "STATS name=%s submitted=%lu confirmed=%lu failed=%lu merged=%lu "
+             "queue_mean_us=%.1f total_mean_us=%.1f total_max_us=%.1f "
+             "telemetry_dropped=%lu",
+             client.name.c_str(), static_cast<unsigned long>(s.submitted),
+             static_cast<unsigned long>(s.confirmed),
+             static_cast<unsigned long>(s.failed),
+             static_cast<unsigned long>(s.merged),
+             done ? s.queue_sum_us / done : 0.0,
+             done ? s.total_sum_us / done : 0.0, s.total_max_us,
+             static_cast<unsigned long>(s.telemetry_dropped));
+    return msg;
+  }
+
+  void broadcast(const std::string &msg, bool reliable) {
+    for (auto &item : clients_) {
+      if (item.second.subscribed)
+        post(item.second, msg, reliable);
+    }
+  }
+
+  /**
+   * @brief 向客户端发送一条消息
+   *
+   * @param client
+   * @param msg
+   * @param reliable 应答类消息在套接字缓冲满时排入 outbox；遥测直接丢弃
+   */
+  void post(Client &client, const std::string &msg, bool reliable) {
+    if (client.outbox.empty()) {
+      ssize_t n = send(client.fd, msg.data(), msg.size(),
+                       MSG_DONTWAIT | MSG_NOSIGNAL);
+      if (n >= 0)
+        return;
+      if (errno != EAGAIN && errno != EWOULDBLOCK)
+        return; // 连接已断开，由读路径清理
+    }
+    if (!reliable || client.outbox.size() >= kMaxOutbox) {
+      client.stats.telemetry_dropped++;
+      return;
+    }
+    client.outbox.push_back(msg);
+  }
+
+  void flush(uint64_t id) {
+    auto it = clients_.find(id);
+    if (it == clients_.end())
+      return;
+    Client &client = it->second;
+    while (!client.outbox.empty()) {
+      const std::string &msg = client.outbox.front();
+      ssize_t n = send(client.fd, msg.data(), msg.size(),
+                       MSG_DONTWAIT | MSG_NOSIGNAL);
+      if (n < 0)
+        return;
+      client.outbox.pop_front();
+    }
+  }
+
+  void dropClient(uint64_t id) {
+    auto it = clients_.find(id);
+    if (it == clients_.end())
+      return;
+    LOG_F(INFO, "gimbald: client disconnected, %s",
+          formatStats(it->second).c_str());
+    close(it->second.fd);
+    clients_.erase(it);
+    // 其排队中的指令照常发送，结果无人接收时丢弃
+  }
+
+  GimbalCtrl &gimbal_;
+  int listen_fd_;
+  int wake_pipe_[2] = {-1, -1};
+
+  std::map<uint64_t, Client> clients_;
+  uint64_t next_client_ = 1;
+
+  std::map<uint64_t, Request> requests_;
+  std::array<std::deque<uint64_t>, kPriorities> queues_;
+  std::map<std::string, uint64_t> reads_;  // 帧 -> 排队或在途的读请求
+  std::map<std::string, uint64_t> merges_; // 合并键 -> 排队中的写请求
+  uint64_t next_request_ = 1;
+  size_t in_flight_ = 0;
+  std::set<std::string> busy_keys_; // 在途指令的回包匹配键
+
+  // 接收线程登记、主循环处理的事件
+  std::mutex event_mutex_;
+  std::vector<Completion> completions_;
+  std::vector<GimbalCtrl::LinkState> link_events_;
+  GimbalCtrl::Attitude attitude_;
+  bool attitude_dirty_ = false;
+};
+
+int listenUnix(const std::string &path) {
+  int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0)
+    return -1;
+
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+  unlink(path.c_str());
+  if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0 ||
+      listen(fd, 16) < 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  std::string target = "192.168.144.108";
+  uint16_t port = 5000;
+  std::string socket_path = GimbaldClient::kDefaultSocketPath;
+  int attitude_hz = 50;
+  std::string shm_name;
+  bool verbose = false;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "t:p:s:a:m:v")) != -1) {
+    switch (opt) {
+    case 't':
+      target = optarg;
+      break;
+    case 'p':
+      port = static_cast<uint16_t>(atoi(optarg));
+      break;
+    case 's':
+      socket_path = optarg;
+      break;
+    case 'a':
+      attitude_hz = atoi(optarg);
+      break;
+    case 'm':
+      shm_name = optarg;
+      break;
+    case 'v':
+      verbose = true;
+      break;
+    default:
+      fprintf(stderr,
+              "usage: %s [-t ip|/dev/ttyX] [-p port] [-s socket] "
+              "[-a attitude_hz] [-m shm_name] [-v]\n",
+              argv[0]);
+      return 1;
+    }
+  }
+
+  // 每条指令都会记 INFO 日志，默认只输出告警
+  if (!verbose)
+    loguru::g_stderr_verbosity = loguru::Verbosity_WARNING;
+
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+  signal(SIGPIPE, SIG_IGN);
+
+  std::unique_ptr<GimbalCtrl> gimbal;
+  try {
+    if (target.rfind("/dev/", 0) == 0)
+      gimbal = std::make_unique<GimbalCtrl>(
+          std::make_unique<SerialTransport>(target), "0.0.0.0", port);
+    else
+      gimbal = std::make_unique<GimbalCtrl>(target, port);
+  } catch (SocketException &e) {
+    LOG_F(ERROR, "gimbald: open %s failed: %s", target.c_str(), e.what());
+    return 1;
+  }
+
+  gimbal->enableHeartbeat(1000);
+  if (!shm_name.empty() && !gimbal->enableSharedState(shm_name))
+    return 1;
+  if (attitude_hz > 0 && !gimbal->enableAttitudeOutput(attitude_hz))
+    LOG_F(WARNING, "gimbald: enable attitude output failed");
+
+  int listen_fd = listenUnix(socket_path);
+  if (listen_fd < 0) {
+    LOG_F(ERROR, "gimbald: listen on %s failed: %s", socket_path.c_str(),
+          strerror(errno));
+    return 1;
+  }
+  LOG_F(WARNING, "gimbald: serving %s on %s", target.c_str(),
+        socket_path.c_str());
+
+  {
+    Daemon daemon(*gimbal, listen_fd);
+    daemon.run();
+    gimbal.reset(); // 先停止接收线程
+  }
+
+  close(listen_fd);
+  unlink(socket_path.c_str());
+  return 0;
+}
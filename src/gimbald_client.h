@@ -0,0 +1,164 @@
+#ifndef __GIMBALD_CLIENT_H__
+#define __GIMBALD_CLIENT_H__
+
+/**
+ * @brief gimbald 客户端 (仅头文件，不依赖 gimbal_control 库)
+ *
+ * 经 Unix 域 SOCK_SEQPACKET 连接 gimbald，一条消息一行文本：
+ *   客户端 -> 守护进程
+ *     HELLO <name>                   客户端名，用于统计与日志
+ *     CMD <tag> <priority> <frame>   提交一帧完整指令，priority 0-3，3 最高
+ *     SUB                            订阅姿态与链路状态
+ *     STATS                          查询本客户端的时延统计
+ *   守护进程 -> 客户端
+ *     ACK <tag> <OK|FAIL|MERGED> <queue_us> <total_us> [response]
+ *     ATT <yaw> <pitch> <roll>
+ *     LNK <UNKNOWN|ALIVE|DEGRADED|DOWN>
+ *     STATS key=value ...
+ *
+ * 组帧可使用 gimbal_protocol.h 中的 tp::encodeRead / tp::encodeWrite，
+ * 或 GimbalCtrl::buildStaticCommand 等静态接口。
+ */
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <poll.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+class GimbaldClient {
+public:
+  static constexpr const char *kDefaultSocketPath = "/tmp/gimbald.sock";
+  static constexpr size_t kMaxMessage = 512;
+
+  // 指令优先级，队列中高优先级先发
+  enum Priority : int { LOW = 0, NORMAL = 1, HIGH = 2, URGENT = 3 };
+
+  enum class EventType : uint8_t { ACK, ATTITUDE, LINK, STATS, UNKNOWN };
+
+  // 守护进程发来的一条消息
+  struct Event {
+    EventType type = EventType::UNKNOWN;
+    uint32_t tag = 0;
+    bool ok = false;     // ACK：云台已确认
+    bool merged = false; // ACK：被同类的更新指令合并，未单独发送
+    double queue_us = 0; // ACK：在守护进程队列中的等待时间
+    double total_us = 0; // ACK：提交到完成的总时延
+    std::string response; // ACK：确认帧
+    float yaw = 0, pitch = 0, roll = 0; // ATT
+    std::string text; // LNK 状态名或 STATS 原文
+  };
+
+  GimbaldClient() = default;
+  GimbaldClient(const GimbaldClient &) = delete;
+  GimbaldClient &operator=(const GimbaldClient &) = delete;
+  ~GimbaldClient() { close(); }
+
+  bool connect(const std::string &name,
+               const std::string &path = kDefaultSocketPath) {
+    close();
+    fd_ = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd_ < 0)
+      return false;
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    if (::connect(fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) <
+        0) {
+      close();
+      return false;
+    }
+    return sendMessage("HELLO " + name);
+  }
+
+  void close() {
+    if (fd_ >= 0)
+      ::close(fd_);
+    fd_ = -1;
+  }
+
+  int fd() const { return fd_; }
+
+  /**
+   * @brief 提交一帧指令
+   *
+   * @param frame 含校验位的完整帧
+   * @param priority
+   * @return uint32_t 指令标签，对应 ACK 中的 tag；发送失败返回 0
+   */
+  uint32_t sendCommand(const std::string &frame, int priority = NORMAL) {
+    uint32_t tag = next_tag_++;
+    if (next_tag_ == 0)
+      next_tag_ = 1;
+    if (!sendMessage("CMD " + std::to_string(tag) + " " +
+                     std::to_string(priority) + " " + frame))
+      return 0;
+    return tag;
+  }
+
+  bool subscribe() { return sendMessage("SUB"); }
+  bool requestStats() { return sendMessage("STATS"); }
+
+  // 等待消息到达，超时返回 false
+  bool poll(int timeout_ms) {
+    pollfd pfd{fd_, POLLIN, 0};
+    return ::poll(&pfd, 1, timeout_ms) > 0;
+  }
+
+  // 非阻塞读取一条消息，无消息或连接断开返回 false
+  bool receive(Event &event) {
+    char buf[kMaxMessage + 1];
+    ssize_t n = ::recv(fd_, buf, kMaxMessage, MSG_DONTWAIT);
+    if (n <= 0)
+      return false;
+    buf[n] = '\0';
+    parse(buf, event);
+    return true;
+  }
+
+private:
+  bool sendMessage(const std::string &message) {
+    if (fd_ < 0 || message.size() > kMaxMessage)
+      return false;
+    return ::send(fd_, message.data(), message.size(), MSG_NOSIGNAL) ==
+           static_cast<ssize_t>(message.size());
+  }
+
+  static void parse(const char *msg, Event &event) {
+    event = Event{};
+    if (strncmp(msg, "ACK ", 4) == 0) {
+      char state[8] = {0};
+      char response[kMaxMessage] = {0};
+      unsigned long tag = 0;
+      if (sscanf(msg + 4, "%lu %7s %lf %lf %511s", &tag, state,
+                 &event.queue_us, &event.total_us, response) >= 4) {
+        event.type = EventType::ACK;
+        event.tag = static_cast<uint32_t>(tag);
+        event.ok = strcmp(state, "OK") == 0;
+        event.merged = strcmp(state, "MERGED") == 0;
+        event.response = response;
+      }
+    } else if (strncmp(msg, "ATT ", 4) == 0) {
+      if (sscanf(msg + 4, "%f %f %f", &event.yaw, &event.pitch,
+                 &event.roll) == 3)
+        event.type = EventType::ATTITUDE;
+    } else if (strncmp(msg, "LNK ", 4) == 0) {
+      event.type = EventType::LINK;
+      event.text = msg + 4;
+    } else if (strncmp(msg, "STATS", 5) == 0) {
+      event.type = EventType::STATS;
+      event.text = msg;
+    }
+  }
+
+  int fd_ = -1;
+  uint32_t next_tag_ = 1;
+};
+
+#endif
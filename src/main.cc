@@ -1,10 +1,32 @@
 #include "gimbal_ctrl.h"
+#include "gimbal_serial_transport.h"
+#include <memory>
 #include <thread>
 
+// 用法：GimbalCtrl_test [ip | 网段，如 192.168.144.0/24 | 串口，如 /dev/ttyS1]
 int main(int argc, char *argv[]) {
-  std::string target_ip = "192.168.144.108";
+  std::string target = argc > 1 ? argv[1] : "192.168.144.0/24";
   uint16_t port = 5000;
 
+  // 串口直连
+  if (target.rfind("/dev/", 0) == 0) {
+    GimbalCtrl serial_ctrl(std::make_unique<SerialTransport>(target, 115200),
+                           "0.0.0.0", port);
+    LOG_F(INFO, "Firmware: %s", serial_ctrl.getFirmwareVersion().c_str());
+    return 0;
+  }
+
+  // 给出网段时先发现云台，取第一台
+  std::string target_ip = target;
+  if (target.find('/') != std::string::npos) {
+    auto units = GimbalCtrl::discover(target, port);
+    if (units.empty()) {
+      LOG_F(ERROR, "No gimbal found in %s", target.c_str());
+      return 1;
+    }
+    target_ip = units.front().ip;
+  }
+
   GimbalCtrl gimbal_ctrl(target_ip, port);
 
   // gimbal_ctrl.setGimbalAngle(90, 90, 90, 90);
@@ -33,9 +33,16 @@ typedef char raw_type; // Type used for raw data on this platform
 typedef void raw_type; // Type used for raw data on this platform
 #endif
 
+#ifdef __linux__
+#include <linux/errqueue.h>   // For sock_extended_err, scm_timestamping
+#include <linux/net_tstamp.h> // For SOF_TIMESTAMPING_*
+#endif
+
 #include <errno.h>  // For errno
 #include <string.h> // For memset
 
+#include <vector> // For vector
+
 using namespace std;
 
 #ifdef WIN32
@@ -329,6 +336,8 @@ void UDPSocket::sendTo(const void *buffer, int bufferLen,
              sizeof(destAddr)) != bufferLen) {
     throw SocketException("Send failed (sendto())", true);
   }
+  if (timestamping)
+    txCounter++;
 }
 
 int UDPSocket::recvFrom(void *buffer, int bufferLen, string &sourceAddress,
@@ -416,3 +425,241 @@ int UDPSocket::recvFromWithTimeout(void *buffer, int bufferLen,
     return -1; // 接收错误
   }
 }
+
+int UDPSocket::drain(
+    const std::function<void(const char *, int, const sockaddr_in &)> &handler)
+    noexcept(false) {
+  const int BATCH = 32;
+  const int BUFFER_SIZE = 256;
+  char buffers[BATCH][BUFFER_SIZE];
+  sockaddr_in addrs[BATCH];
+  int total = 0;
+
+#ifdef __linux__
+  iovec iovs[BATCH];
+  mmsghdr msgs[BATCH];
+
+  for (;;) {
+    memset(msgs, 0, sizeof(msgs));
+    for (int i = 0; i < BATCH; i++) {
+      iovs[i].iov_base = buffers[i];
+      iovs[i].iov_len = BUFFER_SIZE;
+      msgs[i].msg_hdr.msg_iov = &iovs[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+      msgs[i].msg_hdr.msg_name = &addrs[i];
+      msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+    }
+
+    int n = recvmmsg(sockDesc, msgs, BATCH, MSG_DONTWAIT, nullptr);
+    if (n < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+        break;
+      throw SocketException("Drain failed (recvmmsg())", true);
+    }
+
+    if (handler) {
+      for (int i = 0; i < n; i++) {
+        handler(buffers[i], static_cast<int>(msgs[i].msg_len), addrs[i]);
+      }
+    }
+    total += n;
+    if (n < BATCH)
+      break;
+  }
+#else
+  while (poll(0)) {
+    socklen_t addrLen = sizeof(addrs[0]);
+    int n = recvfrom(sockDesc, (raw_type *)buffers[0], BUFFER_SIZE, 0,
+                     (sockaddr *)&addrs[0], &addrLen);
+    if (n < 0)
+      throw SocketException("Drain failed (recvfrom())", true);
+    if (handler)
+      handler(buffers[0], n, addrs[0]);
+    total++;
+  }
+#endif
+
+  return total;
+}
+
+// UDPRecvBatch Code
+
+struct UDPRecvBatch::Storage {
+  unsigned int bufferSize;
+  std::vector<char> buffers;
+  std::vector<sockaddr_in> addrs;
+  std::vector<timespec> stamps;
+  std::vector<int> lengths;
+#ifdef __linux__
+  static const size_t CONTROL_SIZE = 64;
+  std::vector<char> controls;
+  std::vector<iovec> iovs;
+  std::vector<mmsghdr> msgs;
+#endif
+};
+
+UDPRecvBatch::UDPRecvBatch(unsigned int capacity, unsigned int bufferSize)
+    : storage(new Storage) {
+  if (capacity == 0)
+    capacity = 1;
+  storage->bufferSize = bufferSize;
+  storage->buffers.resize(static_cast<size_t>(capacity) * bufferSize);
+  storage->addrs.resize(capacity);
+  storage->stamps.resize(capacity);
+  storage->lengths.resize(capacity);
+#ifdef __linux__
+  storage->controls.resize(capacity * Storage::CONTROL_SIZE);
+  storage->iovs.resize(capacity);
+  storage->msgs.resize(capacity);
+#endif
+}
+
+UDPRecvBatch::~UDPRecvBatch() { delete storage; }
+
+unsigned int UDPRecvBatch::capacity() const {
+  return static_cast<unsigned int>(storage->addrs.size());
+}
+
+const char *UDPRecvBatch::data(unsigned int i) const {
+  return &storage->buffers[static_cast<size_t>(i) * storage->bufferSize];
+}
+
+int UDPRecvBatch::length(unsigned int i) const { return storage->lengths[i]; }
+
+const sockaddr_in &UDPRecvBatch::source(unsigned int i) const {
+  return storage->addrs[i];
+}
+
+const timespec &UDPRecvBatch::rxStamp(unsigned int i) const {
+  return storage->stamps[i];
+}
+
+int UDPSocket::recvBatch(UDPRecvBatch &batch, int timeout_ms) noexcept(false) {
+  UDPRecvBatch::Storage &st = *batch.storage;
+  batch.count = 0;
+
+  if (timeout_ms > 0 && !poll(timeout_ms))
+    return 0; // 超时
+
+#ifdef __linux__
+  unsigned int capacity = batch.capacity();
+  for (unsigned int i = 0; i < capacity; i++) {
+    st.iovs[i].iov_base = &st.buffers[static_cast<size_t>(i) * st.bufferSize];
+    st.iovs[i].iov_len = st.bufferSize;
+    msghdr &hdr = st.msgs[i].msg_hdr;
+    hdr.msg_name = &st.addrs[i];
+    hdr.msg_namelen = sizeof(sockaddr_in);
+    hdr.msg_iov = &st.iovs[i];
+    hdr.msg_iovlen = 1;
+    hdr.msg_control = &st.controls[i * UDPRecvBatch::Storage::CONTROL_SIZE];
+    hdr.msg_controllen = UDPRecvBatch::Storage::CONTROL_SIZE;
+    hdr.msg_flags = 0;
+  }
+
+  int n = recvmmsg(sockDesc, st.msgs.data(), capacity, MSG_DONTWAIT, nullptr);
+  if (n < 0) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK)
+      return 0;
+    throw SocketException("Receive failed (recvmmsg())", true);
+  }
+
+  for (int i = 0; i < n; i++) {
+    st.lengths[i] = static_cast<int>(st.msgs[i].msg_len);
+    st.stamps[i] = timespec{};
+    msghdr &hdr = st.msgs[i].msg_hdr;
+    for (cmsghdr *cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+      if (cmsg->cmsg_level == SOL_SOCKET &&
+          cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+        memcpy(&st.stamps[i], CMSG_DATA(cmsg), sizeof(timespec));
+      }
+    }
+  }
+#else
+  int n = 0;
+  while (n < static_cast<int>(batch.capacity()) && poll(0)) {
+    socklen_t addrLen = sizeof(sockaddr_in);
+    int rtn = recvfrom(sockDesc,
+                       (raw_type *)&st.buffers[static_cast<size_t>(n) *
+                                               st.bufferSize],
+                       st.bufferSize, 0, (sockaddr *)&st.addrs[n], &addrLen);
+    if (rtn < 0)
+      throw SocketException("Receive failed (recvfrom())", true);
+    st.lengths[n] = rtn;
+    st.stamps[n] = timespec{};
+    n++;
+  }
+#endif
+
+  batch.count = static_cast<unsigned int>(n);
+  return n;
+}
+
+void UDPSocket::setTimestamping(bool enable) noexcept(false) {
+#ifdef __linux__
+  int rx = enable ? 1 : 0;
+  if (setsockopt(sockDesc, SOL_SOCKET, SO_TIMESTAMPNS, &rx, sizeof(rx)) < 0) {
+    throw SocketException("Set SO_TIMESTAMPNS failed (setsockopt())", true);
+  }
+
+  // OPT_ID 为每个发送的数据报编号，从 0 开始计数
+  unsigned int flags = enable ? (SOF_TIMESTAMPING_TX_SOFTWARE |
+                                 SOF_TIMESTAMPING_SOFTWARE |
+                                 SOF_TIMESTAMPING_OPT_ID |
+                                 SOF_TIMESTAMPING_OPT_TSONLY)
+                              : 0;
+  if (setsockopt(sockDesc, SOL_SOCKET, SO_TIMESTAMPING, &flags,
+                 sizeof(flags)) < 0) {
+    throw SocketException("Set SO_TIMESTAMPING failed (setsockopt())", true);
+  }
+
+  // 内核只在 OPT_ID 由关到开时把编号清零，重复开启不清零
+  if (enable && !timestamping)
+    txCounter = 0;
+  timestamping = enable;
+#else
+  if (enable)
+    throw SocketException("Kernel timestamping not supported");
+#endif
+}
+
+bool UDPSocket::readTxTimestamp(uint32_t &txId,
+                                timespec &txStamp) noexcept(false) {
+#ifdef __linux__
+  if (!timestamping)
+    return false;
+
+  char control[256];
+  msghdr msg{};
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  if (recvmsg(sockDesc, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK)
+      return false;
+    throw SocketException("Read error queue failed (recvmsg())", true);
+  }
+
+  bool hasStamp = false, hasId = false;
+  for (cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr;
+       cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+    if (cmsg->cmsg_level == SOL_SOCKET &&
+        cmsg->cmsg_type == SCM_TIMESTAMPING) {
+      scm_timestamping stamps;
+      memcpy(&stamps, CMSG_DATA(cmsg), sizeof(stamps));
+      txStamp = stamps.ts[0]; // 软件时间戳
+      hasStamp = true;
+    } else if (cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) {
+      sock_extended_err err;
+      memcpy(&err, CMSG_DATA(cmsg), sizeof(err));
+      if (err.ee_origin == SO_EE_ORIGIN_TIMESTAMPING) {
+        txId = err.ee_data;
+        hasId = true;
+      }
+    }
+  }
+  return hasStamp && hasId;
+#else
+  return false;
+#endif
+}
@@ -23,15 +23,26 @@
 #ifndef __PRACTICALSOCKET_INCLUDED__
 #define __PRACTICALSOCKET_INCLUDED__
 
-#include <exception> // For exception class
-#include <string>    // For string
+#include <cstdint>   // For uint32_t
+#include <ctime>     // For timespec
+#include <exception>  // For exception class
+#include <functional> // For function
+#include <string>     // For string
 
 using namespace std;
 
+#ifndef PRACTICALSOCKET_EXPORT
+// Define to the export declaration when building into a shared library
+// with hidden visibility.
+#define PRACTICALSOCKET_EXPORT
+#endif
+
+struct sockaddr_in;
+
 /**
  *   Signals a problem with the execution of a socket call.
  */
-class SocketException : public exception {
+class PRACTICALSOCKET_EXPORT SocketException : public exception {
 public:
   /**
    *   Construct a SocketException with a explanatory message.
@@ -59,7 +70,7 @@ private:
 /**
  *   Base class representing basic communication endpoint
  */
-class Socket {
+class PRACTICALSOCKET_EXPORT Socket {
 public:
   /**
    *   Close and deallocate this socket
@@ -123,6 +134,13 @@ public:
   static unsigned short resolveService(const string &service,
                                        const string &protocol = "tcp");
 
+  /**
+   *   Get the underlying socket descriptor, e.g. to register it with an
+   *   io_uring instance or an external poll set
+   *   @return socket descriptor
+   */
+  int getDescriptor() const { return sockDesc; }
+
 private:
   // Prevent the user from trying to use value semantics on this object
   Socket(const Socket &sock);
@@ -137,7 +155,7 @@ protected:
 /**
  *   Socket which is able to connect, send, and receive
  */
-class CommunicatingSocket : public Socket {
+class PRACTICALSOCKET_EXPORT CommunicatingSocket : public Socket {
 public:
   /**
    *   Establish a socket connection with the given foreign
@@ -190,7 +208,7 @@ protected:
 /**
  *   TCP socket for communication with other TCP sockets
  */
-class TCPSocket : public CommunicatingSocket {
+class PRACTICALSOCKET_EXPORT TCPSocket : public CommunicatingSocket {
 public:
   /**
    *   Construct a TCP socket with no connection
@@ -217,7 +235,7 @@ private:
 /**
  *   TCP socket class for servers
  */
-class TCPServerSocket : public Socket {
+class PRACTICALSOCKET_EXPORT TCPServerSocket : public Socket {
 public:
   /**
    *   Construct a TCP socket for use with a server, accepting connections
@@ -254,10 +272,60 @@ private:
   void setListen(int queueLen) noexcept(false);
 };
 
+/**
+ *   Preallocated buffer pool for UDPSocket::recvBatch().  Buffers, source
+ *   addresses and control buffers are allocated once and reused, so the
+ *   received datagrams can be parsed in place without copies.
+ */
+class PRACTICALSOCKET_EXPORT UDPRecvBatch {
+public:
+  /**
+   *   Allocate capacity buffers of bufferSize bytes each
+   *   @param capacity maximum number of datagrams per recvBatch() call
+   *   @param bufferSize size of each datagram buffer
+   */
+  UDPRecvBatch(unsigned int capacity = 32, unsigned int bufferSize = 256);
+  ~UDPRecvBatch();
+
+  /**
+   *   Number of datagrams received by the last recvBatch() call
+   */
+  unsigned int size() const { return count; }
+
+  unsigned int capacity() const;
+
+  /**
+   *   Payload of the i-th datagram, valid until the next recvBatch() call
+   */
+  const char *data(unsigned int i) const;
+  int length(unsigned int i) const;
+
+  /**
+   *   Raw source address of the i-th datagram
+   */
+  const sockaddr_in &source(unsigned int i) const;
+
+  /**
+   *   Kernel receive timestamp of the i-th datagram, zero when timestamping
+   *   is disabled
+   */
+  const timespec &rxStamp(unsigned int i) const;
+
+private:
+  friend class UDPSocket;
+  struct Storage;
+  Storage *storage;
+  unsigned int count = 0;
+
+  // Prevent the user from trying to use value semantics on this object
+  UDPRecvBatch(const UDPRecvBatch &);
+  void operator=(const UDPRecvBatch &);
+};
+
 /**
  *   UDP socket class
  */
-class UDPSocket : public CommunicatingSocket {
+class PRACTICALSOCKET_EXPORT UDPSocket : public CommunicatingSocket {
 public:
   /**
    *   Construct a UDP socket
@@ -362,8 +430,51 @@ public:
    */
   void leaveGroup(const string &multicastGroup) noexcept(false);
 
+  /**
+   * @brief 非阻塞取出接收队列中的全部数据报 (recvmmsg + MSG_DONTWAIT，批量)
+   * @param handler 逐个处理取出的数据报 (数据, 长度, 源地址)，为空时直接丢弃
+   * @return 取出的数据报数
+   * @exception SocketException thrown if unable to receive datagram
+   */
+  int drain(const std::function<void(const char *, int, const sockaddr_in &)>
+                &handler = nullptr) noexcept(false);
+
+  /**
+   * @brief 批量接收 (recvmmsg)，一次系统调用最多取出 batch.capacity() 个数据报
+   * @param batch 预分配的接收缓冲池，上次的内容被覆盖
+   * @param timeout_ms 等待超时时间，0 为不等待
+   * @return 接收到的数据报数，超时或无数据返回0
+   * @exception SocketException thrown if unable to receive datagrams
+   */
+  int recvBatch(UDPRecvBatch &batch, int timeout_ms) noexcept(false);
+
+  /**
+   * @brief 开启/关闭内核收发时间戳 (SO_TIMESTAMPNS + SO_TIMESTAMPING)
+   * 时间戳为 CLOCK_REALTIME 软件时间戳，仅 Linux 支持。
+   * 发送序号在由关到开时从 0 重新计数，已开启时再次开启不清零
+   * @param enable
+   * @exception SocketException thrown if setsockopt fails
+   */
+  void setTimestamping(bool enable) noexcept(false);
+
+  /**
+   * @brief 从错误队列非阻塞读取一个发送时间戳
+   * @param txId 返回发送序号，对应 txCount() 在发送前的取值
+   * @param txStamp 返回内核发送时间戳
+   * @return true 读到时间戳
+   */
+  bool readTxTimestamp(uint32_t &txId, timespec &txStamp) noexcept(false);
+
+  /**
+   * @brief 开启时间戳后已发送的数据报数，用于关联发送时间戳
+   */
+  uint32_t txCount() const { return txCounter; }
+
 private:
   void setBroadcast();
+
+  bool timestamping = false;
+  uint32_t txCounter = 0;
 };
 
 #endif
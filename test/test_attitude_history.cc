@@ -0,0 +1,128 @@
+// 姿态历史：容量取预算内的 2 的幂；相邻样本间线性插值；环形覆盖后只
+// 查得到保留范围内的样本，跨越缓冲末尾的插值正确；并发读端在写端持续
+// 覆盖时只会查询失败，不会读到错位数据
+#include "gimbal_history.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+
+namespace {
+
+using Clock = AttitudeHistory::Clock;
+using Ms = std::chrono::milliseconds;
+using Us = std::chrono::microseconds;
+
+int failures = 0;
+
+void check(bool ok, const char *what) {
+  std::printf("%s %s\n", ok ? "ok  " : "FAIL", what);
+  if (!ok)
+    failures++;
+}
+
+bool near(float value, double expected) {
+  return std::fabs(value - expected) <= 0.006;
+}
+
+} // namespace
+
+int main() {
+  const Clock::time_point t0 = Clock::now();
+  AttitudeHistory::Sample sample;
+
+  check(AttitudeHistory(32 * 100).capacity() == 64 &&
+            AttitudeHistory(0).capacity() == 2,
+        "capacity is the largest power of two within the budget");
+
+  AttitudeHistory history(32 * 64);
+  check(!history.at(t0, sample) && !history.newest(sample) &&
+            !history.oldest(sample),
+        "empty history has no samples");
+
+  check(history.push(t0, {0.0f, -1.0f, 1.234f}) &&
+            history.push(t0 + Ms(10), {1.0f, -2.0f, 0.0f}) &&
+            history.push(t0 + Ms(20), {3.0f, -4.0f, 0.0f}),
+        "increasing stamps are accepted");
+  check(!history.push(t0 + Ms(20), {9.0f, 9.0f, 9.0f}) &&
+            !history.push(t0 + Ms(5), {9.0f, 9.0f, 9.0f}) &&
+            history.size() == 3,
+        "stale or repeated stamps are dropped");
+
+  check(history.at(t0 + Ms(5), sample) && sample.stamp == t0 + Ms(5) &&
+            near(sample.angle[0], 0.5) && near(sample.angle[1], -1.5),
+        "interpolates within the first interval");
+  check(history.at(t0 + Ms(15), sample) && near(sample.angle[0], 2.0) &&
+            near(sample.angle[1], -3.0),
+        "interpolates within the last interval");
+  check(history.at(t0, sample) && near(sample.angle[2], 1.23),
+        "exact stamp returns the stored sample at 0.01 deg");
+  check(history.at(t0 + Ms(20), sample) && near(sample.angle[0], 3.0),
+        "newest stamp is inside the range");
+  check(!history.at(t0 - Us(1), sample) && !history.at(t0 + Us(20001), sample),
+        "stamps outside the range are not found");
+
+  // 8 个槽位写入 20 个样本，保留最后 8 个 (序号 12-19)
+  AttitudeHistory ring(32 * 8);
+  for (int i = 0; i < 20; i++)
+    ring.push(t0 + Ms(i * 10), {static_cast<float>(i), 0.0f, 0.0f});
+  check(ring.size() == 8, "size stops at the capacity");
+  check(ring.oldest(sample) && sample.stamp == t0 + Ms(120) &&
+            ring.newest(sample) && sample.stamp == t0 + Ms(190),
+        "oldest and newest follow the overwrite");
+  check(!ring.at(t0 + Ms(115), sample),
+        "overwritten interval is not found");
+  check(ring.at(t0 + Ms(125), sample) && near(sample.angle[0], 12.5),
+        "oldest retained interval interpolates");
+  // 序号 15 在最后一个槽位，16 在第一个槽位
+  check(ring.at(t0 + Ms(155), sample) && near(sample.angle[0], 15.5),
+        "interval across the end of the buffer interpolates");
+  bool all = true;
+  for (int ms = 120; ms <= 190; ms++) {
+    all = all && ring.at(t0 + Ms(ms), sample) &&
+          near(sample.angle[0], ms / 10.0);
+  }
+  check(all, "every retained stamp interpolates");
+
+  AttitudeHistory clamp(32 * 2);
+  clamp.push(t0, {400.0f, -400.0f, 0.0f});
+  check(clamp.newest(sample) && near(sample.angle[0], 327.67) &&
+            near(sample.angle[1], -327.68),
+        "angles beyond the 16-bit range are clamped");
+
+  // 写端以 1 ms 间隔、航向 = 序号 x 0.01 度持续覆盖 64 个槽位，读端查询
+  // 最近的时刻：要么查不到，要么得到与时刻一致的插值
+  AttitudeHistory shared(32 * 64);
+  constexpr int kSamples = 30000;
+  std::atomic<bool> started{false}, done{false};
+  std::atomic<long> found{0}, wrong{0};
+  std::thread reader([&] {
+    AttitudeHistory::Sample newest, probe;
+    started.store(true, std::memory_order_release);
+    for (int k = 0; !done.load(std::memory_order_acquire); k++) {
+      if (!shared.newest(newest))
+        continue;
+      Clock::time_point t = newest.stamp - Us(250 * (k % 300));
+      if (!shared.at(t, probe))
+        continue;
+      double index = std::chrono::duration<double, std::milli>(t - t0).count();
+      found++;
+      if (!near(probe.angle[0], index * 0.01))
+        wrong++;
+    }
+  });
+  while (!started.load(std::memory_order_acquire))
+    std::this_thread::yield();
+  for (int i = 0; i < kSamples; i++) {
+    shared.push(t0 + Ms(i), {static_cast<float>(i * 0.01), 0.0f, 0.0f});
+    if (i % 8 == 0)
+      std::this_thread::yield();
+  }
+  done.store(true, std::memory_order_release);
+  reader.join();
+  std::printf("     concurrent lookups: %ld found, %ld wrong\n", found.load(),
+              wrong.load());
+  check(found > 0 && wrong == 0, "concurrent lookups never return torn data");
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,58 @@
+// waitCommand 的超时与结果保留：限时等待返回 PENDING；等待开始前结果已被
+// 之后的完成记录挤出时返回 EXPIRED，而不是与失败混同
+#include "c12_sim.h"
+#include "gimbal_ctrl.h"
+#include "gimbal_protocol.h"
+
+#include <chrono>
+#include <cstdio>
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const char *what) {
+  std::printf("%s %s\n", ok ? "ok  " : "FAIL", what);
+  if (!ok)
+    failures++;
+}
+
+} // namespace
+
+int main() {
+  loguru::g_stderr_verbosity = loguru::Verbosity_WARNING;
+  const uint16_t port = 15610;
+  pid_t sim = c12sim::forkLoopback(port, 300);
+  {
+    GimbalCtrl gimbal("127.0.0.1", port);
+    gimbal.setCommandRetry(1000, 0);
+    GimbalCtrl::CommandRecord record;
+
+    // 拍照应答延迟 300 ms，限时 50 ms 的等待先返回
+    GimbalCtrl::CommandHandle capture = gimbal.capturePhotoAsync();
+    auto start = std::chrono::steady_clock::now();
+    bool confirmed = gimbal.waitCommand(capture, record, 50);
+    double waited_ms = std::chrono::duration<double, std::milli>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+    check(!confirmed && record.state == GimbalCtrl::CommandState::PENDING,
+          "timed wait returns PENDING before the reply");
+    check(waited_ms < 250.0, "timed wait returns near its timeout");
+    check(gimbal.waitCommand(capture, record),
+          "untimed wait returns the confirmation");
+
+    // 之后完成 300 条指令，拍照的记录被挤出最近完成历史
+    const std::string read = tp::encodeRead<tp::Id::VER>();
+    for (int i = 0; i < 300; i++)
+      gimbal.waitCommand(gimbal.sendFrameAsync(read), record);
+    check(!gimbal.waitCommand(capture, record) &&
+              record.state == GimbalCtrl::CommandState::EXPIRED,
+          "wait on an evicted record returns EXPIRED");
+    check(!gimbal.pollCommand(capture, record) &&
+              record.state == GimbalCtrl::CommandState::EXPIRED,
+          "poll on an evicted record returns EXPIRED");
+    check(!gimbal.waitCommand(0, record), "wait on handle 0 fails");
+  }
+  c12sim::stopLoopback(sim);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,85 @@
+// 姿态估计器：匀速跟踪并补偿遥测时延；速率指令在生效时刻之后、姿态
+// 反映之前即进入预测且只影响本轴；角度指令放大不确定度；预测不改变状态
+#include "gimbal_estimator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+using Clock = AttitudeEstimator::Clock;
+using Ms = std::chrono::milliseconds;
+
+int failures = 0;
+
+void check(bool ok, const char *what) {
+  std::printf("%s %s\n", ok ? "ok  " : "FAIL", what);
+  if (!ok)
+    failures++;
+}
+
+bool near(float value, double expected, double tolerance) {
+  return std::fabs(value - expected) <= tolerance;
+}
+
+} // namespace
+
+int main() {
+  const Clock::time_point t0 = Clock::now();
+  const AttitudeEstimator::Params params;
+
+  AttitudeEstimator tracker;
+  check(!tracker.predict(t0).valid, "no estimate before the first attitude");
+
+  // 航向 10 deg/s 匀速，100 Hz 采样，接收比采样晚 telemetry_latency_ms
+  for (int i = 0; i <= 200; i++)
+    tracker.addMeasurement(
+        {static_cast<float>(0.1 * i), 0.0f, 0.0f},
+        t0 + Ms(i * 10 + params.telemetry_latency_ms));
+  AttitudeEstimator::Estimate ahead = tracker.predict(t0 + Ms(2100));
+  check(ahead.valid && near(ahead.angle[0], 21.0, 0.05),
+        "constant rate is extrapolated from the sample time");
+  check(near(ahead.rate[0], 10.0, 0.1), "rate converges to the true rate");
+  AttitudeEstimator::Estimate again = tracker.predict(t0 + Ms(2100));
+  check(again.angle[0] == ahead.angle[0] && again.rate[0] == ahead.rate[0],
+        "predict does not change the state");
+  tracker.reset();
+  check(!tracker.predict(t0 + Ms(2100)).valid, "reset drops the estimate");
+
+  AttitudeEstimator still;
+  for (int i = 0; i <= 100; i++)
+    still.addMeasurement({0.0f, 0.0f, 0.0f}, t0 + Ms(i * 10));
+  const Clock::time_point sent = t0 + Ms(1000);
+  AttitudeEstimator released = still;
+  still.addRateCommand(AttitudeEstimator::YAW, 20.0f, sent);
+
+  AttitudeEstimator::Estimate before =
+      still.predict(sent + Ms(params.command_latency_ms / 2));
+  check(near(before.angle[0], 0.0, 1e-3) && near(before.rate[0], 0.0, 1e-3),
+        "rate command has no effect before it takes effect");
+  AttitudeEstimator::Estimate after =
+      still.predict(sent + Ms(params.command_latency_ms + 100));
+  check(after.rate[0] > 15.0f && after.angle[0] > 1.5f,
+        "rate command moves the prediction before any attitude shows it");
+  check(near(after.rate[1], 0.0, 1e-3) && near(after.angle[1], 0.0, 1e-3),
+        "rate command leaves other axes alone");
+
+  // 指令生效后姿态跟上，估计收敛到指令速率
+  for (int i = 1; i <= 30; i++) {
+    double t = std::max(0.0, (i * 10 - params.command_latency_ms) / 1000.0);
+    still.addMeasurement({static_cast<float>(20.0 * t), 0.0f, 0.0f},
+                         sent + Ms(i * 10 + params.telemetry_latency_ms));
+  }
+  AttitudeEstimator::Estimate tracked = still.predict(sent + Ms(400));
+  check(near(tracked.angle[0], 7.6, 0.1) && near(tracked.rate[0], 20.0, 0.5),
+        "measurements after the command agree with the prediction");
+
+  AttitudeEstimator::Estimate held = released.predict(sent + Ms(200));
+  released.addAngleCommand(AttitudeEstimator::PITCH, sent);
+  AttitudeEstimator::Estimate loose = released.predict(sent + Ms(200));
+  check(loose.angle_std[1] > held.angle_std[1] &&
+            loose.angle_std[0] == held.angle_std[0],
+        "angle command widens only its axis' uncertainty");
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,71 @@
+// 发现目标展开：网段去掉网络与广播地址 (/31、/32 除外)，范围含两端，
+// 前缀、格式或地址数越界时拒绝
+#include "gimbal_ctrl.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const char *what) {
+  std::printf("%s %s\n", ok ? "ok  " : "FAIL", what);
+  if (!ok)
+    failures++;
+}
+
+// 展开成功且首尾地址与数量符合预期
+bool expands(const std::string &targets, size_t count,
+             const std::string &first, const std::string &last) {
+  std::vector<std::string> addresses;
+  return GimbalCtrl::expandTargets(targets, addresses) &&
+         addresses.size() == count && addresses.front() == first &&
+         addresses.back() == last;
+}
+
+bool rejects(const std::string &targets) {
+  std::vector<std::string> addresses;
+  return !GimbalCtrl::expandTargets(targets, addresses) && addresses.empty();
+}
+
+} // namespace
+
+int main() {
+  check(expands("192.168.144.0/24", 254, "192.168.144.1", "192.168.144.254"),
+        "/24 excludes network and broadcast");
+  check(expands("192.168.144.77/24", 254, "192.168.144.1", "192.168.144.254"),
+        "host bits of a CIDR base are masked");
+  check(expands("10.0.0.5/30", 2, "10.0.0.5", "10.0.0.6"), "/30 has 2 hosts");
+  check(expands("10.0.0.5/31", 2, "10.0.0.4", "10.0.0.5"),
+        "/31 keeps both addresses");
+  check(expands("10.0.0.5/32", 1, "10.0.0.5", "10.0.0.5"),
+        "/32 is the single address");
+  check(expands("10.1.0.0/20", 4094, "10.1.0.1", "10.1.15.254"),
+        "/20 is within the target limit");
+  check(rejects("10.1.0.0/16"), "/16 exceeds the target limit");
+  check(rejects("10.1.0.0/15"), "prefix below 16 is rejected");
+  check(rejects("10.1.0.0/33"), "prefix above 32 is rejected");
+  check(rejects("10.1.0.0/x"), "non-numeric prefix is rejected");
+
+  check(expands("192.168.1.250-192.168.2.3", 10, "192.168.1.250",
+                "192.168.2.3"),
+        "range crosses an octet boundary");
+  check(expands("10.0.0.0-10.0.15.255", 4096, "10.0.0.0", "10.0.15.255"),
+        "range of exactly 4096 addresses is accepted");
+  check(rejects("10.0.0.0-10.0.16.0"), "range of 4097 addresses is rejected");
+  check(rejects("192.168.1.12-192.168.1.10"), "reversed range is rejected");
+  check(rejects("192.168.1.10-"), "open range is rejected");
+
+  check(expands("255.255.255.255", 1, "255.255.255.255", "255.255.255.255"),
+        "single broadcast address");
+  check(rejects("gimbal.local"), "host name is rejected");
+  check(rejects("192.168.1"), "short address is rejected");
+
+  std::vector<std::string> addresses = {"127.0.0.1"};
+  check(GimbalCtrl::expandTargets("10.0.0.1-10.0.0.2", addresses) &&
+            addresses.size() == 3 && addresses[0] == "127.0.0.1",
+        "addresses are appended");
+  return failures == 0 ? 0 : 1;
+}
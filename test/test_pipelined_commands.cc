@@ -0,0 +1,84 @@
+// 相同指令流水线在途：回包须按接收顺序关联。发送方清出的帧与接收线程
+// 读到的帧若乱序分发，先到的回包会被判为过期丢弃，后一条指令超时重发
+// (拍照指令重发即多拍一张)
+#include "c12_sim.h"
+#include "gimbal_ctrl.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const char *what) {
+  std::printf("%s %s\n", ok ? "ok  " : "FAIL", what);
+  if (!ok)
+    failures++;
+}
+
+} // namespace
+
+int main() {
+  loguru::g_stderr_verbosity = loguru::Verbosity_ERROR;
+  const uint16_t port = 15611;
+  const int kThreads = 2;
+  const int kPerThread = 3000;
+  pid_t sim = c12sim::forkLoopback(port);
+
+  std::atomic<int> confirmed{0};
+  std::atomic<int> failed{0};
+  std::atomic<int> resent{0};
+  GimbalCtrl::LinkStats stats;
+  {
+    GimbalCtrl gimbal("127.0.0.1", port);
+    gimbal.setCommandRetry(500, 2);
+    gimbal.setCommandCallback([&](const GimbalCtrl::CommandRecord &record) {
+      if (record.identifier != "CAP")
+        return;
+      if (record.state == GimbalCtrl::CommandState::CONFIRMED)
+        confirmed++;
+      else
+        failed++;
+      if (record.attempts > 1)
+        resent++;
+    });
+    // 姿态推送与回包交错，接收线程与发送方清出的帧同时存在
+    gimbal.enableAttitudeOutput(100);
+
+    // 多个线程同时提交同一拍照指令，不等待前一条确认
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+      threads.emplace_back([&] {
+        for (int i = 0; i < kPerThread; i++) {
+          gimbal.capturePhotoAsync();
+          // 每个线程约 2000 条/秒，模拟器来得及应答，不因丢包重发
+          if (i % 2 == 1)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+      });
+    }
+    for (std::thread &thread : threads)
+      thread.join();
+
+    const int total = kThreads * kPerThread;
+    auto until = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (confirmed + failed < total &&
+           std::chrono::steady_clock::now() < until)
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    stats = gimbal.getLinkStats();
+
+    std::printf("confirmed %d failed %d resent %d stale %lu drained %lu\n",
+                confirmed.load(), failed.load(), resent.load(),
+                static_cast<unsigned long>(stats.stale_discarded),
+                static_cast<unsigned long>(stats.drained));
+    check(confirmed == total, "every pipelined command is confirmed");
+    check(resent == 0, "no command is resent");
+    check(stats.stale_discarded == 0, "no reply is discarded as stale");
+  }
+  c12sim::stopLoopback(sim);
+  return failures == 0 ? 0 : 1;
+}
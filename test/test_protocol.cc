@@ -0,0 +1,135 @@
+// 协议描述表：每个标识位经完美哈希查回自身，未知标识位不误中；各类载荷
+// 编码后可按帧格式解回原值，校验正确；数据超出一位长度位时返回空帧。
+// GimbalCtrl 的公开组帧接口与 tp 编码结果一致
+#include "gimbal_ctrl.h"
+#include "gimbal_protocol.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const char *what) {
+  std::printf("%s %s\n", ok ? "ok  " : "FAIL", what);
+  if (!ok)
+    failures++;
+}
+
+// 长度位与实际数据长度一致，末两位为其前所有字符的校验和
+bool wellFormed(const std::string &frame) {
+  if (frame.size() < 12 || frame[0] != '#')
+    return false;
+  size_t data_len = std::strtoul(frame.substr(5, 1).c_str(), nullptr, 16);
+  if (frame.size() != 12 + data_len)
+    return false;
+  uint8_t crc = 0;
+  for (size_t i = 0; i + 2 < frame.size(); i++)
+    crc += static_cast<uint8_t>(frame[i]);
+  return std::strtoul(frame.substr(frame.size() - 2).c_str(), nullptr, 16) ==
+         crc;
+}
+
+uint32_t hexField(const std::string &frame, size_t pos, size_t len) {
+  return static_cast<uint32_t>(
+      std::strtoul(frame.substr(pos, len).c_str(), nullptr, 16));
+}
+
+void testLookup() {
+  bool all = true;
+  for (size_t i = 0; i < static_cast<size_t>(tp::Id::COUNT); i++) {
+    tp::Id id = static_cast<tp::Id>(i);
+    if (tp::lookup(tp::describe(id).name) != id)
+      all = false;
+  }
+  check(all, "every identifier hashes back to itself");
+
+  check(tp::lookup("XYZ") == tp::Id::COUNT, "unknown identifier misses");
+  check(tp::lookup("gac") == tp::Id::COUNT, "identifier is case sensitive");
+  check(tp::lookup("GA") == tp::Id::COUNT, "short identifier misses");
+  check(tp::frameId("#TPUG2wGS") == tp::Id::COUNT, "short frame has no id");
+
+  // 逐一替换每个标识位的一个字符，均不得命中另一个条目
+  bool no_alias = true;
+  for (const tp::Descriptor &d : tp::kDescriptors) {
+    for (int pos = 0; pos < 3; pos++) {
+      std::string name(d.name, 3);
+      name[pos] = static_cast<char>(name[pos] ^ 0x01);
+      tp::Id id = tp::lookup(name);
+      if (id != tp::Id::COUNT && name != tp::describe(id).name)
+        no_alias = false;
+    }
+  }
+  check(no_alias, "near-miss identifiers do not alias");
+}
+
+void testEncode() {
+  bool reads = true;
+  for (size_t i = 0; i < static_cast<size_t>(tp::Id::COUNT); i++) {
+    tp::Id id = static_cast<tp::Id>(i);
+    if (!tp::describe(id).readable)
+      continue;
+    std::string frame = tp::encodeRead(id);
+    if (!wellFormed(frame) || tp::frameId(frame) != id || frame[6] != 'r')
+      reads = false;
+  }
+  check(reads, "read frames round-trip for every readable identifier");
+
+  std::string speed = tp::encodeWrite<tp::Id::GSY>(0xAB);
+  check(wellFormed(speed) && tp::frameId(speed) == tp::Id::GSY &&
+            speed.compare(0, 10, "#TPUG2wGSY") == 0 &&
+            hexField(speed, 10, 2) == 0xAB,
+        "byte payload round-trips");
+
+  std::string angle = tp::encodeWrite<tp::Id::GAP>(-1234, 50);
+  check(wellFormed(angle) && tp::frameId(angle) == tp::Id::GAP &&
+            static_cast<int16_t>(hexField(angle, 10, 4)) == -1234 &&
+            hexField(angle, 14, 2) == 50,
+        "angle payload round-trips");
+
+  std::string ip = tp::encodeWrite<tp::Id::IPV>("192.168.144.108");
+  check(wellFormed(ip) && tp::frameId(ip) == tp::Id::IPV &&
+            ip.compare(0, 3, "#tp") == 0 &&
+            ip.substr(10, 15) == "192.168.144.108",
+        "15-character text payload round-trips");
+  check(tp::encodeWrite<tp::Id::IPV>("192.168.144.1080").empty(),
+        "16-character text payload is rejected");
+}
+
+void testBuilders() {
+  check(GimbalCtrl::buildCommand("U", "D", 'w', "IPV", "192.168.1.10") ==
+            tp::encodeWrite<tp::Id::IPV>("192.168.1.10"),
+        "buildCommand matches the text encoder");
+  check(GimbalCtrl::buildCommand("U", "D", 'w', "IPV", "192.168.144.108") ==
+            tp::encodeWrite<tp::Id::IPV>("192.168.144.108"),
+        "buildCommand accepts 15 characters");
+  check(GimbalCtrl::buildCommand("U", "D", 'w', "IPV", "192.168.144.1080")
+            .empty(),
+        "buildCommand rejects 16 characters");
+
+  std::vector<uint8_t> angle = {0xFB, 0x2E, 0x32};
+  check(GimbalCtrl::buildDynamicCommand("U", "G", 'w', "GAP", angle) ==
+            tp::encodeWrite<tp::Id::GAP>(-1234, 50),
+        "buildDynamicCommand matches the angle encoder");
+  check(GimbalCtrl::buildDynamicCommand("U", "G", 'w', "GAP",
+                                        std::vector<uint8_t>(8, 0x00))
+            .empty(),
+        "buildDynamicCommand rejects 8 bytes");
+
+  check(GimbalCtrl::buildStaticCommand("U", "G", 'w', "GSY", 0xAB) ==
+            tp::encodeWrite<tp::Id::GSY>(0xAB),
+        "buildStaticCommand matches the byte encoder");
+}
+
+} // namespace
+
+int main() {
+  testLookup();
+  testEncode();
+  testBuilders();
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,52 @@
+// RateModulator 长时间运行的误差界测试：每拍按下发的指令码独立积分真实位置，
+// 与设定速率积分之差任何时刻都不得超过 0.5 x 0.5 deg/s x 周期
+#include "gimbal_motion.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+constexpr double kQuantum = 0.5;
+constexpr int kMaxCode = 127;
+constexpr long kTicks = 2000000;
+
+// 以 period 等间隔推进 kTicks 拍，返回 |e| / 上限 的最大值
+double run(double rate, double period) {
+  RateModulator modulator(kQuantum, period, kMaxCode);
+  // 误差由整数码和独立计算：e(n) = n x rate x P - sum(code) x quantum x P
+  long long code_sum = 0;
+  long double worst = 0.0L;
+  int code = modulator.step(rate, 0.0);
+  for (long n = 1; n <= kTicks; n++) {
+    code_sum += code;
+    long double e = (static_cast<long double>(n) * rate -
+                     static_cast<long double>(code_sum) * kQuantum) *
+                    period;
+    worst = std::max(worst, std::fabs(e));
+    code = modulator.step(rate, period);
+  }
+  return static_cast<double>(worst / (0.5 * kQuantum * period));
+}
+
+} // namespace
+
+int main() {
+  const double rates[] = {0.3,  1.26, 7.7,  15.3, -3.14159,
+                          0.25, 63.4, 0.01, -63.5, 0.0};
+  const double periods[] = {0.02, 0.01, 0.005};
+  int failures = 0;
+  for (double period : periods) {
+    for (double rate : rates) {
+      double ratio = run(rate, period);
+      // 真实误差与调制器内部误差只差浮点舍入
+      bool ok = ratio <= 1.0 + 1e-6;
+      std::printf("%s rate %9.5f deg/s period %5.3f s: max |e| / bound %.6f\n",
+                  ok ? "ok  " : "FAIL", rate, period, ratio);
+      if (!ok)
+        failures++;
+    }
+  }
+  return failures == 0 ? 0 : 1;
+}
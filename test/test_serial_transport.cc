@@ -0,0 +1,165 @@
+// 串口分帧与 pty 上的 SerialTransport：半帧拼接、噪声字节、长度位越界后的
+// 重同步、单批帧数上限，以及设备挂断后只报告一次错误而不空转
+#include "c12_sim.h"
+#include "gimbal_protocol.h"
+#include "gimbal_serial_transport.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const char *what) {
+  std::printf("%s %s\n", ok ? "ok  " : "FAIL", what);
+  if (!ok)
+    failures++;
+}
+
+void append(FrameAssembler &assembler, const std::string &bytes) {
+  assembler.append(bytes.data(), bytes.size());
+}
+
+void writeAll(int fd, const std::string &bytes) {
+  size_t written = 0;
+  while (written < bytes.size()) {
+    ssize_t n = write(fd, bytes.data() + written, bytes.size() - written);
+    if (n > 0)
+      written += static_cast<size_t>(n);
+    else
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+// 在 timeout_ms 内收取至少 want 帧
+std::vector<std::string> receiveFrames(SerialTransport &serial, size_t want,
+                                       int timeout_ms) {
+  std::vector<std::string> frames;
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::milliseconds(timeout_ms);
+  while (frames.size() < want && std::chrono::steady_clock::now() < deadline) {
+    if (!serial.poll(10))
+      continue;
+    int count = serial.receive();
+    for (int i = 0; i < count; i++)
+      frames.emplace_back(serial.datagram(i).data);
+  }
+  return frames;
+}
+
+void testAssembler() {
+  const std::string read = tp::encodeRead<tp::Id::VER>();
+  const std::string rate = tp::encodeWrite<tp::Id::GSY>(0x10);
+  std::string frame;
+
+  FrameAssembler split;
+  append(split, rate.substr(0, 5));
+  check(!split.next(frame), "half frame is held back");
+  append(split, rate.substr(5));
+  check(split.next(frame) && frame == rate, "split frame is reassembled");
+  check(split.droppedBytes() == 0, "split frame drops nothing");
+
+  FrameAssembler junk;
+  append(junk, "xx#\r\n" + read + "abc" + rate + "zz");
+  check(junk.next(frame) && frame == read, "frame after junk is found");
+  check(junk.next(frame) && frame == rate, "frame between junk is found");
+  check(!junk.next(frame), "trailing junk yields no frame");
+  check(junk.droppedBytes() == 10, "junk bytes are counted as dropped");
+
+  // 截断的写指令长度位为 2，按长度切出的字节越入下一帧，校验失败后
+  // 从下一个 '#' 重新同步
+  FrameAssembler resync;
+  std::string truncated = rate.substr(0, rate.size() - 4);
+  append(resync, truncated + read);
+  check(resync.next(frame) && frame == read,
+        "resync after a length that overruns the next frame");
+  check(resync.droppedBytes() == truncated.size(),
+        "overrun frame is dropped whole");
+
+  FrameAssembler corrupt;
+  std::string bad = read;
+  bad[bad.size() - 1] = bad[bad.size() - 1] == '0' ? '1' : '0';
+  append(corrupt, bad + rate);
+  check(corrupt.next(frame) && frame == rate, "resync after a bad checksum");
+  check(corrupt.droppedBytes() == bad.size(), "bad frame is dropped whole");
+}
+
+void testPty() {
+  std::string slave;
+  int master = C12Simulator::openPty(slave);
+  check(master >= 0, "open pty");
+  if (master < 0)
+    return;
+
+  SerialTransport serial(slave);
+  const std::string read = tp::encodeRead<tp::Id::VER>();
+
+  writeAll(master, read.substr(0, 7));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  writeAll(master, read.substr(7));
+  std::vector<std::string> frames = receiveFrames(serial, 1, 500);
+  check(frames.size() == 1 && frames[0] == read,
+        "frame split across pty writes is received");
+
+  // 超过单批上限的帧留在分帧缓冲中，poll 立即返回可读
+  std::string burst;
+  for (int i = 0; i < 40; i++)
+    burst += read;
+  writeAll(master, burst);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  check(serial.poll(100) && serial.receive() == 32,
+        "one batch is capped at 32 frames");
+  check(serial.poll(0) && serial.receive() == 8,
+        "frames beyond the cap are returned next");
+
+  serial.sendTo(read, "", 0);
+  std::string echo(read.size(), '\0');
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  check(::read(master, &echo[0], echo.size()) ==
+                static_cast<ssize_t>(read.size()) &&
+            echo == read,
+        "sent frame arrives at the pty master");
+
+  // 主端关闭即挂断：报告一次错误，之后 poll 按超时等待而不空转
+  close(master);
+  int errors = 0;
+  for (int i = 0; i < 5; i++) {
+    try {
+      if (serial.poll(10))
+        serial.receive();
+    } catch (SocketException &) {
+      errors++;
+    }
+  }
+  check(errors == 1, "hang-up is reported once");
+
+  auto start = std::chrono::steady_clock::now();
+  bool readable = false;
+  for (int i = 0; i < 5; i++)
+    readable = serial.poll(20) || readable;
+  double waited_ms = std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+  check(!readable && waited_ms >= 90.0, "poll after hang-up waits out");
+
+  bool send_failed = false;
+  try {
+    serial.sendTo(read, "", 0);
+  } catch (SocketException &) {
+    send_failed = true;
+  }
+  check(send_failed, "send after hang-up fails");
+}
+
+} // namespace
+
+int main() {
+  testAssembler();
+  testPty();
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+// 启动探测的云台信息缓存：未命中时探测并写入本机一行、保留其他云台的行；
+// 命中时不经链路直接返回；缺少 VER 的行视为未命中；后台核对到固件版本
+// 变化时重新探测并改写该行
+#include "c12_sim.h"
+#include "gimbal_ctrl.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const char *what) {
+  std::printf("%s %s\n", ok ? "ok  " : "FAIL", what);
+  if (!ok)
+    failures++;
+}
+
+std::vector<std::string> readLines(const std::string &path) {
+  std::vector<std::string> lines;
+  std::ifstream file(path);
+  std::string line;
+  while (std::getline(file, line))
+    lines.push_back(line);
+  return lines;
+}
+
+void writeLines(const std::string &path,
+                const std::vector<std::string> &lines) {
+  std::ofstream file(path, std::ios::trunc);
+  for (const auto &line : lines)
+    file << line << '\n';
+}
+
+// 以 key 开头的行，没有时返回空串
+std::string findLine(const std::vector<std::string> &lines,
+                     const std::string &key) {
+  for (const auto &line : lines) {
+    if (line.compare(0, key.size() + 1, key + " ") == 0)
+      return line;
+  }
+  return std::string();
+}
+
+} // namespace
+
+int main() {
+  loguru::g_stderr_verbosity = loguru::Verbosity_WARNING;
+  const uint16_t port = 15612;
+  const std::string key = "127.0.0.1:" + std::to_string(port);
+  const std::string other = "10.0.0.9:5000 VER=V9.9.9 UID=01";
+  const std::string path =
+      "/tmp/test_unit_cache_" + std::to_string(getpid()) + ".txt";
+
+  pid_t sim = c12sim::forkLoopback(port);
+  GimbalCtrl::UnitInfo probed;
+  {
+    writeLines(path, {other, ""});
+    GimbalCtrl gimbal("127.0.0.1", port);
+    check(gimbal.probeUnit(path), "probe on a cache miss succeeds");
+    probed = gimbal.getUnitInfo();
+    check(probed.firmware == "V1.0.0" && probed.capabilities.size() == 5,
+          "probe reads the firmware and every capability");
+
+    std::vector<std::string> lines = readLines(path);
+    check(lines.size() == 2 && findLine(lines, "10.0.0.9:5000") == other,
+          "other units' lines are kept, blank lines dropped");
+    check(findLine(lines, key) ==
+              key + " EXT=00 TAS=00 UID=00 VER=V1.0.0 VID=00",
+          "probed unit is written as one line");
+  }
+  c12sim::stopLoopback(sim);
+
+  {
+    // 模拟器已停止，命中缓存不依赖链路
+    GimbalCtrl gimbal("127.0.0.1", port);
+    gimbal.setCommandRetry(100, 0);
+    auto start = std::chrono::steady_clock::now();
+    bool ok = gimbal.probeUnit(path);
+    double elapsed_ms = std::chrono::duration<double, std::milli>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+    GimbalCtrl::UnitInfo info = gimbal.getUnitInfo();
+    check(ok && elapsed_ms < 50.0, "cache hit returns without the link");
+    check(info.firmware == probed.firmware &&
+              info.capabilities == probed.capabilities,
+          "cache hit restores the probed info");
+  }
+
+  {
+    writeLines(path, {other, key + " UID=00"});
+    GimbalCtrl gimbal("127.0.0.1", port);
+    gimbal.setCommandRetry(100, 0);
+    check(!gimbal.probeUnit(path) && gimbal.getUnitInfo().firmware.empty(),
+          "line without VER is a miss");
+  }
+
+  sim = c12sim::forkLoopback(port);
+  {
+    writeLines(path, {key + " VER=V0.9.0 UID=00", other});
+    GimbalCtrl gimbal("127.0.0.1", port);
+    // 后台核对可能在返回前就已完成，此处只检查命中
+    check(gimbal.probeUnit(path), "cache hit with an old firmware succeeds");
+    for (int i = 0; i < 100 && gimbal.getUnitInfo().firmware != "V1.0.0"; i++)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    check(gimbal.getUnitInfo().firmware == "V1.0.0",
+          "firmware change triggers a new probe");
+    std::vector<std::string> lines;
+    for (int i = 0; i < 100; i++) {
+      lines = readLines(path);
+      if (findLine(lines, key).find("VER=V1.0.0") != std::string::npos)
+        break;
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    check(findLine(lines, key).find("VER=V1.0.0") != std::string::npos &&
+              findLine(lines, "10.0.0.9:5000") == other,
+          "new probe rewrites the unit's line");
+  }
+  c12sim::stopLoopback(sim);
+
+  std::remove(path.c_str());
+  return failures == 0 ? 0 : 1;
+}